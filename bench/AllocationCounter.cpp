@@ -0,0 +1,181 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// The complete set of replaceable global forms: scalar and array, aligned,
+// nothrow and sized. Each new is freed by the delete of its own family, so the
+// compiler sees no mismatched pair whichever form the standard library picks.
+
+namespace
+{
+	std::atomic<long long> g_allocationCount = 0;
+	std::atomic<long long> g_allocationBytes = 0;
+
+	void* Allocate(std::size_t size)
+	{
+		++g_allocationCount;
+		g_allocationBytes += size;
+
+		return std::malloc(size > 0 ? size : 1);
+	}
+
+	void* AllocateAligned(std::size_t size, std::align_val_t alignment)
+	{
+		++g_allocationCount;
+		g_allocationBytes += size;
+
+		const std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+		return _aligned_malloc(size > 0 ? size : 1, align);
+#else
+		// aligned_alloc wants a multiple of the alignment.
+		return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+	}
+
+	void Free(void* memory)
+	{
+		std::free(memory);
+	}
+
+	void FreeAligned(void* memory)
+	{
+#ifdef _WIN32
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
+	void* AllocateOrThrow(std::size_t size)
+	{
+		void* memory = Allocate(size);
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+
+	void* AllocateAlignedOrThrow(std::size_t size, std::align_val_t alignment)
+	{
+		void* memory = AllocateAligned(size, alignment);
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+}
+
+long long GetAllocationCount()
+{
+	return g_allocationCount;
+}
+
+long long GetAllocationBytes()
+{
+	return g_allocationBytes;
+}
+
+void* operator new(std::size_t size)
+{
+	return AllocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return AllocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	return AllocateAlignedOrThrow(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return AllocateAlignedOrThrow(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+	Free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	Free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	Free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	Free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	Free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	Free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	FreeAligned(memory);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// Allocations made through the global operator new since the start of the program.
+// AllocationCounter.cpp replaces every global operator new and delete of the bench
+// it is linked into, a bench reads the counters before and after what it measures.
+long long GetAllocationCount();
+long long GetAllocationBytes();
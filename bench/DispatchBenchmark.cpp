@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include "engine/Scene/Scene.h"
+#include "engine/Scene/TypedScene.h"
+#include "physicsEngine/dynamics/World.h"
+
+// Scene update time with the per-object virtual calls of IScene against the
+// per-type loops of TypedScene, on three object types mixed in spawn order.
+// The scenes are never shown, no window is opened.
+
+namespace
+{
+	struct ICBench : IInputComponent
+	{
+		void processInputImplementation(IGameObject& gameObject, sf::Event& inputEvent, IScene& scene) override
+		{
+		}
+	};
+
+	struct GCBench : IGraphicsComponent
+	{
+		void renderImplementation(IGameObject& gameObject, BatchRenderer& renderer) override
+		{
+		}
+	};
+
+	// Physics components with a little state each, as the game ones.
+	struct PCFall : IPhysicsComponent
+	{
+		void updateImplementation(const float& deltaTime, IGameObject& gameObject, IScene& scene) override
+		{
+			velocity += 9.81f * deltaTime;
+			position += velocity * deltaTime;
+		}
+
+		float position = 0.f;
+		float velocity = 0.f;
+	};
+
+	struct PCSpin : IPhysicsComponent
+	{
+		void updateImplementation(const float& deltaTime, IGameObject& gameObject, IScene& scene) override
+		{
+			angle += 3.f * deltaTime;
+		}
+
+		float angle = 0.f;
+	};
+
+	struct PCCountdown : IPhysicsComponent
+	{
+		void updateImplementation(const float& deltaTime, IGameObject& gameObject, IScene& scene) override
+		{
+			time -= deltaTime;
+			expired = time < 0.f;
+		}
+
+		float time = 30.f;
+		bool expired = false;
+	};
+
+	struct Faller : GameObject<ICBench, PCFall, GCBench> {};
+	struct Spinner : GameObject<ICBench, PCSpin, GCBench> {};
+	struct Countdown : GameObject<ICBench, PCCountdown, GCBench> {};
+
+	using BenchTypes = typelist<Faller, Spinner, Countdown>;
+
+	struct VirtualScene : IScene {};
+	struct StaticScene : TypedScene<BenchTypes> {};
+
+	template<typename Scene>
+	void BM_SceneUpdate(benchmark::State& state)
+	{
+		Scene scene;
+		for (int i = 0; i < state.range(0); ++i)
+		{
+			switch (i % 3)
+			{
+			case 0: scene.spawn(std::make_shared<Faller>()); break;
+			case 1: scene.spawn(std::make_shared<Spinner>()); break;
+			default: scene.spawn(std::make_shared<Countdown>()); break;
+			}
+		}
+
+		// Flush the spawns in, and sort the objects for the typed scene.
+		scene.update(0.f);
+
+		for (auto _ : state)
+		{
+			scene.update(1.f / 60.f);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_SceneUpdate, VirtualScene)->Arg(1 << 10)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(BM_SceneUpdate, StaticScene)->Arg(1 << 10)->Arg(1 << 14);
@@ -0,0 +1,152 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "physicsEngine/collision/Collision.h"
+#include "physicsEngine/collision/ManifoldBatch.h"
+#include "physicsEngine/collision/CircleShape.h"
+#include "physicsEngine/collision/EdgeShape.h"
+#include "physicsEngine/collision/PolygonShape.h"
+
+namespace
+{
+	// Random poses in a small area so about half of the pairs touch.
+	std::vector<Transform> MakeTransforms(int count, unsigned seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+		std::uniform_real_distribution<float> angle(-b2_pi, b2_pi);
+
+		std::vector<Transform> transforms(count);
+		for (Transform& xf : transforms)
+		{
+			xf.Set(Vec2(position(rng), position(rng)), angle(rng));
+		}
+		return transforms;
+	}
+
+	CircleShape MakeCircle(float radius)
+	{
+		CircleShape circle;
+		circle.m_radius = radius;
+		return circle;
+	}
+
+	EdgeShape MakeGroundEdge()
+	{
+		EdgeShape edge;
+		edge.SetOneSided(Vec2(-3.0f, 0.0f), Vec2(-1.0f, 0.0f), Vec2(1.0f, 0.0f), Vec2(3.0f, 0.0f));
+		return edge;
+	}
+
+	PolygonShape MakeBox(float half)
+	{
+		PolygonShape box;
+		box.SetAsBox(half, half);
+		return box;
+	}
+
+	// Runs a scalar manifold function over count random pairs.
+	template <typename ShapeA, typename ShapeB, typename Collide>
+	void RunPairs(benchmark::State& state, const ShapeA& shapeA, const ShapeB& shapeB, Collide collide)
+	{
+		const int count = int(state.range(0));
+		std::vector<Transform> xfA = MakeTransforms(count, 1);
+		std::vector<Transform> xfB = MakeTransforms(count, 2);
+		std::vector<Manifold> manifolds(count);
+
+		for (auto _ : state)
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				collide(&manifolds[i], &shapeA, xfA[i], &shapeB, xfB[i]);
+			}
+			benchmark::DoNotOptimize(manifolds.data());
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+}
+
+static void BM_CollideCircles(benchmark::State& state)
+{
+	RunPairs(state, MakeCircle(0.5f), MakeCircle(0.5f), b2CollideCircles);
+}
+BENCHMARK(BM_CollideCircles)->Arg(64)->Arg(1024);
+
+static void BM_CollideCirclesBatch(benchmark::State& state)
+{
+	const int count = int(state.range(0));
+	std::vector<Transform> xfA = MakeTransforms(count, 1);
+	std::vector<Transform> xfB = MakeTransforms(count, 2);
+	CircleShape circle = MakeCircle(0.5f);
+
+	CircleCircleBatch batch;
+	for (int i = 0; i < count; ++i)
+	{
+		batch.Add(&circle, xfA[i], &circle, xfB[i]);
+	}
+	std::vector<Manifold> manifolds(count);
+
+	for (auto _ : state)
+	{
+		b2CollideCirclesBatch(manifolds.data(), batch);
+		benchmark::DoNotOptimize(manifolds.data());
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CollideCirclesBatch)->Arg(64)->Arg(1024);
+
+static void BM_CollideEdgeAndCircle(benchmark::State& state)
+{
+	RunPairs(state, MakeGroundEdge(), MakeCircle(0.5f), b2CollideEdgeAndCircle);
+}
+BENCHMARK(BM_CollideEdgeAndCircle)->Arg(64)->Arg(1024);
+
+static void BM_CollideEdgeAndCircleBatch(benchmark::State& state)
+{
+	const int count = int(state.range(0));
+	std::vector<Transform> xfA = MakeTransforms(count, 1);
+	std::vector<Transform> xfB = MakeTransforms(count, 2);
+	EdgeShape edge = MakeGroundEdge();
+	CircleShape circle = MakeCircle(0.5f);
+
+	EdgeCircleBatch batch;
+	for (int i = 0; i < count; ++i)
+	{
+		batch.Add(&edge, xfA[i], &circle, xfB[i]);
+	}
+	std::vector<Manifold> manifolds(count);
+
+	for (auto _ : state)
+	{
+		b2CollideEdgeAndCircleBatch(manifolds.data(), batch);
+		benchmark::DoNotOptimize(manifolds.data());
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CollideEdgeAndCircleBatch)->Arg(64)->Arg(1024);
+
+static void BM_CollidePolygonAndCircle(benchmark::State& state)
+{
+	RunPairs(state, MakeBox(0.5f), MakeCircle(0.5f), b2CollidePolygonAndCircle);
+}
+BENCHMARK(BM_CollidePolygonAndCircle)->Arg(64)->Arg(1024);
+
+static void BM_CollidePolygons(benchmark::State& state)
+{
+	RunPairs(state, MakeBox(0.5f), MakeBox(0.5f), b2CollidePolygons);
+}
+BENCHMARK(BM_CollidePolygons)->Arg(64)->Arg(1024);
+
+static void BM_CollideEdgeAndPolygon(benchmark::State& state)
+{
+	RunPairs(state, MakeGroundEdge(), MakeBox(0.5f), b2CollideEdgeAndPolygon);
+}
+BENCHMARK(BM_CollideEdgeAndPolygon)->Arg(64)->Arg(1024);
@@ -0,0 +1,265 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "physicsEngine/collision/Collision.h"
+#include "physicsEngine/collision/ManifoldBatch.h"
+#include "physicsEngine/collision/CircleShape.h"
+#include "physicsEngine/collision/EdgeShape.h"
+
+// Checks the batch manifold kernels against the scalar functions on random
+// pairs. The batch sizes leave every remainder of the four wide lanes, and the
+// edges are one sided or two sided, with the circles spread over the vertex
+// regions, the face and the back of the edge.
+// Prints one line per kernel and returns 1 on the first mismatching batch size.
+// Usage: manifold-check [--rounds N]
+
+namespace
+{
+	const int batchSizes[] = { 1, 2, 3, 4, 5, 7, 8, 63, 64, 1023 };
+
+	// Feature of the scalar manifold, or the back of a one sided edge.
+	enum Region
+	{
+		e_noContact,
+		e_vertexA,
+		e_vertexB,
+		e_face,
+		e_back,
+		e_regionCount
+	};
+
+	const char* regionNames[] = { "none", "vertexA", "vertexB", "face", "back" };
+
+	struct Pair
+	{
+		EdgeShape edge;
+		CircleShape circle;
+		Transform xfA;
+		Transform xfB;
+	};
+
+	bool SameVec(const Vec2& a, const Vec2& b, float tolerance)
+	{
+		return std::abs(a.x - b.x) <= tolerance && std::abs(a.y - b.y) <= tolerance;
+	}
+
+	// The batch only rounds the normal differently, all the rest is copied from the shapes.
+	bool SameManifold(const Manifold& batch, const Manifold& scalar)
+	{
+		if (batch.pointCount != scalar.pointCount)
+		{
+			return false;
+		}
+
+		if (scalar.pointCount == 0)
+		{
+			return true;
+		}
+
+		return batch.type == scalar.type
+			&& SameVec(batch.localPoint, scalar.localPoint, 0.0f)
+			&& SameVec(batch.localNormal, scalar.localNormal, 4.0f * b2_epsilon)
+			&& SameVec(batch.points[0].localPoint, scalar.points[0].localPoint, 0.0f)
+			&& batch.points[0].id.key == scalar.points[0].id.key;
+	}
+
+	Transform RandomTransform(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+		std::uniform_real_distribution<float> angle(-b2_pi, b2_pi);
+
+		Transform xf;
+		xf.Set(Vec2(position(rng), position(rng)), angle(rng));
+		return xf;
+	}
+
+	// Places body B so the local point lands on the world point.
+	Transform PlaceOn(std::mt19937& rng, const Vec2& localPoint, const Vec2& worldPoint)
+	{
+		std::uniform_real_distribution<float> angle(-b2_pi, b2_pi);
+
+		Rot q(angle(rng));
+		Transform xf;
+		xf.Set(worldPoint - Mul(q, localPoint), q.GetAngle());
+		return xf;
+	}
+
+	CircleShape RandomCircle(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> radius(0.05f, 0.6f);
+		std::uniform_real_distribution<float> offset(-0.3f, 0.3f);
+
+		CircleShape circle;
+		circle.m_radius = radius(rng);
+		circle.m_p.Set(offset(rng), offset(rng));
+		return circle;
+	}
+
+	// Circles about as far as their radius from the edges, along the edges and past their ends.
+	Pair RandomEdgePair(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> vertex(-1.5f, 1.5f);
+		std::uniform_real_distribution<float> along(-0.6f, 1.6f);
+		std::uniform_real_distribution<float> across(-1.5f, 1.5f);
+		std::uniform_int_distribution<int> sides(0, 3);
+
+		Pair pair;
+		Vec2 v1(vertex(rng), vertex(rng));
+		Vec2 v2(vertex(rng), vertex(rng));
+		if (sides(rng) == 0)
+		{
+			pair.edge.SetTwoSided(v1, v2);
+		}
+		else
+		{
+			// Neighbors bent either way so the ghost tests go both ways.
+			Vec2 v0(v1.x + vertex(rng), v1.y + vertex(rng));
+			Vec2 v3(v2.x + vertex(rng), v2.y + vertex(rng));
+			pair.edge.SetOneSided(v0, v1, v2, v3);
+		}
+		pair.circle = RandomCircle(rng);
+
+		Vec2 e = v2 - v1;
+		Vec2 n(e.y, -e.x);
+		n.Normalize();
+		Vec2 local = v1 + along(rng) * e + (across(rng) * pair.circle.m_radius) * n;
+
+		pair.xfA = RandomTransform(rng);
+		pair.xfB = PlaceOn(rng, pair.circle.m_p, Mul(pair.xfA, local));
+		return pair;
+	}
+
+	Region ScalarRegion(const Pair& pair, const Manifold& manifold)
+	{
+		if (manifold.pointCount == 0)
+		{
+			Vec2 Q = MulT(pair.xfA, Mul(pair.xfB, pair.circle.m_p));
+			Vec2 e = pair.edge.m_vertex2 - pair.edge.m_vertex1;
+			Vec2 n(e.y, -e.x);
+			return pair.edge.m_oneSided && Dot(n, Q - pair.edge.m_vertex1) < 0.0f ? e_back : e_noContact;
+		}
+
+		if (manifold.type == Manifold::e_faceA)
+		{
+			return e_face;
+		}
+
+		return manifold.points[0].id.cf.indexA == 0 ? e_vertexA : e_vertexB;
+	}
+
+	bool CheckCircles(int rounds)
+	{
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> position(-0.8f, 0.8f);
+
+		long long pairs = 0;
+		long long touching = 0;
+		for (int batchSize : batchSizes)
+		{
+			for (int round = 0; round < rounds; ++round)
+			{
+				std::vector<CircleShape> circlesA(batchSize), circlesB(batchSize);
+				std::vector<Transform> xfA(batchSize), xfB(batchSize);
+				CircleCircleBatch batch;
+				for (int i = 0; i < batchSize; ++i)
+				{
+					circlesA[i] = RandomCircle(rng);
+					circlesB[i] = RandomCircle(rng);
+					xfA[i] = RandomTransform(rng);
+					Vec2 centerA = Mul(xfA[i], circlesA[i].m_p);
+					xfB[i] = PlaceOn(rng, circlesB[i].m_p, centerA + Vec2(position(rng), position(rng)));
+					batch.Add(&circlesA[i], xfA[i], &circlesB[i], xfB[i]);
+				}
+
+				std::vector<Manifold> manifolds(batchSize);
+				b2CollideCirclesBatch(manifolds.data(), batch);
+
+				for (int i = 0; i < batchSize; ++i)
+				{
+					Manifold scalar;
+					b2CollideCircles(&scalar, &circlesA[i], xfA[i], &circlesB[i], xfB[i]);
+					if (SameManifold(manifolds[i], scalar) == false)
+					{
+						std::printf("circles: mismatch at pair %d of a batch of %d\n", i, batchSize);
+						return false;
+					}
+					touching += scalar.pointCount;
+				}
+				pairs += batchSize;
+			}
+		}
+
+		std::printf("circles: %lld pairs, %lld touching, all match\n", pairs, touching);
+		return true;
+	}
+
+	bool CheckEdgeAndCircle(int rounds)
+	{
+		std::mt19937 rng(2);
+
+		long long pairs = 0;
+		long long regions[e_regionCount] = {};
+		for (int batchSize : batchSizes)
+		{
+			for (int round = 0; round < rounds; ++round)
+			{
+				std::vector<Pair> pairList(batchSize);
+				EdgeCircleBatch batch;
+				for (int i = 0; i < batchSize; ++i)
+				{
+					pairList[i] = RandomEdgePair(rng);
+				}
+				for (const Pair& pair : pairList)
+				{
+					batch.Add(&pair.edge, pair.xfA, &pair.circle, pair.xfB);
+				}
+
+				std::vector<Manifold> manifolds(batchSize);
+				b2CollideEdgeAndCircleBatch(manifolds.data(), batch);
+
+				for (int i = 0; i < batchSize; ++i)
+				{
+					const Pair& pair = pairList[i];
+					Manifold scalar;
+					b2CollideEdgeAndCircle(&scalar, &pair.edge, pair.xfA, &pair.circle, pair.xfB);
+					if (SameManifold(manifolds[i], scalar) == false)
+					{
+						std::printf("edge and circle: mismatch at pair %d of a batch of %d, %s edge\n",
+									i, batchSize, pair.edge.m_oneSided ? "one sided" : "two sided");
+						return false;
+					}
+					++regions[ScalarRegion(pair, scalar)];
+				}
+				pairs += batchSize;
+			}
+		}
+
+		std::printf("edge and circle: %lld pairs,", pairs);
+		for (int region = 0; region < e_regionCount; ++region)
+		{
+			std::printf(" %s %lld", regionNames[region], regions[region]);
+		}
+		std::printf(", all match\n");
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int rounds = 200;
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (std::string_view(argv[i]) == "--rounds")
+		{
+			rounds = std::atoi(argv[++i]);
+		}
+	}
+
+	bool circles = CheckCircles(rounds);
+	bool edges = CheckEdgeAndCircle(rounds);
+	return circles && edges ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "engine/Entity/CircleEntity.h"
+#include "game/Systems/BulletSystems.h"
+#include "game/Utils/Level.h"
+#include "physicsEngine/dynamics/World.h"
+
+// Headless benchmark of PHE2 on the worlds the game builds. Runs every scenario
+// for a fixed number of steps and prints a JSON report.
+// Usage: phe2-bench [--steps N] [--scenario name] [--out file]
+
+namespace
+{
+	constexpr float time_step = 1.f / 60.f;
+	constexpr int velocity_iterations = 6;
+	constexpr int position_iterations = 2;
+	constexpr unsigned terrain_seed = 1234;
+
+	struct BenchWorld
+	{
+		std::unique_ptr<World> world;
+		LevelBodies level;
+		BulletArchetype bullets;
+		BulletPool bulletPool;
+		std::vector<std::shared_ptr<Entity>> debris;
+	};
+
+	struct Scenario
+	{
+		const char* name;
+		void (*setup)(BenchWorld& bench);
+		// Game logic run before each world step.
+		void (*update)(BenchWorld& bench, int stepIndex);
+	};
+
+	void SetupLevel(BenchWorld& bench)
+	{
+		bench.world = std::make_unique<World>(Vec2(0.f, level_gravity));
+		bench.level = CreateLevelBodies(bench.world.get(), terrain_seed);
+	}
+
+	void UpdateNothing(BenchWorld&, int)
+	{
+	}
+
+	// The level with the bullet pool of GameScene.
+	void SetupVolley(BenchWorld& bench)
+	{
+		SetupLevel(bench);
+		bench.bulletPool.reserve(bench.world.get(), reserved_shells, reserved_fragments);
+	}
+
+	// Both players fire a fan of shells every two seconds, through the bullet
+	// systems of the game.
+	void UpdateVolley(BenchWorld& bench, int stepIndex)
+	{
+		World* world = bench.world.get();
+
+		if (stepIndex % 120 == 0)
+		{
+			for (int player = 0; player < 2; ++player)
+			{
+				const RectEntity& shooter = *bench.level.characters[player];
+				for (int i = 0; i < 8; ++i)
+				{
+					float angle = -20.f - 7.f * i;
+					float power = 40.f + 5.f * i;
+					FireShell(bench.bullets, bench.bulletPool, world, shooter.rb, shooter.size.x, player, player == 0 ? angle : -180.f - angle, power);
+				}
+			}
+		}
+
+		BulletContext context = { world, &bench.bulletPool, { bench.level.characters[0]->rb, bench.level.characters[1]->rb }, -45.f, 60.f };
+		float damage[2] = {};
+		UpdateBullets(bench.bullets, context, damage);
+		bench.bullets.flush();
+	}
+
+	// A pile of boxes and pebbles dropped on the middle of the terrain.
+	void SetupDebris(BenchWorld& bench)
+	{
+		SetupLevel(bench);
+
+		for (int row = 0; row < 25; ++row)
+		{
+			for (int column = 0; column < 20; ++column)
+			{
+				Vec2 position(level_width / 2 - 120.f + 12.f * column + (row % 2) * 6.f, level_height - 500 - 12.f * row);
+				if ((row + column) % 2 == 0)
+				{
+					bench.debris.push_back(EntityFactory::create<RectEntity>(bench.world.get(), Vec2{ 8.f, 8.f }, position, dynamicBody));
+				}
+				else
+				{
+					bench.debris.push_back(EntityFactory::create<CircleEntity>(bench.world.get(), 4.f, position, dynamicBody));
+				}
+			}
+		}
+	}
+
+	const Scenario scenarios[] =
+	{
+		{ "level", SetupLevel, UpdateNothing },
+		{ "volley", SetupVolley, UpdateVolley },
+		{ "debris", SetupDebris, UpdateNothing },
+	};
+
+	void RunScenario(const Scenario& scenario, int stepCount, std::ostream& out)
+	{
+		long long setupAllocations = GetAllocationCount();
+
+		BenchWorld bench;
+		scenario.setup(bench);
+		World& world = *bench.world;
+
+		setupAllocations = GetAllocationCount() - setupAllocations;
+		long long stepAllocations = GetAllocationCount();
+		long long stepBytes = GetAllocationBytes();
+
+		Profile total = {};
+		double maxStep = 0.0;
+		int peakContacts = 0;
+		int peakProxies = 0;
+
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < stepCount; ++i)
+		{
+			scenario.update(bench, i);
+
+			auto stepStart = std::chrono::steady_clock::now();
+			world.Step(time_step, velocity_iterations, position_iterations);
+			std::chrono::duration<double, std::milli> stepTime = std::chrono::steady_clock::now() - stepStart;
+			maxStep = std::max(maxStep, stepTime.count());
+
+			const Profile& profile = world.GetProfile();
+			total.step += profile.step;
+			total.collide += profile.collide;
+			total.solve += profile.solve;
+			total.broadphase += profile.broadphase;
+			total.solveTOI += profile.solveTOI;
+
+			peakContacts = std::max(peakContacts, world.GetContactCount());
+			peakProxies = std::max(peakProxies, world.GetProxyCount());
+		}
+
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		stepAllocations = GetAllocationCount() - stepAllocations;
+		stepBytes = GetAllocationBytes() - stepBytes;
+
+		out << "  {\n";
+		out << "    \"scenario\": \"" << scenario.name << "\",\n";
+		out << "    \"steps\": " << stepCount << ",\n";
+		out << "    \"total_ms\": " << elapsed.count() << ",\n";
+		out << "    \"step_ms\": { \"mean\": " << elapsed.count() / stepCount << ", \"max\": " << maxStep << " },\n";
+		out << "    \"phases_ms\": { \"step\": " << total.step << ", \"collide\": " << total.collide << ", \"solve\": " << total.solve
+			<< ", \"broadphase\": " << total.broadphase << ", \"solve_toi\": " << total.solveTOI << " },\n";
+		out << "    \"allocations\": { \"setup\": " << setupAllocations << ", \"steps\": " << stepAllocations << ", \"step_bytes\": " << stepBytes << " },\n";
+		out << "    \"bodies\": " << world.GetBodyCount() << ",\n";
+		out << "    \"contacts\": { \"final\": " << world.GetContactCount() << ", \"peak\": " << peakContacts << " },\n";
+		out << "    \"proxies\": { \"final\": " << world.GetProxyCount() << ", \"peak\": " << peakProxies << " },\n";
+		out << "    \"tree\": { \"height\": " << world.GetTreeHeight() << ", \"quality\": " << world.GetTreeQuality() << " }\n";
+		out << "  }";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int stepCount = 600;
+	std::string only;
+	std::string path;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		std::string arg = argv[i];
+		if (arg == "--steps")
+		{
+			stepCount = std::max(1, std::atoi(argv[i + 1]));
+		}
+		else if (arg == "--scenario")
+		{
+			only = argv[i + 1];
+		}
+		else if (arg == "--out")
+		{
+			path = argv[i + 1];
+		}
+		else
+		{
+			std::cerr << "Unknown option " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	std::ofstream file;
+	if (!path.empty())
+	{
+		file.open(path);
+		if (!file)
+		{
+			std::cerr << "Cannot write " << path << std::endl;
+			return 1;
+		}
+	}
+	std::ostream& out = path.empty() ? std::cout : file;
+
+	out << "[\n";
+	bool first = true;
+	for (const Scenario& scenario : scenarios)
+	{
+		if (!only.empty() && only != scenario.name)
+		{
+			continue;
+		}
+
+		if (!first)
+		{
+			out << ",\n";
+		}
+		first = false;
+
+		RunScenario(scenario, stepCount, out);
+	}
+	out << "\n]" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "engine/Entity/CircleEntity.h"
+#include "physicsEngine/dynamics/World.h"
+
+// Cost of spawning entities through the factory. Every mode creates the same
+// circles in a fresh world and prints allocations and time per object as JSON.
+// The "body" mode creates the physics bodies alone, what the other modes take
+// on top of it is the factory share.
+// Usage: spawn-bench [--count N] [--out file]
+
+namespace
+{
+	struct Mode
+	{
+		const char* name;
+		// Create count circles in world, kept alive until the mode is measured.
+		void (*spawn)(World& world, int count, std::vector<std::shared_ptr<CircleEntity>>& entities);
+	};
+
+	Vec2 GetSpawnPosition(int i)
+	{
+		return Vec2(10.f * (i % 100), 10.f * (i / 100));
+	}
+
+	void SpawnBodies(World& world, int count, std::vector<std::shared_ptr<CircleEntity>>&)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			CircleEntity::CreateBody(&world, 2.f, GetSpawnPosition(i), dynamicBody);
+		}
+	}
+
+	void SpawnCreate(World& world, int count, std::vector<std::shared_ptr<CircleEntity>>& entities)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			entities.push_back(EntityFactory::create<CircleEntity>(&world, 2.f, GetSpawnPosition(i), dynamicBody));
+		}
+	}
+
+	// A pool resource like a scene would own, created with the world so it is
+	// part of the measure.
+	std::unique_ptr<std::pmr::unsynchronized_pool_resource> g_resource;
+
+	void SpawnPool(World& world, int count, std::vector<std::shared_ptr<CircleEntity>>& entities)
+	{
+		g_resource = std::make_unique<std::pmr::unsynchronized_pool_resource>();
+		std::pmr::polymorphic_allocator<std::byte> allocator(g_resource.get());
+
+		for (int i = 0; i < count; ++i)
+		{
+			entities.push_back(EntityFactory::allocate<CircleEntity>(allocator, &world, 2.f, GetSpawnPosition(i), dynamicBody));
+		}
+	}
+
+	const Mode modes[] =
+	{
+		{ "body", SpawnBodies },
+		{ "create", SpawnCreate },
+		{ "allocate_pool", SpawnPool },
+	};
+
+	void RunMode(const Mode& mode, int count, std::ostream& out)
+	{
+		World world(Vec2(0.f, 9.81f));
+		std::vector<std::shared_ptr<CircleEntity>> entities;
+		entities.reserve(count);
+
+		long long allocations = GetAllocationCount();
+		long long bytes = GetAllocationBytes();
+		auto start = std::chrono::steady_clock::now();
+
+		mode.spawn(world, count, entities);
+
+		std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+		allocations = GetAllocationCount() - allocations;
+		bytes = GetAllocationBytes() - bytes;
+
+		out << "  {\n";
+		out << "    \"mode\": \"" << mode.name << "\",\n";
+		out << "    \"objects\": " << count << ",\n";
+		out << "    \"allocations_per_object\": " << double(allocations) / count << ",\n";
+		out << "    \"bytes_per_object\": " << double(bytes) / count << ",\n";
+		out << "    \"us_per_object\": " << elapsed.count() / count << "\n";
+		out << "  }";
+
+		// The entities go before the resource they live in.
+		entities.clear();
+		g_resource.reset();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int count = 10000;
+	std::string path;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		std::string arg = argv[i];
+		if (arg == "--count")
+		{
+			count = std::max(1, std::atoi(argv[i + 1]));
+		}
+		else if (arg == "--out")
+		{
+			path = argv[i + 1];
+		}
+		else
+		{
+			std::cerr << "Unknown option " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	std::ofstream file;
+	if (!path.empty())
+	{
+		file.open(path);
+		if (!file)
+		{
+			std::cerr << "Cannot write " << path << std::endl;
+			return 1;
+		}
+	}
+	std::ostream& out = path.empty() ? std::cout : file;
+
+	out << "[\n";
+	for (size_t i = 0; i < std::size(modes); ++i)
+	{
+		if (i > 0)
+		{
+			out << ",\n";
+		}
+		RunMode(modes[i], count, out);
+	}
+	out << "\n]" << std::endl;
+
+	return 0;
+}
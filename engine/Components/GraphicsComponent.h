@@ -2,13 +2,15 @@
 #define GRAPHICSCOMPONENT_H
 #include <SFML/Graphics.hpp>
 
+#include "../Render/BatchRenderer.h"
+
 class IGameObject;
 
 
 struct IGraphicsComponent
 {
     virtual ~IGraphicsComponent() = default;
-    virtual void renderImplementation(IGameObject& gameObject, sf::RenderWindow& window) = 0;
+    virtual void renderImplementation(IGameObject& gameObject, BatchRenderer& renderer) = 0;
 };
 
 
@@ -5,6 +5,8 @@
 class IGameObject;
 class IScene;
 
+// A component that ignores every event can declare
+// static constexpr bool ignores_input = true, the typed scenes then do not send it any.
 struct IInputComponent
 {
     virtual ~IInputComponent() = default;
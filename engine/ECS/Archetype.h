@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+// Stable reference to an entity of an archetype, stale once the entity is destroyed.
+struct EntityHandle
+{
+    static constexpr uint32_t invalid_index = UINT32_MAX;
+
+    uint32_t index = invalid_index;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != invalid_index; }
+    bool operator==(const EntityHandle& other) const = default;
+};
+
+// Entities that all have the same components, stored column by column: the i-th
+// entity is the i-th element of every column. Systems run over the columns in
+// bulk instead of calling into each object.
+//
+// Created entities are appended at once, destroyed entities are removed by
+// flush with swap-and-pop. A system may create and destroy entities while it
+// iterates, as long as it iterates by index up to the size it started with and
+// does not keep references across a create.
+template <typename... Components>
+class Archetype
+{
+public:
+    EntityHandle create(const Components&... components)
+    {
+        EntityHandle handle;
+        if (!m_freeSlots.empty())
+        {
+            handle.index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else
+        {
+            handle.index = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back({ 0, 0 });
+        }
+
+        Slot& slot = m_slots[handle.index];
+        slot.dense = static_cast<uint32_t>(m_entitySlots.size());
+        handle.generation = slot.generation;
+
+        (std::get<std::vector<Components>>(m_columns).push_back(components), ...);
+        m_entitySlots.push_back(handle.index);
+        return handle;
+    }
+
+    // Deferred to the next flush. Destroying a stale handle or the same handle twice does nothing.
+    void destroy(EntityHandle handle)
+    {
+        if (isAlive(handle))
+        {
+            m_pendingDestroys.push_back(handle);
+        }
+    }
+
+    void flush()
+    {
+        for (EntityHandle handle : m_pendingDestroys)
+        {
+            if (!isAlive(handle))
+            {
+                continue;
+            }
+
+            Slot& slot = m_slots[handle.index];
+            const uint32_t dense = slot.dense;
+            const uint32_t last = static_cast<uint32_t>(m_entitySlots.size()) - 1;
+
+            // Swap and pop every column.
+            ((moveAndPop(std::get<std::vector<Components>>(m_columns), dense, last)), ...);
+            m_entitySlots[dense] = m_entitySlots[last];
+            m_slots[m_entitySlots[dense]].dense = dense;
+            m_entitySlots.pop_back();
+
+            ++slot.generation;
+            m_freeSlots.push_back(handle.index);
+        }
+        m_pendingDestroys.clear();
+    }
+
+    void clear()
+    {
+        for (uint32_t slotIndex : m_entitySlots)
+        {
+            ++m_slots[slotIndex].generation;
+            m_freeSlots.push_back(slotIndex);
+        }
+        (std::get<std::vector<Components>>(m_columns).clear(), ...);
+        m_entitySlots.clear();
+        m_pendingDestroys.clear();
+    }
+
+    bool isAlive(EntityHandle handle) const
+    {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+    }
+
+    size_t size() const { return m_entitySlots.size(); }
+
+    // Handle of the entity at a dense index.
+    EntityHandle getHandle(size_t index) const
+    {
+        const uint32_t slotIndex = m_entitySlots[index];
+        return { slotIndex, m_slots[slotIndex].generation };
+    }
+
+    template <typename Component>
+    std::vector<Component>& column() { return std::get<std::vector<Component>>(m_columns); }
+
+    template <typename Component>
+    const std::vector<Component>& column() const { return std::get<std::vector<Component>>(m_columns); }
+
+    template <typename Component>
+    Component& get(EntityHandle handle) { return column<Component>()[m_slots[handle.index].dense]; }
+
+    // Call function(index, components...) for every entity alive when the loop starts.
+    template <typename... Selected, typename Function>
+    void forEach(Function&& function)
+    {
+        const size_t count = size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            function(i, column<Selected>()[i]...);
+        }
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t dense;
+        uint32_t generation;
+    };
+
+    template <typename Component>
+    static void moveAndPop(std::vector<Component>& values, uint32_t dense, uint32_t last)
+    {
+        values[dense] = std::move(values[last]);
+        values.pop_back();
+    }
+
+    std::tuple<std::vector<Components>...> m_columns;
+    std::vector<uint32_t> m_entitySlots;
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+
+    std::vector<EntityHandle> m_pendingDestroys;
+};
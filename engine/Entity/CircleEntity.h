@@ -7,17 +7,21 @@
 
 class CircleEntity: public Entity
 {
-	friend Factory;
+	friend EntityFactory;
 private:
-	CircleEntity(float radius, Vec2 position, BodyType type): radius(radius)
+	CircleEntity(World* world, float radius, Vec2 position, b2BodyType type, int layer = 0): radius(radius)
+	{
+		rb = CreateBody(world, radius, position, type, layer);
+	}
+public:
+	// The body alone, for the objects that are stored without an entity.
+	static Body* CreateBody(World* world, float radius, Vec2 position, b2BodyType type, int layer = 0)
 	{
-
 		BodyDef bd;
 		bd.type = type;
 		bd.position.Set(position.x, position.y);
 		bd.allowSleep = false;
 
-		auto world = World::GetWorld();
 		Body* body = world->CreateBody(&bd);
 
 		CircleShape shape;
@@ -28,11 +32,14 @@ private:
 		fd.density = 0.5f;
 		fd.friction = 1.0f;
 		fd.restitution = 0.4f;
+		fd.enableContactEvents = true;
+		fd.shareShape = true;
+		fd.filter.layer = layer;
 
 		body->CreateFixture(&fd);
 
-		rb = body;
+		return body;
 	}
-public:
+
 	float radius;
 };
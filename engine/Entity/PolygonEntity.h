@@ -3,19 +3,19 @@
 #include "physicsEngine/collision/ChainShape.h"
 #include "physicsEngine/collision/EdgeShape.h"
 #include "physicsEngine/dynamics/World.h"
+#include "physicsEngine/dynamics/Fixture.h"
 
 class PolygonEntity : public Entity
 {
-	friend Factory;
+	friend EntityFactory;
 private:
-	PolygonEntity(const std::vector<Vec2>& vertices, Vec2 position) : vertices(vertices)
+	PolygonEntity(World* world, const std::vector<Vec2>& vertices, Vec2 position, int layer = 0) : vertices(vertices)
 	{
 
 		BodyDef bd;
-		bd.type = staticBody;
+		bd.type = b2_staticBody;
 		bd.position.Set(position.x, position.y);
 
-		auto world = World::GetWorld();
 		Body* body = world->CreateBody(&bd);
 
 		EdgeShape shape;
@@ -32,6 +32,8 @@ private:
 			fdef.shape = &shape;
 			fdef.friction = 1;
 			fdef.restitution = 0;
+			fdef.shareShape = true;
+			fdef.filter.layer = layer;
 			body->CreateFixture(&fdef);
 		}
 
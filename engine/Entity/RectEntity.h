@@ -7,15 +7,14 @@
 
 class RectEntity: public Entity
 {
-	friend Factory;
+	friend EntityFactory;
 private:
-	RectEntity(const Vec2& size, const Vec2& position, const BodyType type): size(size)
+	RectEntity(World* world, const Vec2& size, const Vec2& position, const b2BodyType type, int layer = 0): size(size)
 	{
 		BodyDef bd;
 		bd.type = type;
 		bd.position.Set(position.x, position.y);
 
-		auto world = World::GetWorld();
 		Body * body = world->CreateBody(&bd);
 
 		PolygonShape shape;
@@ -26,6 +25,9 @@ private:
 		fd.density = 1.0f;
 		fd.friction = 0.8f;
 		fd.restitution = 0.f;
+		fd.enableContactEvents = true;
+		fd.shareShape = true;
+		fd.filter.layer = layer;
 
 		body->CreateFixture(&fd);
 
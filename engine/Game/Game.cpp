@@ -1,6 +1,15 @@
 #include "Game.h"
+#include <algorithm>
 #include <cassert>
 
+// The scenes advance by this much per update, however long the frames take, so
+// a replay steps the world exactly like the recorded run.
+constexpr float fixed_time_step = 1.f / 60.f;
+// The game has always run ten times faster than real time.
+constexpr float time_scale = 10.f;
+// A longer frame (a breakpoint, a dragged window) is cut short rather than caught up.
+constexpr float max_frame_time = 0.25f;
+
 
 Game::~Game()
 {
@@ -15,18 +24,98 @@ void Game::run(sf::VideoMode videoMode, std::string windowTitle, sf::Uint32 styl
 
     sf::Clock DeltaTimeClock;
     float deltaTime;
+    m_accumulator = 0.f;
 
     while (m_window.isOpen()) {
 
         deltaTime = DeltaTimeClock.getElapsedTime().asSeconds();
         DeltaTimeClock.restart();
 
+        if (m_recording)
+            m_recording->beginFrame(deltaTime);
+
         processInput();
-        update(deltaTime * 10);
+        advance(deltaTime);
         render();
     }
 }
 
+void Game::replay(const InputRecording& recording, bool headless, std::ostream* timings, sf::VideoMode videoMode, std::string windowTitle, sf::Uint32 style)
+{
+    assert("m_pCurrentScene is nullptr", m_pCurrentScene != nullptr);
+
+    if (!headless)
+        initWindow(videoMode, windowTitle, style);
+
+    if (timings)
+        *timings << "frame,delta_time,updates,events,input_ms,update_ms,render_ms,draw_calls,vertices\n";
+
+    // Same start as run, the mouse is only known from the recorded events.
+    m_accumulator = 0.f;
+    m_mousePosition = {};
+    m_mouseButtons = 0;
+
+    const std::vector<InputFrame>& frames = recording.getFrames();
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        const InputFrame& frame = frames[i];
+        bool closed = false;
+
+        // Live events are dropped, only the window close is honoured.
+        sf::Event liveEvent;
+        while (!headless && m_window.pollEvent(liveEvent))
+        {
+            if (liveEvent.type == sf::Event::Closed)
+                closed = true;
+        }
+
+        sf::Clock clock;
+        for (sf::Event event : frame.events)
+        {
+            if (event.type == sf::Event::Closed)
+            {
+                closed = true;
+                break;
+            }
+
+            dispatchEvent(event);
+        }
+        float inputTime = clock.restart().asSeconds() * 1000.f;
+
+        int updates = advance(frame.deltaTime);
+        float updateTime = clock.restart().asSeconds() * 1000.f;
+
+        float renderTime = 0.f;
+        RenderStats renderStats;
+        if (!headless)
+        {
+            render();
+            renderTime = clock.restart().asSeconds() * 1000.f;
+            renderStats = m_pCurrentScene->getRenderer().getStats();
+        }
+
+        if (timings)
+            *timings << i << ',' << frame.deltaTime << ',' << updates << ',' << frame.events.size() << ',' << inputTime << ',' << updateTime << ',' << renderTime
+                     << ',' << renderStats.drawCalls << ',' << renderStats.vertices << '\n';
+
+        if (closed)
+            break;
+    }
+
+    if (!headless)
+        m_window.close();
+}
+
+void Game::startRecording(unsigned seed)
+{
+    m_recording = std::make_unique<InputRecording>(seed);
+}
+
+const InputRecording* Game::getRecording() const
+{
+    return m_recording.get();
+}
+
 sf::RenderWindow* Game::getWindow()
 {
     return &m_window;
@@ -37,6 +126,16 @@ IScene* Game::GetCurrentScene()
     return m_pCurrentScene;
 }
 
+sf::Vector2i Game::getMousePosition() const
+{
+    return m_mousePosition;
+}
+
+bool Game::isMouseButtonPressed(sf::Mouse::Button button) const
+{
+    return (m_mouseButtons & (1u << button)) != 0;
+}
+
 void Game::setCurrentScene(const size_t index)
 {
     m_pCurrentScene = m_scenes.at(index);
@@ -74,11 +173,50 @@ void Game::processInput()
     sf::Event event;
     while (m_window.pollEvent(event))
     {
+        if (m_recording)
+            m_recording->addEvent(event);
+
         if (event.type == sf::Event::Closed)
             m_window.close();
 
-        m_pCurrentScene->processInput(event);
+        dispatchEvent(event);
+    }
+}
+
+void Game::dispatchEvent(sf::Event& event)
+{
+    switch (event.type)
+    {
+    case sf::Event::MouseMoved:
+        m_mousePosition = { event.mouseMove.x, event.mouseMove.y };
+        break;
+    case sf::Event::MouseButtonPressed:
+        m_mousePosition = { event.mouseButton.x, event.mouseButton.y };
+        m_mouseButtons |= 1u << event.mouseButton.button;
+        break;
+    case sf::Event::MouseButtonReleased:
+        m_mousePosition = { event.mouseButton.x, event.mouseButton.y };
+        m_mouseButtons &= ~(1u << event.mouseButton.button);
+        break;
+    default:
+        break;
+    }
+
+    m_pCurrentScene->processInput(event);
+}
+
+int Game::advance(float frameTime)
+{
+    m_accumulator += std::min(frameTime, max_frame_time);
+
+    int updates = 0;
+    while (m_accumulator >= fixed_time_step)
+    {
+        update(fixed_time_step * time_scale);
+        m_accumulator -= fixed_time_step;
+        ++updates;
     }
+    return updates;
 }
 
 void Game::update(const float& deltaTime)
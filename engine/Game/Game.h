@@ -4,6 +4,10 @@
 #include "tools/DesignPatterns/Singleton.h"
 #include <SFML/Graphics.hpp>
 
+#include <memory>
+#include <ostream>
+
+#include "engine/Game/InputRecording.h"
 #include "engine/Scene/Scene.h"
 
 class Game : public Singleton<Game>
@@ -15,9 +19,25 @@ public:
     ~Game();
     void run(sf::VideoMode videoMode = sf::VideoMode(1920, 1080), std::string windowTitle = "SFML", sf::Uint32 style = sf::Style::Default);
 
+    // Feed a recorded session back through the scenes, frame by frame. The recorded
+    // frame times give the same fixed updates as the live run. Headless skips the
+    // window and the rendering. The timing and the draw calls of every frame are
+    // written to timings as csv when given.
+    void replay(const InputRecording& recording, bool headless, std::ostream* timings = nullptr,
+        sf::VideoMode videoMode = sf::VideoMode(1920, 1080), std::string windowTitle = "SFML", sf::Uint32 style = sf::Style::Default);
+
+    // Record the input of the following run, seed is the seed the game RNG was given.
+    void startRecording(unsigned seed);
+    const InputRecording* getRecording() const;
+
     sf::RenderWindow* getWindow();
     IScene* GetCurrentScene();
 
+    // Where the mouse is in the window and which buttons are down, as of the last
+    // event given to the scenes. A replay gets them from the recorded events.
+    sf::Vector2i getMousePosition() const;
+    bool isMouseButtonPressed(sf::Mouse::Button button) const;
+
     template <typename... Args>
     void addScenes(Args... scenes);
 
@@ -32,12 +52,24 @@ private:
     void initWindow(sf::VideoMode videoMode = sf::VideoMode(1920, 1080), std::string windowTitle = "SFML", sf::Uint32 style = sf::Style::Default);
 
     void processInput();
+    // Track the mouse from the event and pass it to the current scene.
+    void dispatchEvent(sf::Event& event);
+    // Run the fixed updates that fit in the time accumulated so far, returns how many ran.
+    int advance(float frameTime);
     void update(const float& deltaTime);
     void render();
 
 
     // attributes
     sf::RenderWindow m_window;
+    std::unique_ptr<InputRecording> m_recording;
+
+    // Frame time not consumed by a fixed update yet.
+    float m_accumulator = 0.f;
+
+    sf::Vector2i m_mousePosition;
+    // One bit per sf::Mouse::Button.
+    unsigned m_mouseButtons = 0;
 
     std::vector<IScene*> m_scenes;
     IScene* m_pCurrentScene;
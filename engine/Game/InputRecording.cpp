@@ -0,0 +1,238 @@
+#include "InputRecording.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    constexpr char recording_magic[4] = { 'B', 'R', 'E', 'C' };
+    constexpr uint32_t recording_version = 1;
+
+    template <typename T>
+    void write(std::ostream& stream, T value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool read(std::istream& stream, T& value)
+    {
+        return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    void writeEvent(std::ostream& stream, const sf::Event& event)
+    {
+        write<uint8_t>(stream, static_cast<uint8_t>(event.type));
+
+        switch (event.type)
+        {
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+            write<int32_t>(stream, event.key.code);
+            write<uint8_t>(stream, (event.key.alt ? 1 : 0) | (event.key.control ? 2 : 0) | (event.key.shift ? 4 : 0) | (event.key.system ? 8 : 0));
+            break;
+        case sf::Event::TextEntered:
+            write<uint32_t>(stream, event.text.unicode);
+            break;
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            write<uint8_t>(stream, static_cast<uint8_t>(event.mouseButton.button));
+            write<int32_t>(stream, event.mouseButton.x);
+            write<int32_t>(stream, event.mouseButton.y);
+            break;
+        case sf::Event::MouseMoved:
+            write<int32_t>(stream, event.mouseMove.x);
+            write<int32_t>(stream, event.mouseMove.y);
+            break;
+        case sf::Event::MouseWheelScrolled:
+            write<uint8_t>(stream, static_cast<uint8_t>(event.mouseWheelScroll.wheel));
+            write<float>(stream, event.mouseWheelScroll.delta);
+            write<int32_t>(stream, event.mouseWheelScroll.x);
+            write<int32_t>(stream, event.mouseWheelScroll.y);
+            break;
+        case sf::Event::Resized:
+            write<uint32_t>(stream, event.size.width);
+            write<uint32_t>(stream, event.size.height);
+            break;
+        default:
+            // The other events carry nothing the game reads.
+            break;
+        }
+    }
+
+    bool readEvent(std::istream& stream, sf::Event& event)
+    {
+        std::memset(&event, 0, sizeof(event));
+
+        uint8_t type;
+        if (!read(stream, type) || type >= sf::Event::Count)
+        {
+            return false;
+        }
+        event.type = static_cast<sf::Event::EventType>(type);
+
+        int32_t x, y;
+        uint8_t byte;
+        switch (event.type)
+        {
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+        {
+            int32_t code;
+            if (!read(stream, code) || !read(stream, byte))
+            {
+                return false;
+            }
+            event.key.code = static_cast<sf::Keyboard::Key>(code);
+            event.key.alt = (byte & 1) != 0;
+            event.key.control = (byte & 2) != 0;
+            event.key.shift = (byte & 4) != 0;
+            event.key.system = (byte & 8) != 0;
+            return true;
+        }
+        case sf::Event::TextEntered:
+            return read(stream, event.text.unicode);
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            if (!read(stream, byte) || !read(stream, x) || !read(stream, y))
+            {
+                return false;
+            }
+            event.mouseButton.button = static_cast<sf::Mouse::Button>(byte);
+            event.mouseButton.x = x;
+            event.mouseButton.y = y;
+            return true;
+        case sf::Event::MouseMoved:
+            if (!read(stream, x) || !read(stream, y))
+            {
+                return false;
+            }
+            event.mouseMove.x = x;
+            event.mouseMove.y = y;
+            return true;
+        case sf::Event::MouseWheelScrolled:
+        {
+            float delta;
+            if (!read(stream, byte) || !read(stream, delta) || !read(stream, x) || !read(stream, y))
+            {
+                return false;
+            }
+            event.mouseWheelScroll.wheel = static_cast<sf::Mouse::Wheel>(byte);
+            event.mouseWheelScroll.delta = delta;
+            event.mouseWheelScroll.x = x;
+            event.mouseWheelScroll.y = y;
+            return true;
+        }
+        case sf::Event::Resized:
+            return read(stream, event.size.width) && read(stream, event.size.height);
+        default:
+            return true;
+        }
+    }
+}
+
+InputRecording::InputRecording(unsigned seed) : m_seed(seed)
+{
+}
+
+unsigned InputRecording::getSeed() const
+{
+    return m_seed;
+}
+
+void InputRecording::beginFrame(float deltaTime)
+{
+    m_frames.push_back({ deltaTime, {} });
+}
+
+void InputRecording::addEvent(const sf::Event& event)
+{
+    if (m_frames.empty())
+    {
+        beginFrame(0.f);
+    }
+    m_frames.back().events.push_back(event);
+}
+
+const std::vector<InputFrame>& InputRecording::getFrames() const
+{
+    return m_frames;
+}
+
+bool InputRecording::save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Error writing recording " << path << std::endl;
+        return false;
+    }
+
+    file.write(recording_magic, sizeof(recording_magic));
+    write<uint32_t>(file, recording_version);
+    write<uint32_t>(file, m_seed);
+    write<uint32_t>(file, static_cast<uint32_t>(m_frames.size()));
+
+    for (const InputFrame& frame : m_frames)
+    {
+        write<float>(file, frame.deltaTime);
+        write<uint16_t>(file, static_cast<uint16_t>(frame.events.size()));
+        for (const sf::Event& event : frame.events)
+        {
+            writeEvent(file, event);
+        }
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool InputRecording::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Error loading recording " << path << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version, seed, frameCount;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, recording_magic, sizeof(magic)) != 0
+        || !read(file, version) || version != recording_version
+        || !read(file, seed) || !read(file, frameCount))
+    {
+        std::cout << "Error loading recording " << path << ": bad header" << std::endl;
+        return false;
+    }
+
+    m_seed = seed;
+    m_frames.clear();
+    m_frames.reserve(frameCount);
+
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        InputFrame frame;
+        uint16_t eventCount;
+        if (!read(file, frame.deltaTime) || !read(file, eventCount))
+        {
+            std::cout << "Error loading recording " << path << ": truncated at frame " << i << std::endl;
+            return false;
+        }
+
+        frame.events.resize(eventCount);
+        for (sf::Event& event : frame.events)
+        {
+            if (!readEvent(file, event))
+            {
+                std::cout << "Error loading recording " << path << ": bad event at frame " << i << std::endl;
+                return false;
+            }
+        }
+
+        m_frames.push_back(std::move(frame));
+    }
+
+    return true;
+}
@@ -0,0 +1,43 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <string>
+#include <vector>
+
+#include <SFML/Window/Event.hpp>
+
+// The input of one frame: its duration and the window events polled during it.
+struct InputFrame
+{
+    float deltaTime;
+    std::vector<sf::Event> events;
+};
+
+// A recorded session: the seed of the game RNG and the input of every frame.
+// Replaying the frames with the same seed reproduces the session exactly.
+//
+// File layout, little endian: "BREC", version, seed, frame count, then per frame
+// the frame time, the event count and the events. An event is its type followed
+// by the fields the type uses, so most frames take 6 bytes.
+class InputRecording
+{
+public:
+    explicit InputRecording(unsigned seed = 0);
+
+    unsigned getSeed() const;
+
+    // Start a new frame, the following events belong to it.
+    void beginFrame(float deltaTime);
+    void addEvent(const sf::Event& event);
+
+    const std::vector<InputFrame>& getFrames() const;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+private:
+    unsigned m_seed;
+    std::vector<InputFrame> m_frames;
+};
+
+#endif // INPUT_RECORDING_H
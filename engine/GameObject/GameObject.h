@@ -1,27 +1,43 @@
 #pragma once 
 
-#include "../../Tools/DesignPatterns/Composite.h"
+#include "../Components/GraphicsComponent.h"
 #include "../Components/InputComponent.h"
+#include "../Components/PhysicsComponent.h"
+#include "../Scene/GameObjectRegistry.h"
 #include <SFML/Graphics.hpp>
+#include <type_traits>
 
 
 class IScene;
 
+template<typename Component>
+concept IgnoresInput = requires { requires Component::ignores_input; };
 
-class IGameObject: public Composite<IGameObject>
+
+class IGameObject
 {
 public:
 	virtual ~IGameObject() {};
 
 	virtual void processInput(sf::Event& inputEvent, IScene& scene) = 0;
 	virtual void update(const float& deltaTime, IScene& scene) = 0;
-	virtual void render(sf::RenderWindow& window) = 0;
+	virtual void render(BatchRenderer& renderer) = 0;
+
+	// Handle of the object in its scene, set when the object is spawned.
+	GameObjectHandle getHandle() const { return m_handle; }
+	void setHandle(GameObjectHandle handle) { m_handle = handle; }
+
+private:
+	GameObjectHandle m_handle;
 };
 
 template<typename... MixinGameComponents>
 class GameObject : public IGameObject, public MixinGameComponents...
 {
 public:
+	// False when the input component ignores every event.
+	static constexpr bool receives_input = !(IgnoresInput<MixinGameComponents> || ...);
+
 	void processInput(sf::Event& inputEvent, IScene& scene) override
 	{
 		this->processInputImplementation(*this, inputEvent, scene);
@@ -32,9 +48,47 @@ public:
 		this->updateImplementation(deltaTime, *this, scene);
 	}
 
-	void render(sf::RenderWindow& window) override
+	void render(BatchRenderer& renderer) override
 	{
-		this->renderImplementation(*this, window);
+		this->renderImplementation(*this, renderer);
 	}
 
+	// Same as above for callers that know the concrete type: each component is
+	// called by its qualified name, without going through a virtual table.
+	void processInputDirect(sf::Event& inputEvent, IScene& scene)
+	{
+		(processInputWith<MixinGameComponents>(inputEvent, scene), ...);
+	}
+
+	void updateDirect(const float& deltaTime, IScene& scene)
+	{
+		(updateWith<MixinGameComponents>(deltaTime, scene), ...);
+	}
+
+	void renderDirect(BatchRenderer& renderer)
+	{
+		(renderWith<MixinGameComponents>(renderer), ...);
+	}
+
+private:
+	template<typename Component>
+	void processInputWith(sf::Event& inputEvent, IScene& scene)
+	{
+		if constexpr (std::is_base_of_v<IInputComponent, Component>)
+			this->Component::processInputImplementation(*this, inputEvent, scene);
+	}
+
+	template<typename Component>
+	void updateWith(const float& deltaTime, IScene& scene)
+	{
+		if constexpr (std::is_base_of_v<IPhysicsComponent, Component>)
+			this->Component::updateImplementation(deltaTime, *this, scene);
+	}
+
+	template<typename Component>
+	void renderWith(BatchRenderer& renderer)
+	{
+		if constexpr (std::is_base_of_v<IGraphicsComponent, Component>)
+			this->Component::renderImplementation(*this, renderer);
+	}
 };
@@ -0,0 +1,302 @@
+#include "BatchRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	constexpr float pi = 3.14159265358979f;
+
+	// Two triangles for the quad a, b, c, d in this order around it.
+	void appendQuad(std::vector<sf::Vertex>& vertices, const sf::Vertex& a, const sf::Vertex& b, const sf::Vertex& c, const sf::Vertex& d)
+	{
+		vertices.push_back(a);
+		vertices.push_back(b);
+		vertices.push_back(c);
+		vertices.push_back(a);
+		vertices.push_back(c);
+		vertices.push_back(d);
+	}
+}
+
+void BatchRenderer::addQuad(int layer, const sf::Transform& transform, const sf::FloatRect& rect, const sf::Color& color,
+	const sf::Texture* texture, const sf::FloatRect& textureRect)
+{
+	const float left = rect.left;
+	const float top = rect.top;
+	const float right = rect.left + rect.width;
+	const float bottom = rect.top + rect.height;
+
+	const float u0 = textureRect.left;
+	const float v0 = textureRect.top;
+	const float u1 = textureRect.left + textureRect.width;
+	const float v1 = textureRect.top + textureRect.height;
+
+	appendQuad(getVertices(layer, texture),
+		sf::Vertex(transform.transformPoint(left, top), color, sf::Vector2f(u0, v0)),
+		sf::Vertex(transform.transformPoint(right, top), color, sf::Vector2f(u1, v0)),
+		sf::Vertex(transform.transformPoint(right, bottom), color, sf::Vector2f(u1, v1)),
+		sf::Vertex(transform.transformPoint(left, bottom), color, sf::Vector2f(u0, v1)));
+}
+
+void BatchRenderer::addShape(int layer, const sf::Shape& shape)
+{
+	const size_t pointCount = shape.getPointCount();
+	if (pointCount < 3 || shape.getFillColor().a == 0)
+	{
+		return;
+	}
+
+	// The texture covers the bounds of the points, as sf::Shape maps it.
+	sf::Vector2f minimum = shape.getPoint(0);
+	sf::Vector2f maximum = minimum;
+	for (size_t i = 1; i < pointCount; ++i)
+	{
+		const sf::Vector2f point = shape.getPoint(i);
+		minimum = sf::Vector2f(std::min(minimum.x, point.x), std::min(minimum.y, point.y));
+		maximum = sf::Vector2f(std::max(maximum.x, point.x), std::max(maximum.y, point.y));
+	}
+	const sf::FloatRect bounds(minimum, maximum - minimum);
+	const sf::IntRect textureRect = shape.getTextureRect();
+	const sf::Transform& transform = shape.getTransform();
+	const sf::Color color = shape.getFillColor();
+
+	auto makeVertex = [&](size_t index)
+	{
+		const sf::Vector2f point = shape.getPoint(index);
+		const float x = bounds.width > 0 ? (point.x - bounds.left) / bounds.width : 0;
+		const float y = bounds.height > 0 ? (point.y - bounds.top) / bounds.height : 0;
+		return sf::Vertex(transform.transformPoint(point), color,
+			sf::Vector2f(textureRect.left + textureRect.width * x, textureRect.top + textureRect.height * y));
+	};
+
+	std::vector<sf::Vertex>& vertices = getVertices(layer, shape.getTexture());
+	const sf::Vertex first = makeVertex(0);
+	sf::Vertex previous = makeVertex(1);
+	for (size_t i = 2; i < pointCount; ++i)
+	{
+		const sf::Vertex current = makeVertex(i);
+		vertices.push_back(first);
+		vertices.push_back(previous);
+		vertices.push_back(current);
+		previous = current;
+	}
+}
+
+void BatchRenderer::addCircle(int layer, const sf::Vector2f& center, float radius, const sf::Color& color, size_t pointCount)
+{
+	const std::vector<sf::Vector2f>& points = getUnitCircle(pointCount);
+	std::vector<sf::Vertex>& vertices = getVertices(layer, nullptr);
+
+	for (size_t i = 0; i < pointCount; ++i)
+	{
+		vertices.emplace_back(center, color);
+		vertices.emplace_back(center + radius * points[i], color);
+		vertices.emplace_back(center + radius * points[i + 1], color);
+	}
+}
+
+void BatchRenderer::addSprite(int layer, const sf::Sprite& sprite)
+{
+	const sf::Texture* texture = sprite.getTexture();
+	if (texture == nullptr)
+	{
+		return;
+	}
+
+	const sf::IntRect textureRect = sprite.getTextureRect();
+	const sf::FloatRect rect(0.f, 0.f, static_cast<float>(std::abs(textureRect.width)), static_cast<float>(std::abs(textureRect.height)));
+	addQuad(layer, sprite.getTransform(), rect, sprite.getColor(), texture, sf::FloatRect(textureRect));
+}
+
+// The layout of sf::Text, one quad per glyph.
+void BatchRenderer::addText(int layer, const sf::Text& text)
+{
+	const sf::Font* font = text.getFont();
+	const sf::String& string = text.getString();
+	if (font == nullptr || string.isEmpty())
+	{
+		return;
+	}
+
+	const unsigned int characterSize = text.getCharacterSize();
+	const bool isBold = (text.getStyle() & sf::Text::Bold) != 0;
+	const float italicShear = (text.getStyle() & sf::Text::Italic) ? 0.209f : 0.f;
+
+	float whitespaceWidth = font->getGlyph(L' ', characterSize, isBold).advance;
+	const float letterSpacing = (whitespaceWidth / 3.f) * (text.getLetterSpacing() - 1.f);
+	whitespaceWidth += letterSpacing;
+	const float lineSpacing = font->getLineSpacing(characterSize) * text.getLineSpacing();
+
+	const sf::Transform& transform = text.getTransform();
+	const sf::Color color = text.getFillColor();
+
+	// The font page, filled by getGlyph, stays the same object when it grows.
+	std::vector<sf::Vertex>& vertices = getVertices(layer, &font->getTexture(characterSize));
+
+	float x = 0.f;
+	float y = static_cast<float>(characterSize);
+	sf::Uint32 previousCharacter = 0;
+	for (sf::Uint32 character : string)
+	{
+		if (character == L'\r')
+		{
+			continue;
+		}
+
+		x += font->getKerning(previousCharacter, character, characterSize, isBold);
+		previousCharacter = character;
+
+		if (character == L' ' || character == L'\t' || character == L'\n')
+		{
+			if (character == L' ')
+			{
+				x += whitespaceWidth;
+			}
+			else if (character == L'\t')
+			{
+				x += whitespaceWidth * 4;
+			}
+			else
+			{
+				y += lineSpacing;
+				x = 0;
+			}
+			continue;
+		}
+
+		const sf::Glyph& glyph = font->getGlyph(character, characterSize, isBold);
+
+		const float padding = 1.f;
+		const float left = glyph.bounds.left - padding;
+		const float top = glyph.bounds.top - padding;
+		const float right = glyph.bounds.left + glyph.bounds.width + padding;
+		const float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+		const float u0 = static_cast<float>(glyph.textureRect.left) - padding;
+		const float v0 = static_cast<float>(glyph.textureRect.top) - padding;
+		const float u1 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+		const float v1 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+		appendQuad(vertices,
+			sf::Vertex(transform.transformPoint(x + left - italicShear * top, y + top), color, sf::Vector2f(u0, v0)),
+			sf::Vertex(transform.transformPoint(x + right - italicShear * top, y + top), color, sf::Vector2f(u1, v0)),
+			sf::Vertex(transform.transformPoint(x + right - italicShear * bottom, y + bottom), color, sf::Vector2f(u1, v1)),
+			sf::Vertex(transform.transformPoint(x + left - italicShear * bottom, y + bottom), color, sf::Vector2f(u0, v1)));
+
+		x += glyph.advance + letterSpacing;
+	}
+}
+
+void BatchRenderer::addDrawable(int layer, const sf::Drawable& drawable)
+{
+	m_drawables.push_back({ layer, &drawable });
+}
+
+void BatchRenderer::flush(sf::RenderTarget& target, const sf::RenderStates& states)
+{
+	// The streams unused this frame go. When the frame submits as the previous one, the others are in order already.
+	std::erase_if(m_batches, [](const Batch& batch) { return batch.vertices.empty(); });
+	std::sort(m_batches.begin(), m_batches.end(), [](const Batch& a, const Batch& b)
+	{
+		return a.layer != b.layer ? a.layer < b.layer : a.firstSubmission < b.firstSubmission;
+	});
+	std::stable_sort(m_drawables.begin(), m_drawables.end(), [](const DrawableEntry& a, const DrawableEntry& b)
+	{
+		return a.layer < b.layer;
+	});
+
+	m_stats = {};
+
+	size_t drawable = 0;
+	for (const Batch& batch : m_batches)
+	{
+		for (; drawable < m_drawables.size() && m_drawables[drawable].layer <= batch.layer; ++drawable)
+		{
+			target.draw(*m_drawables[drawable].drawable, states);
+			++m_stats.drawCalls;
+		}
+
+		sf::RenderStates batchStates = states;
+		batchStates.texture = batch.texture;
+		target.draw(batch.vertices.data(), batch.vertices.size(), sf::Triangles, batchStates);
+		++m_stats.drawCalls;
+		m_stats.vertices += batch.vertices.size();
+	}
+
+	for (; drawable < m_drawables.size(); ++drawable)
+	{
+		target.draw(*m_drawables[drawable].drawable, states);
+		++m_stats.drawCalls;
+	}
+
+	clear();
+}
+
+void BatchRenderer::clear()
+{
+	for (Batch& batch : m_batches)
+	{
+		batch.vertices.clear();
+	}
+	m_submissionCount = 0;
+	m_drawables.clear();
+}
+
+const RenderStats& BatchRenderer::getStats() const
+{
+	return m_stats;
+}
+
+// A frame adds to a handful of streams, mostly to the same one several times in a row.
+// A stream empty so far is submitted to for the first time this frame.
+std::vector<sf::Vertex>& BatchRenderer::getVertices(int layer, const sf::Texture* texture)
+{
+	auto submit = [this](Batch& batch) -> std::vector<sf::Vertex>&
+	{
+		if (batch.vertices.empty())
+		{
+			batch.firstSubmission = m_submissionCount++;
+		}
+		return batch.vertices;
+	};
+
+	if (m_lastBatch < m_batches.size() && m_batches[m_lastBatch].layer == layer && m_batches[m_lastBatch].texture == texture)
+	{
+		return submit(m_batches[m_lastBatch]);
+	}
+
+	for (size_t i = 0; i < m_batches.size(); ++i)
+	{
+		if (m_batches[i].layer == layer && m_batches[i].texture == texture)
+		{
+			m_lastBatch = i;
+			return submit(m_batches[i]);
+		}
+	}
+
+	m_lastBatch = m_batches.size();
+	m_batches.push_back({ layer, texture, {}, 0 });
+	return submit(m_batches.back());
+}
+
+// pointCount + 1 points, the last one closes the fan.
+const std::vector<sf::Vector2f>& BatchRenderer::getUnitCircle(size_t pointCount)
+{
+	for (const UnitCircle& circle : m_unitCircles)
+	{
+		if (circle.pointCount == pointCount)
+		{
+			return circle.points;
+		}
+	}
+
+	UnitCircle& circle = m_unitCircles.emplace_back();
+	circle.pointCount = pointCount;
+	for (size_t i = 0; i <= pointCount; ++i)
+	{
+		const float angle = 2 * pi * (i % pointCount) / pointCount;
+		circle.points.emplace_back(std::cos(angle), std::sin(angle));
+	}
+	return circle.points;
+}
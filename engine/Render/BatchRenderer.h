@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+
+// Draw calls and vertices of the last flush.
+struct RenderStats
+{
+    size_t drawCalls = 0;
+    size_t vertices = 0;
+};
+
+// Gathers the shapes, sprites and texts of a frame into one triangle stream per
+// layer and texture, and draws each stream in one call, the layers in increasing
+// order. Inside a layer the streams of different textures are drawn one after the
+// other, in the order of their first submission of the frame: what must cover
+// something else goes to a higher layer.
+// The streams keep their memory from one frame to the next.
+//
+// Only the fill of the shapes is batched, not their outline. Shapes are split in
+// fans, they must be convex as sf::Shape requires.
+class BatchRenderer
+{
+public:
+    // A rectangle of local coordinates placed by transform, untextured when texture is null.
+    void addQuad(int layer, const sf::Transform& transform, const sf::FloatRect& rect, const sf::Color& color,
+                 const sf::Texture* texture = nullptr, const sf::FloatRect& textureRect = {});
+
+    void addShape(int layer, const sf::Shape& shape);
+
+    // A filled circle, the fan is computed once per point count and scaled to each circle.
+    void addCircle(int layer, const sf::Vector2f& center, float radius, const sf::Color& color, size_t pointCount = 16);
+
+    void addSprite(int layer, const sf::Sprite& sprite);
+
+    // The glyphs of the text, in the stream of the font page of its character size.
+    // Underline, strike through and outline are not drawn.
+    void addText(int layer, const sf::Text& text);
+
+    // Drawn on its own before the streams of its layer, for what cannot be batched.
+    // The drawable must live until the flush.
+    void addDrawable(int layer, const sf::Drawable& drawable);
+
+    // Draw everything added since the last flush, and start the next frame.
+    void flush(sf::RenderTarget& target, const sf::RenderStates& states = sf::RenderStates::Default);
+
+    // Drop everything added since the last flush.
+    void clear();
+
+    const RenderStats& getStats() const;
+
+private:
+    struct Batch
+    {
+        int layer;
+        const sf::Texture* texture;
+        std::vector<sf::Vertex> vertices;
+        size_t firstSubmission;
+    };
+
+    struct DrawableEntry
+    {
+        int layer;
+        const sf::Drawable* drawable;
+    };
+
+    struct UnitCircle
+    {
+        size_t pointCount;
+        std::vector<sf::Vector2f> points;
+    };
+
+    std::vector<sf::Vertex>& getVertices(int layer, const sf::Texture* texture);
+    const std::vector<sf::Vector2f>& getUnitCircle(size_t pointCount);
+
+    std::vector<Batch> m_batches;
+    size_t m_lastBatch = 0;
+    size_t m_submissionCount = 0;
+    std::vector<DrawableEntry> m_drawables;
+    std::vector<UnitCircle> m_unitCircles;
+    RenderStats m_stats;
+};
@@ -0,0 +1,58 @@
+#include "ResourceCache.h"
+
+#include "lib/thor/include/Thor/Resources/SfmlLoaders.hpp"
+
+// The holder drops its entry when the last reference goes, a path it knows is a
+// resource still loaded.
+template<typename Resource>
+std::shared_ptr<Resource> ResourceCache::acquire(Holder<Resource>& holder, const std::string& path)
+{
+	try
+	{
+		return holder.acquire(path, thor::Resources::fromFile<Resource>(path), thor::Resources::Reuse);
+	}
+	catch (const thor::ResourceLoadingException&)
+	{
+		return nullptr;
+	}
+}
+
+std::shared_ptr<sf::Font> ResourceCache::getFont(const std::string& path)
+{
+	return acquire(m_fonts, path);
+}
+
+std::shared_ptr<sf::Texture> ResourceCache::getTexture(const std::string& path)
+{
+	return acquire(m_textures, path);
+}
+
+bool ResourceCache::preloadFont(const std::string& path)
+{
+	std::shared_ptr<sf::Font> font = getFont(path);
+	if (!font)
+	{
+		return false;
+	}
+
+	m_preloadedFonts.push_back(std::move(font));
+	return true;
+}
+
+bool ResourceCache::preloadTexture(const std::string& path)
+{
+	std::shared_ptr<sf::Texture> texture = getTexture(path);
+	if (!texture)
+	{
+		return false;
+	}
+
+	m_preloadedTextures.push_back(std::move(texture));
+	return true;
+}
+
+void ResourceCache::releasePreloaded()
+{
+	m_preloadedFonts.clear();
+	m_preloadedTextures.clear();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "lib/thor/include/Thor/Resources/ResourceHolder.hpp"
+#include "tools/DesignPatterns/Singleton.h"
+
+
+// Fonts and textures shared by everything that draws, looked up by file path.
+// A file is loaded the first time it is asked for and stays loaded while
+// something holds it, so the widgets showing the same font share one sf::Font
+// and its glyph pages. A preloaded file stays loaded until releasePreloaded.
+class ResourceCache : public Singleton<ResourceCache>
+{
+    friend class Singleton<ResourceCache>;
+
+public:
+    // Null when the file cannot be loaded.
+    std::shared_ptr<sf::Font> getFont(const std::string& path);
+    std::shared_ptr<sf::Texture> getTexture(const std::string& path);
+
+    // Load now rather than on first use. False when the file cannot be loaded.
+    bool preloadFont(const std::string& path);
+    bool preloadTexture(const std::string& path);
+
+    // The preloaded files go once nothing else holds them.
+    void releasePreloaded();
+
+private:
+    ResourceCache() = default;
+
+    template<typename Resource>
+    using Holder = thor::ResourceHolder<Resource, std::string, thor::Resources::RefCounted>;
+
+    template<typename Resource>
+    static std::shared_ptr<Resource> acquire(Holder<Resource>& holder, const std::string& path);
+
+    Holder<sf::Font> m_fonts;
+    Holder<sf::Texture> m_textures;
+
+    std::vector<std::shared_ptr<sf::Font>> m_preloadedFonts;
+    std::vector<std::shared_ptr<sf::Texture>> m_preloadedTextures;
+};
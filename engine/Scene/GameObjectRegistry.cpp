@@ -0,0 +1,125 @@
+#include "GameObjectRegistry.h"
+
+#include "../GameObject/GameObject.h"
+
+GameObjectHandle GameObjectRegistry::spawn(std::shared_ptr<IGameObject> gameObject)
+{
+	GameObjectHandle handle;
+	if (!m_freeSlots.empty())
+	{
+		handle.index = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		handle.index = static_cast<uint32_t>(m_slots.size());
+		m_slots.push_back({ pending_dense, 0 });
+	}
+
+	Slot& slot = m_slots[handle.index];
+	slot.dense = pending_dense;
+	handle.generation = slot.generation;
+
+	gameObject->setHandle(handle);
+	m_pendingSpawns.emplace_back(handle, std::move(gameObject));
+	return handle;
+}
+
+void GameObjectRegistry::despawn(GameObjectHandle handle)
+{
+	if (isLive(handle))
+	{
+		m_pendingDespawns.push_back(handle);
+	}
+}
+
+void GameObjectRegistry::flush()
+{
+	if (!m_pendingSpawns.empty() || !m_pendingDespawns.empty())
+	{
+		++m_version;
+	}
+
+	for (auto& [handle, gameObject] : m_pendingSpawns)
+	{
+		m_slots[handle.index].dense = static_cast<uint32_t>(m_objects.size());
+		m_objects.push_back(std::move(gameObject));
+		m_objectSlots.push_back(handle.index);
+	}
+	m_pendingSpawns.clear();
+
+	for (GameObjectHandle handle : m_pendingDespawns)
+	{
+		// Already despawned earlier in the queue.
+		if (!isLive(handle))
+		{
+			continue;
+		}
+
+		Slot& slot = m_slots[handle.index];
+		const uint32_t dense = slot.dense;
+		const uint32_t last = static_cast<uint32_t>(m_objects.size()) - 1;
+
+		// Swap and pop.
+		m_objects[dense] = std::move(m_objects[last]);
+		m_objectSlots[dense] = m_objectSlots[last];
+		m_slots[m_objectSlots[dense]].dense = dense;
+		m_objects.pop_back();
+		m_objectSlots.pop_back();
+
+		slot.dense = pending_dense;
+		++slot.generation;
+		m_freeSlots.push_back(handle.index);
+	}
+	m_pendingDespawns.clear();
+}
+
+void GameObjectRegistry::clear()
+{
+	for (const auto& pendingSpawn : m_pendingSpawns)
+	{
+		m_objectSlots.push_back(pendingSpawn.first.index);
+	}
+	m_pendingSpawns.clear();
+	m_pendingDespawns.clear();
+
+	for (uint32_t slotIndex : m_objectSlots)
+	{
+		++m_slots[slotIndex].generation;
+		m_slots[slotIndex].dense = pending_dense;
+		m_freeSlots.push_back(slotIndex);
+	}
+	m_objects.clear();
+	m_objectSlots.clear();
+	++m_version;
+}
+
+IGameObject* GameObjectRegistry::get(GameObjectHandle handle) const
+{
+	if (!isLive(handle) || m_slots[handle.index].dense == pending_dense)
+	{
+		return nullptr;
+	}
+
+	return m_objects[m_slots[handle.index].dense].get();
+}
+
+const std::vector<std::shared_ptr<IGameObject>>& GameObjectRegistry::getObjects() const
+{
+	return m_objects;
+}
+
+size_t GameObjectRegistry::size() const
+{
+	return m_objects.size();
+}
+
+uint32_t GameObjectRegistry::getVersion() const
+{
+	return m_version;
+}
+
+bool GameObjectRegistry::isLive(GameObjectHandle handle) const
+{
+	return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+class IGameObject;
+
+// Stable reference to a scene object. It stays valid while other objects are
+// added and removed, and turns stale once its object is removed.
+struct GameObjectHandle
+{
+    static constexpr uint32_t invalid_index = UINT32_MAX;
+
+    uint32_t index = invalid_index;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != invalid_index; }
+    bool operator==(const GameObjectHandle& other) const = default;
+};
+
+// The objects of a scene in a dense array, addressed through handles.
+// Spawns and despawns are queued and applied by flush, at a frame boundary,
+// so the dense array never changes while the scene iterates it. A despawn
+// moves the last object into the hole, removing k objects costs O(k).
+class GameObjectRegistry
+{
+public:
+    // The handle is usable right away, the object joins the dense array on the next flush.
+    GameObjectHandle spawn(std::shared_ptr<IGameObject> gameObject);
+
+    // Despawning a stale handle or the same handle twice does nothing.
+    void despawn(GameObjectHandle handle);
+
+    // Apply the queued spawns then the queued despawns.
+    void flush();
+
+    // Remove everything now, queued commands included.
+    void clear();
+
+    // Null if the handle is stale or its object is not flushed in yet.
+    IGameObject* get(GameObjectHandle handle) const;
+
+    const std::vector<std::shared_ptr<IGameObject>>& getObjects() const;
+    size_t size() const;
+
+    // Changes each time flush or clear changes the dense array, for the caches built from it.
+    uint32_t getVersion() const;
+
+private:
+    static constexpr uint32_t pending_dense = UINT32_MAX;
+
+    struct Slot
+    {
+        uint32_t dense;
+        uint32_t generation;
+    };
+
+    bool isLive(GameObjectHandle handle) const;
+
+    // Dense objects and the slot each one lives in.
+    std::vector<std::shared_ptr<IGameObject>> m_objects;
+    std::vector<uint32_t> m_objectSlots;
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+
+    std::vector<std::pair<GameObjectHandle, std::shared_ptr<IGameObject>>> m_pendingSpawns;
+    std::vector<GameObjectHandle> m_pendingDespawns;
+
+    uint32_t m_version = 0;
+};
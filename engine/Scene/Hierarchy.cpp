@@ -0,0 +1,242 @@
+#include "Hierarchy.h"
+
+#include <cassert>
+
+HierarchyHandle Hierarchy::create(HierarchyHandle parent)
+{
+	const uint32_t parentIndex = isAlive(parent) ? parent.index : none;
+
+	uint32_t nodeIndex;
+	if (!m_freeNodes.empty())
+	{
+		nodeIndex = m_freeNodes.back();
+		m_freeNodes.pop_back();
+	}
+	else
+	{
+		nodeIndex = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.push_back({ 0, none, none, none, none, none });
+	}
+
+	Node& node = m_nodes[nodeIndex];
+	node.dense = static_cast<uint32_t>(m_denseNodes.size());
+	link(nodeIndex, parentIndex);
+
+	// Appended after its parent, the order stays valid.
+	const uint32_t parentDense = parentIndex != none ? m_nodes[parentIndex].dense : none;
+	m_denseNodes.push_back(nodeIndex);
+	m_denseParents.push_back(parentDense);
+	m_localTransforms.push_back(sf::Transform::Identity);
+	m_worldTransforms.push_back(parentDense != none ? m_worldTransforms[parentDense] : sf::Transform::Identity);
+
+	++m_size;
+	return getHandle(nodeIndex);
+}
+
+void Hierarchy::destroy(HierarchyHandle node)
+{
+	if (!isAlive(node))
+	{
+		return;
+	}
+
+	m_scratchNodes.clear();
+	forEachInSubtree(node, [this](HierarchyHandle descendant)
+	{
+		m_scratchNodes.push_back(descendant.index);
+	});
+
+	unlink(node.index);
+
+	for (uint32_t nodeIndex : m_scratchNodes)
+	{
+		Node& destroyed = m_nodes[nodeIndex];
+		++destroyed.generation;
+		destroyed.dense = none;
+		destroyed.parent = none;
+		destroyed.firstChild = none;
+		destroyed.nextSibling = none;
+		destroyed.previousSibling = none;
+		m_freeNodes.push_back(nodeIndex);
+	}
+	m_size -= m_scratchNodes.size();
+
+	// Their dense entries are dropped by the rebuild.
+	m_isOrderDirty = true;
+}
+
+void Hierarchy::setParent(HierarchyHandle node, HierarchyHandle parent)
+{
+	if (!isAlive(node))
+	{
+		return;
+	}
+
+	const uint32_t parentIndex = isAlive(parent) ? parent.index : none;
+
+#ifndef NDEBUG
+	// A parent in the subtree of the node would make a cycle, the node would be lost with all its subtree.
+	for (uint32_t ancestor = parentIndex; ancestor != none; ancestor = m_nodes[ancestor].parent)
+	{
+		assert(ancestor != node.index && "the parent is in the subtree of the node");
+	}
+#endif
+
+	unlink(node.index);
+	link(node.index, parentIndex);
+
+	if (m_isOrderDirty)
+	{
+		return;
+	}
+
+	// The descendants of the node already come after it, only the parent may be misplaced.
+	const uint32_t dense = m_nodes[node.index].dense;
+	const uint32_t parentDense = parentIndex != none ? m_nodes[parentIndex].dense : none;
+	if (parentDense == none || parentDense < dense)
+	{
+		m_denseParents[dense] = parentDense;
+	}
+	else
+	{
+		m_isOrderDirty = true;
+	}
+}
+
+HierarchyHandle Hierarchy::getParent(HierarchyHandle node) const
+{
+	if (!isAlive(node) || m_nodes[node.index].parent == none)
+	{
+		return {};
+	}
+
+	return getHandle(m_nodes[node.index].parent);
+}
+
+void Hierarchy::setLocalTransform(HierarchyHandle node, const sf::Transform& transform)
+{
+	assert(isAlive(node) && "stale or invalid hierarchy handle");
+	m_localTransforms[m_nodes[node.index].dense] = transform;
+}
+
+const sf::Transform& Hierarchy::getLocalTransform(HierarchyHandle node) const
+{
+	assert(isAlive(node) && "stale or invalid hierarchy handle");
+	return m_localTransforms[m_nodes[node.index].dense];
+}
+
+const sf::Transform& Hierarchy::getWorldTransform(HierarchyHandle node) const
+{
+	assert(isAlive(node) && "stale or invalid hierarchy handle");
+	return m_worldTransforms[m_nodes[node.index].dense];
+}
+
+void Hierarchy::propagate()
+{
+	if (m_isOrderDirty)
+	{
+		rebuild();
+	}
+
+	const size_t count = m_denseNodes.size();
+	for (size_t i = 0; i < count; ++i)
+	{
+		const uint32_t parentDense = m_denseParents[i];
+		m_worldTransforms[i] = parentDense != none ? m_worldTransforms[parentDense] * m_localTransforms[i] : m_localTransforms[i];
+	}
+}
+
+bool Hierarchy::isAlive(HierarchyHandle node) const
+{
+	return node.index < m_nodes.size() && m_nodes[node.index].generation == node.generation && m_nodes[node.index].dense != none;
+}
+
+size_t Hierarchy::size() const
+{
+	return m_size;
+}
+
+HierarchyHandle Hierarchy::getHandle(uint32_t nodeIndex) const
+{
+	return { nodeIndex, m_nodes[nodeIndex].generation };
+}
+
+uint32_t& Hierarchy::getFirstChild(uint32_t parent)
+{
+	return parent != none ? m_nodes[parent].firstChild : m_firstRoot;
+}
+
+void Hierarchy::link(uint32_t nodeIndex, uint32_t parent)
+{
+	Node& node = m_nodes[nodeIndex];
+	uint32_t& firstChild = getFirstChild(parent);
+
+	node.parent = parent;
+	node.previousSibling = none;
+	node.nextSibling = firstChild;
+	if (firstChild != none)
+	{
+		m_nodes[firstChild].previousSibling = nodeIndex;
+	}
+	firstChild = nodeIndex;
+}
+
+void Hierarchy::unlink(uint32_t nodeIndex)
+{
+	Node& node = m_nodes[nodeIndex];
+
+	if (node.previousSibling != none)
+	{
+		m_nodes[node.previousSibling].nextSibling = node.nextSibling;
+	}
+	else
+	{
+		getFirstChild(node.parent) = node.nextSibling;
+	}
+
+	if (node.nextSibling != none)
+	{
+		m_nodes[node.nextSibling].previousSibling = node.previousSibling;
+	}
+
+	node.parent = none;
+	node.nextSibling = none;
+	node.previousSibling = none;
+}
+
+// Breadth first from the roots, the order being built is the queue.
+void Hierarchy::rebuild()
+{
+	m_scratchNodes.clear();
+	for (uint32_t root = m_firstRoot; root != none; root = m_nodes[root].nextSibling)
+	{
+		m_scratchNodes.push_back(root);
+	}
+
+	for (size_t i = 0; i < m_scratchNodes.size(); ++i)
+	{
+		for (uint32_t child = m_nodes[m_scratchNodes[i]].firstChild; child != none; child = m_nodes[child].nextSibling)
+		{
+			m_scratchNodes.push_back(child);
+		}
+	}
+
+	const size_t count = m_scratchNodes.size();
+	m_scratchTransforms.resize(count);
+	m_denseParents.resize(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		Node& node = m_nodes[m_scratchNodes[i]];
+		m_scratchTransforms[i] = m_localTransforms[node.dense];
+
+		// The parent is placed already.
+		node.dense = static_cast<uint32_t>(i);
+		m_denseParents[i] = node.parent != none ? m_nodes[node.parent].dense : none;
+	}
+
+	m_denseNodes.swap(m_scratchNodes);
+	m_localTransforms.swap(m_scratchTransforms);
+	m_worldTransforms.resize(count);
+	m_isOrderDirty = false;
+}
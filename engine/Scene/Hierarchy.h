@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <SFML/Graphics/Transform.hpp>
+
+
+// Stable reference to a node of a hierarchy, stale once the node is destroyed.
+struct HierarchyHandle
+{
+    static constexpr uint32_t invalid_index = UINT32_MAX;
+
+    uint32_t index = invalid_index;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != invalid_index; }
+    bool operator==(const HierarchyHandle& other) const = default;
+};
+
+// The transform hierarchy of a scene, for what follows something else: HUD
+// elements over a character, effects on a bullet, ... The nodes are stored in
+// flat arrays where a parent always comes before its children, each node keeps
+// the index of its parent, so propagating the transforms is one linear pass.
+//
+// Creating a node appends it. Reparenting and destroying relink the node in O(1)
+// and mark the order dirty when a child could end up before its parent, the next
+// propagate then rebuilds the arrays in depth order in O(n). Nothing is allocated
+// once the arrays have reached their size.
+class Hierarchy
+{
+public:
+    // An invalid parent makes a root.
+    HierarchyHandle create(HierarchyHandle parent = {});
+
+    // Destroy the node and all its descendants.
+    void destroy(HierarchyHandle node);
+
+    // An invalid parent makes the node a root. The parent must not be in the subtree of node.
+    void setParent(HierarchyHandle node, HierarchyHandle parent);
+    HierarchyHandle getParent(HierarchyHandle node) const;
+
+    // The node must be alive.
+    void setLocalTransform(HierarchyHandle node, const sf::Transform& transform);
+    const sf::Transform& getLocalTransform(HierarchyHandle node) const;
+
+    // As of the last propagate.
+    const sf::Transform& getWorldTransform(HierarchyHandle node) const;
+
+    // Compute the world transform of every node from its local transform and its parent.
+    void propagate();
+
+    bool isAlive(HierarchyHandle node) const;
+    size_t size() const;
+
+    // Call function(handle) for node and its descendants, parents first, without
+    // recursion. The function must not change the hierarchy.
+    template<typename Function>
+    void forEachInSubtree(HierarchyHandle node, Function&& function) const;
+
+private:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    // Links of a node, addressed by its handle index.
+    struct Node
+    {
+        uint32_t generation;
+        uint32_t dense;
+        uint32_t parent;
+        uint32_t firstChild;
+        uint32_t nextSibling;
+        uint32_t previousSibling;
+    };
+
+    HierarchyHandle getHandle(uint32_t nodeIndex) const;
+    uint32_t& getFirstChild(uint32_t parent);
+    void link(uint32_t nodeIndex, uint32_t parent);
+    void unlink(uint32_t nodeIndex);
+    void rebuild();
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_freeNodes;
+    uint32_t m_firstRoot = none;
+    size_t m_size = 0;
+
+    // Dense arrays, a parent before its children.
+    std::vector<uint32_t> m_denseNodes;
+    std::vector<uint32_t> m_denseParents;
+    std::vector<sf::Transform> m_localTransforms;
+    std::vector<sf::Transform> m_worldTransforms;
+    bool m_isOrderDirty = false;
+
+    // Reused by destroy and rebuild.
+    std::vector<uint32_t> m_scratchNodes;
+    std::vector<sf::Transform> m_scratchTransforms;
+};
+
+
+template<typename Function>
+inline void Hierarchy::forEachInSubtree(HierarchyHandle node, Function&& function) const
+{
+    if (!isAlive(node))
+    {
+        return;
+    }
+
+    // Depth first through the links, climbing back with the parent indices.
+    const uint32_t root = node.index;
+    uint32_t current = root;
+    while (true)
+    {
+        function(getHandle(current));
+
+        if (m_nodes[current].firstChild != none)
+        {
+            current = m_nodes[current].firstChild;
+            continue;
+        }
+
+        while (current != root && m_nodes[current].nextSibling == none)
+        {
+            current = m_nodes[current].parent;
+        }
+
+        if (current == root)
+        {
+            break;
+        }
+        current = m_nodes[current].nextSibling;
+    }
+}
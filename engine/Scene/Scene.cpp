@@ -2,6 +2,7 @@
 
 #include "../Game/Game.h"
 #include "../GameObject/GameObject.h"
+#include "physicsEngine/dynamics/World.h"
 
 IScene::IScene() : m_window(Game::GetInstance()->getWindow())
 {
@@ -15,54 +16,88 @@ IScene::~IScene()
 
 const sf::Vector2i IScene::getMousePositionScreen()
 {
-	return sf::Mouse::getPosition();
+	return m_window->getPosition() + getMousePositionWindow();
 }
 
 const sf::Vector2i IScene::getMousePositionWindow()
 {
-	return sf::Mouse::getPosition(*m_window);
+	return Game::GetInstance()->getMousePosition();
 }
 
 const sf::Vector2f IScene::getMousePositionView()
 {
-	return m_window->mapPixelToCoords(sf::Mouse::getPosition(*m_window));
+	return m_window->mapPixelToCoords(getMousePositionWindow());
+}
+
+bool IScene::isMouseButtonPressed(sf::Mouse::Button button) const
+{
+	return Game::GetInstance()->isMouseButtonPressed(button);
 }
 
 void IScene::processInput(sf::Event& inputEvent)
 {
-	for (const auto& pGameObject : m_gameObjects)
-	{
-		pGameObject->processInput(inputEvent, *this);
-	}
+	processObjectsInput(inputEvent);
 }
 
 void IScene::update(const float& deltaTime)
 {
-	for (const auto& pGameObject : m_gameObjects)
+	// Frame boundary, objects spawned since the last update join the scene.
+	m_gameObjects.flush();
+
+	updateObjects(deltaTime);
+
+	// Objects despawned during the update leave before the render.
+	m_gameObjects.flush();
+
+	m_hierarchy.propagate();
+}
+
+void IScene::render()
+{
+	for (const auto& pGameObject : m_gameObjects.getObjects())
 	{
-		if (pGameObject)
-			pGameObject->update(deltaTime, *this);
+		pGameObject->render(m_renderer);
+	}
 
+	m_renderer.flush(*m_window);
+}
+
+
+void IScene::processObjectsInput(sf::Event& inputEvent)
+{
+	for (const auto& pGameObject : m_gameObjects.getObjects())
+	{
+		pGameObject->processInput(inputEvent, *this);
 	}
 }
 
-void IScene::render()
+void IScene::updateObjects(const float& deltaTime)
 {
-	for (const auto& pGameObject : m_gameObjects)
+	for (const auto& pGameObject : m_gameObjects.getObjects())
 	{
-		pGameObject->render(*m_window);
+		pGameObject->update(deltaTime, *this);
 	}
 }
 
 
-IGameObject* IScene::getGameObject(const size_t index)
+GameObjectHandle IScene::spawn(std::shared_ptr<IGameObject> gameObject)
+{
+	return m_gameObjects.spawn(std::move(gameObject));
+}
+
+void IScene::despawn(GameObjectHandle handle)
+{
+	m_gameObjects.despawn(handle);
+}
+
+IGameObject* IScene::getGameObject(GameObjectHandle handle) const
 {
-	return m_gameObjects.at(index).get();
+	return m_gameObjects.get(handle);
 }
 
-std::vector<std::shared_ptr<IGameObject>>& IScene::getGameObjects()
+const std::vector<std::shared_ptr<IGameObject>>& IScene::getGameObjects() const
 {
-	return m_gameObjects;
+	return m_gameObjects.getObjects();
 }
 
 void IScene::clearGameObjects()
@@ -70,13 +105,17 @@ void IScene::clearGameObjects()
 	m_gameObjects.clear();
 }
 
-void IScene::RemoveGameObject(IGameObject* game_object)
+World* IScene::getWorld()
 {
-	for (int i = m_gameObjects.size() - 1; i >= 0; --i)
-	{
-		if (m_gameObjects[i].get() == game_object)
-		{
-			m_gameObjects.erase(m_gameObjects.begin() + i);
-		}
-	}
+	return m_world.get();
+}
+
+Hierarchy& IScene::getHierarchy()
+{
+	return m_hierarchy;
+}
+
+BatchRenderer& IScene::getRenderer()
+{
+	return m_renderer;
 }
@@ -1,10 +1,16 @@
 #pragma once
 
 
+#include <memory>
+
 #include <SFML/Graphics.hpp>
 
+#include "GameObjectRegistry.h"
+#include "Hierarchy.h"
+#include "../Render/BatchRenderer.h"
 
 class IGameObject;
+class World;
 
 class IScene 
 {
@@ -12,34 +18,61 @@ public:
     IScene();
     virtual ~IScene();
 
+    // The mouse as the events given to the scenes left it, not the live one,
+    // so a replay sees the recorded mouse.
     virtual const sf::Vector2i getMousePositionScreen();
     virtual const sf::Vector2i getMousePositionWindow();
     virtual const sf::Vector2f getMousePositionView();
+    bool isMouseButtonPressed(sf::Mouse::Button button) const;
 
     virtual void processInput(sf::Event& inputEvent);
     virtual void update(const float& deltaTime);
+    // Adds the objects to the renderer and draws everything added this frame.
+    // A scene adds its own shapes and texts first, then calls IScene::render.
     virtual void render();
 
+    // Spawns and despawns are deferred to the next frame boundary, the
+    // objects can be added and removed from inside their own update.
+    GameObjectHandle spawn(std::shared_ptr<IGameObject> gameObject);
+    void despawn(GameObjectHandle handle);
+
     template <typename... Args>
     void addGameObjects(Args... gameObjects);
 
-    IGameObject* getGameObject(const size_t index);
+    IGameObject* getGameObject(GameObjectHandle handle) const;
 
-    std::vector<std::shared_ptr<IGameObject>>& getGameObjects();
+    const std::vector<std::shared_ptr<IGameObject>>& getGameObjects() const;
 
     void clearGameObjects();
 
-    void RemoveGameObject(IGameObject* game_object);
+    // The physics world of the scene, null for scenes without physics.
+    // Each scene owns its world so several simulations can run side by side.
+    World* getWorld();
+
+    // Transforms of what follows something else in the scene, propagated after each update.
+    Hierarchy& getHierarchy();
+
+    // Draw calls and vertices of the last frame are in its stats.
+    BatchRenderer& getRenderer();
 
 
 protected:
-    std::shared_ptr<sf::RenderWindow> m_window;
-    std::vector<std::shared_ptr<IGameObject>> m_gameObjects;
+    // Per-object passes of processInput and update, one virtual call per object.
+    // A scene that knows its object types can dispatch them statically instead.
+    virtual void processObjectsInput(sf::Event& inputEvent);
+    virtual void updateObjects(const float& deltaTime);
+
+    // Owned by the Game.
+    sf::RenderWindow* m_window;
+    GameObjectRegistry m_gameObjects;
+    Hierarchy m_hierarchy;
+    BatchRenderer m_renderer;
+    std::unique_ptr<World> m_world;
 };
 
 
 template<typename ...Args>
 inline void IScene::addGameObjects(Args ...gameObjects)
 {
-    (m_gameObjects.push_back(gameObjects), ...);
+    (spawn(gameObjects), ...);
 }
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <tuple>
+#include <typeinfo>
+#include <vector>
+
+#include "Scene.h"
+#include "../GameObject/GameObject.h"
+#include "../utils/Typelist/Typelist.h"
+
+
+// A scene that knows the concrete types of its objects. The objects whose exact
+// type is in Types are grouped in one array per type, rebuilt when the scene
+// objects change, and each group is processed by a loop over a single type:
+// the calls are resolved at compile time, with no indirect branch per object.
+// Objects of any other type keep the virtual path. Groups are processed in
+// the order of Types. Render is not grouped, it goes through the objects in
+// registry order, which a despawn reshuffles: the render layers, not the spawn
+// order, decide what is drawn over what. The types whose input component
+// ignores input get no events at all.
+template<typename Types>
+class TypedScene;
+
+template<typename... Types>
+class TypedScene<typelist<Types...>> : public IScene
+{
+protected:
+    void processObjectsInput(sf::Event& inputEvent) override
+    {
+        sortObjects();
+
+        for_each_type<typelist<Types...>>([&]<typename T>()
+        {
+            if constexpr (T::receives_input)
+            {
+                for (T* gameObject : std::get<std::vector<T*>>(m_groups))
+                {
+                    gameObject->processInputDirect(inputEvent, *this);
+                }
+            }
+        });
+
+        for (IGameObject* gameObject : m_others)
+        {
+            gameObject->processInput(inputEvent, *this);
+        }
+    }
+
+    void updateObjects(const float& deltaTime) override
+    {
+        sortObjects();
+
+        for_each_type<typelist<Types...>>([&]<typename T>()
+        {
+            for (T* gameObject : std::get<std::vector<T*>>(m_groups))
+            {
+                gameObject->updateDirect(deltaTime, *this);
+            }
+        });
+
+        for (IGameObject* gameObject : m_others)
+        {
+            gameObject->update(deltaTime, *this);
+        }
+    }
+
+private:
+    void sortObjects()
+    {
+        if (m_sortedVersion == m_gameObjects.getVersion())
+        {
+            return;
+        }
+        m_sortedVersion = m_gameObjects.getVersion();
+
+        (std::get<std::vector<Types*>>(m_groups).clear(), ...);
+        m_others.clear();
+
+        for (const auto& pGameObject : m_gameObjects.getObjects())
+        {
+            IGameObject* gameObject = pGameObject.get();
+            const std::type_info& type = typeid(*gameObject);
+
+            bool grouped = false;
+            for_each_type<typelist<Types...>>([&]<typename T>()
+            {
+                if (!grouped && type == typeid(T))
+                {
+                    std::get<std::vector<T*>>(m_groups).push_back(static_cast<T*>(gameObject));
+                    grouped = true;
+                }
+            });
+
+            if (!grouped)
+            {
+                m_others.push_back(gameObject);
+            }
+        }
+    }
+
+    std::tuple<std::vector<Types*>...> m_groups;
+    std::vector<IGameObject*> m_others;
+    uint32_t m_sortedVersion = UINT32_MAX;
+};
@@ -4,6 +4,9 @@
 #include <engine/utils/Math/Vector2.h>
 #include <iostream>
 
+#include "engine/Render/BatchRenderer.h"
+#include "engine/Resources/ResourceCache.h"
+
 #pragma once
 
 struct RectangleButton : public sf::RectangleShape
@@ -19,11 +22,13 @@ public:
 
         m_text.setString(text);
 
-        if (!m_font.loadFromFile("Assets/Game.ttf")) {
+        m_font = ResourceCache::GetInstance()->getFont("Assets/Game.ttf");
+        if (!m_font) {
             std::cout << "can't load font" << std::endl;
-        };
-
-        m_text.setFont(m_font);
+        }
+        else {
+            m_text.setFont(*m_font);
+        }
         m_text.setCharacterSize(24);
         m_text.setFillColor(sf::Color::White);
 
@@ -44,10 +49,16 @@ public:
         }
     }
 
-    void draw(sf::RenderTarget& renderTarget, sf::RenderStates state) const override {
-        renderTarget.draw(static_cast<sf::RectangleShape>(*this), state);
-        renderTarget.draw(m_text, state);
+    // The shape on layer and the text on layer + 2, as the HUD elements.
+    void submit(BatchRenderer& renderer, int layer) const {
+        renderer.addShape(layer, *this);
+        renderer.addText(layer + 2, m_text);
+    }
 
+    // On its own, the scenes submit it to their renderer instead.
+    void draw(sf::RenderTarget& renderTarget, sf::RenderStates state) const override {
+        submit(m_renderer, 0);
+        m_renderer.flush(renderTarget, state);
     }
 
     void setPosition(const FVector2 position){
@@ -71,10 +82,13 @@ private:
     std::function<void()> m_onClick;
 
     sf::Text m_text;
-    sf::Font m_font;
+    std::shared_ptr<sf::Font> m_font;
 
     FVector2 m_initialPosition;
 
+
+    // Used by draw(), its streams keep their memory from one call to the next.
+    mutable BatchRenderer m_renderer;
 };
 
 //std::vector<RectangleButton*> RectangleButton::rectButtonVect;
\ No newline at end of file
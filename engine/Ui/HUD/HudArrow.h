@@ -1,5 +1,8 @@
 #pragma once
 
+#include "engine/Render/BatchRenderer.h"
+#include "engine/Resources/ResourceCache.h"
+
 struct HudArrow : public sf::RectangleShape {
 
 public:
@@ -11,24 +14,31 @@ public:
 		setSize(sf::Vector2f(size.x, size.y));
 		setFillColor(color);
 
-		if (!m_texture.loadFromFile("Assets/WindArrow.png")) {
+		m_texture = ResourceCache::GetInstance()->getTexture("Assets/WindArrow.png");
+		if (!m_texture) {
 			std::cout << "can't load texture" << std::endl;
 		}
-
-		m_sprite.setTexture(m_texture);
-		m_sprite.setPosition(position.x, position.y);
-		m_sprite.setScale(size.x / m_texture.getSize().x, size.y / m_texture.getSize().y);
-		m_sprite.setOrigin(size.x / 2.0f, size.y / 2.0f);
+		else {
+			m_sprite.setTexture(*m_texture);
+			m_sprite.setPosition(position.x, position.y);
+			m_sprite.setScale(size.x / m_texture->getSize().x, size.y / m_texture->getSize().y);
+			m_sprite.setOrigin(size.x / 2.0f, size.y / 2.0f);
+		}
 
 	}
 
 	~HudArrow() = default;
 
+	// The shape on layer and the arrow on layer + 1.
+	void submit(BatchRenderer& renderer, int layer) const {
+		renderer.addShape(layer, *this);
+		renderer.addSprite(layer + 1, m_sprite);
+	}
+
+	// On its own, the scenes submit it to their renderer instead.
 	void draw(sf::RenderTarget& renderTarget, sf::RenderStates state) const override {
-		renderTarget.draw(static_cast<sf::RectangleShape>(*this), state);
-		if (m_sprite.getTexture() != nullptr) {
-			renderTarget.draw(m_sprite, state);
-		}
+		submit(m_renderer, 0);
+		m_renderer.flush(renderTarget, state);
 	}
 
 
@@ -60,7 +70,10 @@ public:
 
 private:
 
-	sf::Texture m_texture;
+	std::shared_ptr<sf::Texture> m_texture;
 	sf::Sprite m_sprite;
 	FVector2 m_initialPosition;
+
+	// Used by draw(), its streams keep their memory from one call to the next.
+	mutable BatchRenderer m_renderer;
 };
\ No newline at end of file
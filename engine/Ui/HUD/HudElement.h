@@ -7,6 +7,9 @@
 #include <iostream>
 #include <string>
 
+#include "engine/Render/BatchRenderer.h"
+#include "engine/Resources/ResourceCache.h"
+
 template<typename T>
 struct HudElement : public sf::RectangleShape {
 
@@ -22,21 +25,26 @@ public:
 
         m_textDisplayed.setString(std::to_string(*m_text));
 
-        if (!m_font.loadFromFile("Assets/Game.ttf")) {
+        m_font = ResourceCache::GetInstance()->getFont("Assets/Game.ttf");
+        if (!m_font) {
             std::cout << "can't load font" << std::endl;
-        };
-
-        m_textDisplayed.setFont(m_font);
+        }
+        else {
+            m_textDisplayed.setFont(*m_font);
+        }
         m_textDisplayed.setCharacterSize(24);
         m_textDisplayed.setFillColor(sf::Color::White);
 
         if (!texturePath.empty()) {
-            if (!m_texture.loadFromFile(texturePath)) {
+            m_texture = ResourceCache::GetInstance()->getTexture(texturePath);
+            if (!m_texture) {
                 std::cout << "can't load texture" << std::endl;
             }
-            m_sprite.setTexture(m_texture);
-            m_sprite.setPosition(position.x, position.y);
-            m_sprite.setScale(size.x / m_texture.getSize().x, size.y / m_texture.getSize().y);
+            else {
+                m_sprite.setTexture(*m_texture);
+                m_sprite.setPosition(position.x, position.y);
+                m_sprite.setScale(size.x / m_texture->getSize().x, size.y / m_texture->getSize().y);
+            }
         }
 
         //hudVector.push_back(*this);
@@ -44,15 +52,17 @@ public:
 
     ~HudElement() = default;
 
-    void draw(sf::RenderTarget& renderTarget, sf::RenderStates state) const override {
-        renderTarget.draw(static_cast<sf::RectangleShape>(*this), state);
-
-        if (m_sprite.getTexture() != nullptr) {
-            renderTarget.draw(m_sprite, state);
-        }
-
-        renderTarget.draw(m_textDisplayed, state);
+    // The shape on layer, the sprite on layer + 1 and the text on layer + 2.
+    void submit(BatchRenderer& renderer, int layer) const {
+        renderer.addShape(layer, *this);
+        renderer.addSprite(layer + 1, m_sprite);
+        renderer.addText(layer + 2, m_textDisplayed);
+    }
 
+    // On its own, the scenes submit it to their renderer instead.
+    void draw(sf::RenderTarget& renderTarget, sf::RenderStates state) const override {
+        submit(m_renderer, 0);
+        m_renderer.flush(renderTarget, state);
     }
 
 
@@ -82,12 +92,15 @@ private:
 
     T* m_text;
     sf::Text m_textDisplayed;
-    sf::Font m_font;
+    std::shared_ptr<sf::Font> m_font;
 
-    sf::Texture m_texture;
+    std::shared_ptr<sf::Texture> m_texture;
     sf::Sprite m_sprite;
 
     FVector2 m_initialPosition;
+
+    // Used by draw(), its streams keep their memory from one call to the next.
+    mutable BatchRenderer m_renderer;
 };
 
 //vector initialization
@@ -112,21 +125,26 @@ public:
 
         m_textDisplayed.setString(m_text);
 
-        if (!m_font.loadFromFile("Assets/Game.ttf")) {
+        m_font = ResourceCache::GetInstance()->getFont("Assets/Game.ttf");
+        if (!m_font) {
             std::cout << "can't load font" << std::endl;
-        };
-
-        m_textDisplayed.setFont(m_font);
+        }
+        else {
+            m_textDisplayed.setFont(*m_font);
+        }
         m_textDisplayed.setCharacterSize(24);
         m_textDisplayed.setFillColor(sf::Color::White);
 
         if (!texturePath.empty()) {
-            if (!m_texture.loadFromFile(texturePath)) {
+            m_texture = ResourceCache::GetInstance()->getTexture(texturePath);
+            if (!m_texture) {
                 std::cout << "can't load texture" << std::endl;
             }
-            m_sprite.setTexture(m_texture);
-            m_sprite.setPosition(position.x, position.y);
-            m_sprite.setScale(size.x / m_texture.getSize().x, size.y / m_texture.getSize().y);
+            else {
+                m_sprite.setTexture(*m_texture);
+                m_sprite.setPosition(position.x, position.y);
+                m_sprite.setScale(size.x / m_texture->getSize().x, size.y / m_texture->getSize().y);
+            }
         }
 
         //hudVector.push_back(*this);
@@ -134,14 +152,17 @@ public:
 
     ~HudElement() = default;
 
-    void draw(sf::RenderTarget& renderTarget, sf::RenderStates state) const override {
-        renderTarget.draw(static_cast<sf::RectangleShape>(*this), state);
-
-        if (m_sprite.getTexture() != nullptr) {
-            renderTarget.draw(m_sprite, state);
-        }
+    // The shape on layer, the sprite on layer + 1 and the text on layer + 2.
+    void submit(BatchRenderer& renderer, int layer) const {
+        renderer.addShape(layer, *this);
+        renderer.addSprite(layer + 1, m_sprite);
+        renderer.addText(layer + 2, m_textDisplayed);
+    }
 
-        renderTarget.draw(m_textDisplayed, state);
+    // On its own, the scenes submit it to their renderer instead.
+    void draw(sf::RenderTarget& renderTarget, sf::RenderStates state) const override {
+        submit(m_renderer, 0);
+        m_renderer.flush(renderTarget, state);
     }
 
 
@@ -175,12 +196,15 @@ public:
 private:
 
     std::string m_text;
-    sf::Font m_font;
+    std::shared_ptr<sf::Font> m_font;
 
-    sf::Texture m_texture;
+    std::shared_ptr<sf::Texture> m_texture;
     sf::Sprite m_sprite;
 
     FVector2 m_initialPosition;
+
+    // Used by draw(), its streams keep their memory from one call to the next.
+    mutable BatchRenderer m_renderer;
 };
 
 //vector initialization
@@ -7,6 +7,8 @@
 #include <iostream>
 #include <string>
 
+#include "engine/Render/BatchRenderer.h"
+
 #include "game/GameObjects/Character/Character.h"
 
 template<typename T>
@@ -25,8 +27,14 @@ public:
 
     ~HudEntityFixed() = default;
 
+    void submit(BatchRenderer& renderer, int layer) const {
+        renderer.addShape(layer, *this);
+    }
+
+    // On its own, the scenes submit it to their renderer instead.
     void draw(sf::RenderTarget& renderTarget, sf::RenderStates state) const override {
-        renderTarget.draw(static_cast<sf::RectangleShape>(*this), state);
+        submit(m_renderer, 0);
+        m_renderer.flush(renderTarget, state);
     }
 
     void setRelativePosition(const FVector2 position) {
@@ -59,3 +67,6 @@ private:
     FVector2 m_relativePosition;
     FVector2 m_initialPosition;
 };
+
+    // Used by draw(), its streams keep their memory from one call to the next.
+    mutable BatchRenderer m_renderer;
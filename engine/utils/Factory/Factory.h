@@ -1,8 +1,17 @@
 #pragma once
 #include "../Typelist/Typelist.h"
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 
+// Creates the types of ValidTypes, which can keep their constructors private and
+// befriend the factory. Arguments are forwarded to the constructor. A shared_ptr
+// factory puts the object and its control block in a single allocation, taken from
+// std::allocator or from the allocator given to allocate (a per-type pool, a
+// std::pmr::polymorphic_allocator over a scene resource, ...).
 template<typename ValidTypes, template<class...> class SmartPtrType = std::unique_ptr>
 class Factory
 {
@@ -12,10 +21,26 @@ public:
     using SmartPtr = SmartPtrType<T>;
 
     template<typename Type, typename... Args>
-    static SmartPtr<Type> create(Args... args)
+    static SmartPtr<Type> create(Args&&... args)
     {
-        return SmartPtr<typename Creator<Type>::type>(
-            new typename Creator<Type>::type(args...));
+        using T = typename Creator<Type>::type;
+        if constexpr (std::is_same_v<SmartPtr<T>, std::shared_ptr<T>>)
+        {
+            return allocate<Type>(std::allocator<T>(), std::forward<Args>(args)...);
+        }
+        else
+        {
+            return SmartPtr<T>(new T(std::forward<Args>(args)...));
+        }
+    };
+
+    // Same as create with the memory taken from allocator, which must outlive the object.
+    template<typename Type, typename Allocator, typename... Args>
+    static SmartPtr<Type> allocate(const Allocator& allocator, Args&&... args)
+    {
+        using T = typename Creator<Type>::type;
+        static_assert(std::is_same_v<SmartPtr<T>, std::shared_ptr<T>>, "Only a shared_ptr factory takes an allocator");
+        return std::allocate_shared<T>(ConstructingAllocator<T, Allocator>(allocator), std::forward<Args>(args)...);
     };
 
 private:
@@ -25,4 +50,58 @@ private:
         static_assert(contains_v<ValidTypes, Type>);
         using type = Type;
     };
-};
\ No newline at end of file
+
+    // Wraps an allocator so that the object is constructed from inside the factory,
+    // std::allocate_shared could not reach a private constructor otherwise.
+    template<typename T, typename Allocator>
+    struct ConstructingAllocator
+    {
+        using value_type = T;
+        using Inner = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = ConstructingAllocator<U, Allocator>;
+        };
+
+        explicit ConstructingAllocator(const Allocator& allocator) : inner(allocator)
+        {
+        }
+
+        template<typename U>
+        ConstructingAllocator(const ConstructingAllocator<U, Allocator>& other) : inner(other.inner)
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            return std::allocator_traits<Inner>::allocate(inner, n);
+        }
+
+        void deallocate(T* p, std::size_t n)
+        {
+            std::allocator_traits<Inner>::deallocate(inner, p, n);
+        }
+
+        template<typename U, typename... Args>
+        void construct(U* p, Args&&... args)
+        {
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+
+        template<typename U>
+        void destroy(U* p)
+        {
+            p->~U();
+        }
+
+        template<typename U>
+        bool operator==(const ConstructingAllocator<U, Allocator>& other) const
+        {
+            return inner == other.inner;
+        }
+
+        Inner inner;
+    };
+};
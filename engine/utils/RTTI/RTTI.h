@@ -1,78 +1,80 @@
 #pragma once
-#include <string>
+#include <cstddef>
+#include <cstdint>
 
+#include "../Typelist/Typelist.h"
+
+// Type information of a closed hierarchy. The root lists every type of the
+// hierarchy with DECLARE_RTTI_ROOT, each type then declares its parent with
+// DECLARE_RTTI. The id of a type is its index in the list and its mask has the
+// bits of the type and of all its ancestors, both computed at compile time, so
+// Is and As test a single bit. T must belong to the hierarchy of the object.
 class RTTI
 {
 public:
+	using TypeMask = uint64_t;
+
 	virtual size_t TypeIdInstance() const = 0;
 
-	virtual bool Is(const std::string& name) const
-	{
-		return false;
-	}
+	virtual TypeMask TypeMaskInstance() const = 0;
 
-	virtual bool Is(const size_t& id) const
+	bool Is(size_t id) const
 	{
-		return false;
+		return (TypeMaskInstance() & (TypeMask(1) << id)) != 0;
 	}
 
 	template<typename T>
-	T* As()
+	bool Is() const
 	{
-		return (Is(T::TypeIdClass())) ? static_cast<T*>(this) : nullptr;
+		return Is(T::TypeIdClass());
 	}
 
 	template<typename T>
-	T* As() const
-	{
-		return (Is(T::TypeIdClass())) ? static_cast<T*>(this) : nullptr;
-	}
-
-	virtual RTTI* QueryParent(const size_t& id)
+	T* As()
 	{
-		return nullptr;
+		return Is<T>() ? static_cast<T*>(this) : nullptr;
 	}
 
-	virtual RTTI* QueryParent(const size_t& id) const
+	template<typename T>
+	const T* As() const
 	{
-		return nullptr;
+		return Is<T>() ? static_cast<const T*>(this) : nullptr;
 	}
 };
 
-#define DECLARE_RTTI(ClassType, ParentType)								        	 \
+#define DEFINE_RTTI_TYPE(ClassType, ParentMask)									 \
 	public:																			 \
-		static const std::string TypeName()											 \
+		static constexpr const char* TypeName()										 \
 		{																			 \
-			return {#ClassType};													 \
+			return #ClassType;														 \
 		}																			 \
 																					 \
-		size_t TypeIdInstance() const override										 \
+		static constexpr size_t TypeIdClass()										 \
 		{																			 \
-			return ClassType::TypeIdClass();										 \
+			return index_of_v<RTTITypes, ClassType>;								 \
 		}																			 \
 																					 \
-		static const size_t TypeIdClass()											 \
+		static constexpr RTTI::TypeMask TypeMaskClass()								 \
 		{																			 \
-			static int id = 0;														 \
-			return (size_t)(&id);													 \
+			return (RTTI::TypeMask(1) << TypeIdClass()) | (ParentMask);				 \
 		}																			 \
 																					 \
-		bool Is(const size_t& id) const override									 \
-		{																			 \
-			return (id == TypeIdClass()) ? true : ParentType::Is(id);				 \
-		}																			 \
-																					 \
-		bool Is(const std::string& name) const override								 \
-		{																			 \
-			return (name == TypeName()) ? true : ParentType::Is(name);				 \
-		}																			 \
-																					 \
-		RTTI* QueryParent(const size_t& id) override								 \
+		size_t TypeIdInstance() const override										 \
 		{																			 \
-			return (id == TypeIdClass()) ? (RTTI*)this : ParentType::QueryParent(id);\
+			return ClassType::TypeIdClass();										 \
 		}																			 \
 																					 \
-		RTTI* QueryParent(const size_t& id) const override							 \
+		RTTI::TypeMask TypeMaskInstance() const override							 \
 		{																			 \
-			return (id == TypeIdClass()) ? (RTTI*)this : ParentType::QueryParent(id);\
+			return ClassType::TypeMaskClass();										 \
 		}																			 \
+
+// The types list is the remaining arguments, e.g. typelist<Shape, Circle, Box>.
+#define DECLARE_RTTI_ROOT(ClassType, ...)											 \
+	public:																			 \
+		using RTTITypes = __VA_ARGS__;												 \
+		static_assert(length_v<RTTITypes> <= 64, "A hierarchy has at most 64 types");\
+	DEFINE_RTTI_TYPE(ClassType, 0)
+
+#define DECLARE_RTTI(ClassType, ParentType)											 \
+	DEFINE_RTTI_TYPE(ClassType, ParentType::TypeMaskClass())
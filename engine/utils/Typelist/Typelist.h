@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 // Integral constant
 template<typename Type, Type Value>
@@ -108,4 +109,50 @@ struct contains<List, Type, false> : if_then_else_t<
 {};
 
 template<typename List, typename Type>
-static constexpr bool contains_v = contains<List, Type>::value;
\ No newline at end of file
+static constexpr bool contains_v = contains<List, Type>::value;
+
+// Length
+template<typename List>
+struct length;
+
+template<typename... Args>
+struct length<typelist<Args...>> : integral_constant<size_t, sizeof...(Args)>
+{};
+
+template<typename List>
+static constexpr size_t length_v = length<List>::value;
+
+// Index of, the type must be in the list
+template<typename List, typename Type>
+struct index_of;
+
+template<typename Type, typename... Tail>
+struct index_of<typelist<Type, Tail...>, Type> : integral_constant<size_t, 0>
+{};
+
+template<typename Head, typename... Tail, typename Type>
+struct index_of<typelist<Head, Tail...>, Type> : integral_constant<size_t, 1 + index_of<typelist<Tail...>, Type>::value>
+{};
+
+template<typename List, typename Type>
+static constexpr size_t index_of_v = index_of<List, Type>::value;
+
+// For each type, in order, call function.template operator()<Type>()
+template<typename List>
+struct for_each_type_impl;
+
+template<typename... Types>
+struct for_each_type_impl<typelist<Types...>>
+{
+	template<typename Function>
+	static void apply(Function& function)
+	{
+		(function.template operator()<Types>(), ...);
+	}
+};
+
+template<typename List, typename Function>
+void for_each_type(Function&& function)
+{
+	for_each_type_impl<List>::apply(function);
+}
\ No newline at end of file
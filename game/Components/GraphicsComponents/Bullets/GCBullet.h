@@ -1,12 +0,0 @@
-#pragma once
-
-#include "engine/Components/GraphicsComponent.h"
-
-
-class IGameObject;
-
-struct GCBullet : public IGraphicsComponent
-{
-	GCBullet();
-	void renderImplementation(IGameObject& gameObject, sf::RenderWindow& window) override;
-};
\ No newline at end of file
@@ -1,16 +1,17 @@
 #include "GCCharacter.h"
 
 #include "game/GameObjects/Character/Character.h"
+#include "game/GameObjects/RenderLayers.h"
 
 
 GCCharacter::GCCharacter()
 {
 }
 
-void GCCharacter::renderImplementation(IGameObject& gameObject, sf::RenderWindow& window)
+void GCCharacter::renderImplementation(IGameObject& gameObject, BatchRenderer& renderer)
 {
 	Character& character = static_cast<Character&>(gameObject);
 
 	character.m_boundingBox->setOrigin(character.m_boundingBox->getSize() / 2.f);
-	window.draw(*character.m_boundingBox);
+	renderer.addShape(OBJECT_RENDER_LAYER, *character.m_boundingBox);
 }
@@ -9,7 +9,7 @@ class IGameObject;
 struct GCCharacter : IGraphicsComponent
 {
 	GCCharacter();
-	virtual void renderImplementation(IGameObject& gameObject, sf::RenderWindow& window) override;
+	virtual void renderImplementation(IGameObject& gameObject, BatchRenderer& renderer) override;
 };
 
 #endif // GCCHARACTER_H
\ No newline at end of file
@@ -1,10 +1,10 @@
 #include "GCGround.h"
 #include "game/GameObjects/Ground.h"
+#include "game/GameObjects/RenderLayers.h"
 
-void GCGround::renderImplementation(IGameObject& gameObject, sf::RenderWindow& window) {
+// The concave shape of Thor is drawn on its own, it does not expose its triangles.
+void GCGround::renderImplementation(IGameObject& gameObject, BatchRenderer& renderer) {
 	const Ground& ground = static_cast<Ground&>(gameObject);
 
-	auto shape = ground.m_shape;
-
-	window.draw(ground.m_shape);
+	renderer.addDrawable(GROUND_RENDER_LAYER, ground.m_shape);
 }
\ No newline at end of file
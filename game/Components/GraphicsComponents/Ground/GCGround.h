@@ -6,5 +6,5 @@ class IGameObject;
 
 struct GCGround : IGraphicsComponent
 {
-	void renderImplementation(IGameObject& gameObject, sf::RenderWindow& window) override;
+	void renderImplementation(IGameObject& gameObject, BatchRenderer& renderer) override;
 };
\ No newline at end of file
@@ -1,16 +1,17 @@
 #include "GCButton.h"
 
 #include "../../../GameObjects/UI/Button.h"
+#include "../../../GameObjects/RenderLayers.h"
 
 
 GCButton::GCButton()
 {
 }
 
-void GCButton::renderImplementation(IGameObject& gameObject, sf::RenderWindow& window)
+void GCButton::renderImplementation(IGameObject& gameObject, BatchRenderer& renderer)
 {
 	Button& button = reinterpret_cast<Button&>(gameObject);
 
-	window.draw(button.getShape());
-	window.draw(button.getText());
+	renderer.addShape(MENU_RENDER_LAYER, button.getShape());
+	renderer.addText(MENU_RENDER_LAYER + 2, button.getText());
 }
@@ -9,7 +9,7 @@ class IGameObject;
 struct GCButton : IGraphicsComponent 
 {
 	GCButton();
-	virtual void renderImplementation(IGameObject& gameObject, sf::RenderWindow& window) override;
+	virtual void renderImplementation(IGameObject& gameObject, BatchRenderer& renderer) override;
 };
 
 #endif // GCEXAMPLEBUTTON_H
\ No newline at end of file
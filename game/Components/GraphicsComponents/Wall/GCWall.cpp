@@ -1,5 +1,6 @@
 #include "GCWall.h"
 
+#include "game/GameObjects/RenderLayers.h"
 #include "game/GameObjects/Wall.h"
 
 
@@ -7,10 +8,10 @@ GCWall::GCWall()
 {
 }
 
-void GCWall::renderImplementation(IGameObject& gameObject, sf::RenderWindow& window)
+void GCWall::renderImplementation(IGameObject& gameObject, BatchRenderer& renderer)
 {
 	Wall& wall = static_cast<Wall&>(gameObject);
 
 	wall.m_shape.setOrigin(wall.m_shape.getSize() / 2.f);
-	window.draw(wall.m_shape);
+	renderer.addShape(OBJECT_RENDER_LAYER, wall.m_shape);
 }
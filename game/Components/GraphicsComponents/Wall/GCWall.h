@@ -8,6 +8,6 @@ class IGameObject;
 struct GCWall : IGraphicsComponent
 {
 	GCWall();
-	virtual void renderImplementation(IGameObject& gameObject, sf::RenderWindow& window) override;
+	virtual void renderImplementation(IGameObject& gameObject, BatchRenderer& renderer) override;
 };
 
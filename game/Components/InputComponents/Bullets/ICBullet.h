@@ -1,12 +0,0 @@
-#pragma once
-
-#include "../../../../engine/Components/InputComponent.h"
-
-class IGameObject;
-
-
-struct ICBullet : IInputComponent
-{
-	ICBullet();
-	void processInputImplementation(IGameObject& gameObject, sf::Event& inputEvent, IScene& scene) override;
-};
\ No newline at end of file
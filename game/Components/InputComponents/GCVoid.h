@@ -9,7 +9,7 @@ class IGameObject;
 struct GCVoid : IGraphicsComponent
 {
 	GCVoid();
-	void renderImplementation(IGameObject& gameObject, sf::RenderWindow& window) override;
+	void renderImplementation(IGameObject& gameObject, BatchRenderer& renderer) override;
 };
 
 #endif // GCVOID_H
\ No newline at end of file
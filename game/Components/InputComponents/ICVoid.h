@@ -8,6 +8,8 @@ class IGameObject;
 
 struct ICVoid : IInputComponent
 {
+	static constexpr bool ignores_input = true;
+
 	ICVoid();
 	void processInputImplementation(IGameObject& gameObject, sf::Event& inputEvent, IScene& scene) override;
 };
@@ -20,7 +20,7 @@ void ICButton::processInputImplementation(IGameObject& gameObject, sf::Event& in
 	{
 		button.setButtonState(BUTTON_HOVER);
 
-		if (sf::Mouse::isButtonPressed(sf::Mouse::Left) || sf::Mouse::isButtonPressed(sf::Mouse::Right))
+		if (scene.isMouseButtonPressed(sf::Mouse::Left) || scene.isMouseButtonPressed(sf::Mouse::Right))
 		{
 			button.setButtonState(BUTTON_PRESSED);
 		}
@@ -8,7 +8,5 @@ PCCharacter::PCCharacter() : m_callbackIsCalled(false)
 
 void PCCharacter::updateImplementation(const float& deltaTime, IGameObject& gameObject, IScene& scene)
 {
-	Character& character = static_cast<Character&>(gameObject);
-
-	character.m_boundingBox->setPosition({ character.m_body->rb->GetPosition().x, character.m_body->rb->GetPosition().y });
+	// The bounding box is synced by GameScene from the world transform buffer.
 }
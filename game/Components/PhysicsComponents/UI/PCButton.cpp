@@ -1,6 +1,7 @@
 #include "PCButton.h"
 
 #include "../../../GameObjects/UI/Button.h"
+#include "engine/Scene/Scene.h"
 PCButton::PCButton() : m_callbackIsCalled(false)
 {
 }
@@ -11,7 +12,7 @@ void PCButton::updateImplementation(const float& deltaTime, IGameObject& gameObj
 
 	if (button.getButtonState() == BUTTON_PRESSED && !m_callbackIsCalled)
 	{
-		if (sf::Mouse::isButtonPressed(sf::Mouse::Left))
+		if (scene.isMouseButtonPressed(sf::Mouse::Left))
 		{
 			button.useOnLeftClick();
 		}
@@ -2,190 +2,305 @@
 #define EVENTMANAGER_H
 
 #include <SFML/Graphics.hpp>
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <vector>
 
 
-// Helper using for shorter types
-using EventCallback = std::function<void(const sf::Event& event)>;
+// Helper using for shorter types. A callback returns true to consume the event,
+// the callbacks after it do not see it.
+using EventCallback = std::function<bool(const sf::Event& event)>;
 
-template<typename T>
-using EventCallbackMap = std::unordered_map<T, EventCallback>;
+// Identifies a subscribed callback, to remove it.
+using EventSubscription = uint32_t;
 
 /*
-    This class handles subtyped events like keyboard or mouse events
-    The unpack function allows to get relevant information from the processed event
+    The callbacks subscribed to one event, or one key or button of an event, in
+    decreasing priority. Callbacks of the same priority run in subscription order.
+    A callback may subscribe and unsubscribe while the list runs, even from an
+    event it dispatches itself, the changes apply once the outermost dispatch is done.
 */
-template<typename T>
-class SubTypeManager
+class EventCallbackList
 {
 public:
-    SubTypeManager(std::function<T(const sf::Event&)> unpack) :
-        m_unpack(unpack)
-    {}
+    void add(EventSubscription id, int priority, EventCallback callback)
+    {
+        if (m_dispatchDepth > 0)
+        {
+            m_pendingAdds.push_back({ priority, id, std::move(callback) });
+            return;
+        }
+
+        insert({ priority, id, std::move(callback) });
+    }
+
+    void remove(EventSubscription id)
+    {
+        auto it = std::find_if(m_entries.begin(), m_entries.end(), [id](const Entry& entry) { return entry.id == id; });
+        if (it != m_entries.end())
+        {
+            if (m_dispatchDepth > 0)
+            {
+                // Skipped from now on, erased after the dispatch. The callback
+                // itself may be the one running.
+                it->isRemoved = true;
+                m_hasRemovals = true;
+            }
+            else
+            {
+                m_entries.erase(it);
+            }
+            return;
+        }
 
-    ~SubTypeManager() = default;
+        auto pending = std::find_if(m_pendingAdds.begin(), m_pendingAdds.end(), [id](const Entry& entry) { return entry.id == id; });
+        if (pending != m_pendingAdds.end())
+        {
+            m_pendingAdds.erase(pending);
+        }
+    }
 
-    void processEvent(const sf::Event& event) const
+    // Runs the callbacks until one consumes the event.
+    bool dispatch(const sf::Event& event)
     {
-        T sub_value = m_unpack(event);
-        auto it(m_callmap.find(sub_value));
-        if (it != m_callmap.end()) {
-            // Call its associated callback
-            (it->second)(event);
+        ++m_dispatchDepth;
+
+        bool consumed = false;
+        for (const Entry& entry : m_entries)
+        {
+            if (!entry.isRemoved && entry.callback(event))
+            {
+                consumed = true;
+                break;
+            }
         }
+
+        // A nested dispatch leaves the changes to the one that is still iterating.
+        if (--m_dispatchDepth == 0)
+        {
+            applyPendingChanges();
+        }
+        return consumed;
     }
 
-    void addCallback(const T& sub_value, EventCallback callback)
+    bool empty() const
     {
-        m_callmap[sub_value] = callback;
+        return m_entries.empty();
     }
 
 private:
-    EventCallbackMap<T> m_callmap;
-    std::function<T(const sf::Event&)> m_unpack;
+    struct Entry
+    {
+        int priority;
+        EventSubscription id;
+        EventCallback callback;
+        bool isRemoved = false;
+    };
+
+    void insert(Entry entry)
+    {
+        auto it = std::upper_bound(m_entries.begin(), m_entries.end(), entry.priority,
+            [](int priority, const Entry& other) { return priority > other.priority; });
+        m_entries.insert(it, std::move(entry));
+    }
+
+    void applyPendingChanges()
+    {
+        if (m_hasRemovals)
+        {
+            std::erase_if(m_entries, [](const Entry& entry) { return entry.isRemoved; });
+            m_hasRemovals = false;
+        }
+
+        for (Entry& entry : m_pendingAdds)
+        {
+            insert(std::move(entry));
+        }
+        m_pendingAdds.clear();
+    }
+
+    std::vector<Entry> m_entries;
+    std::vector<Entry> m_pendingAdds;
+    int m_dispatchDepth = 0;
+    bool m_hasRemovals = false;
 };
 
 
+/*
+    The callbacks of every event, in tables indexed by the event type and by the
+    key or mouse button, so an event only reaches the callbacks subscribed to it.
+    The callbacks of the key or button run before the callbacks of the whole event type.
+*/
 class EventMap
 {
 public:
-    EventMap(bool use_builtin_helpers = true)
-        : m_key_pressed_manager([](const sf::Event& event) {return event.key.code; })
-        , m_key_released_manager([](const sf::Event& event) {return event.key.code; })
-        , m_mouse_pressed_manager([](const sf::Event& event) {return event.mouseButton.button; })
-        , m_mouse_released_manager([](const sf::Event& event) {return event.mouseButton.button; })
-    {
-        if (use_builtin_helpers) {
-            // Register key events built in callbacks
-            this->addEventCallback(sf::Event::EventType::KeyPressed, [&](const sf::Event& event) {m_key_pressed_manager.processEvent(event); });
-            this->addEventCallback(sf::Event::EventType::KeyReleased, [&](const sf::Event& event) {m_key_released_manager.processEvent(event); });
-            this->addEventCallback(sf::Event::EventType::MouseButtonPressed, [&](const sf::Event& event) {m_mouse_pressed_manager.processEvent(event); });
-            this->addEventCallback(sf::Event::EventType::MouseButtonReleased, [&](const sf::Event& event) {m_mouse_released_manager.processEvent(event); });
-        }
-    }
+    EventMap() = default;
+
+    // The subscriptions point into the tables of this map, a copy or a move would leave them behind.
+    EventMap(const EventMap&) = delete;
+    EventMap(EventMap&&) = delete;
+    EventMap& operator=(const EventMap&) = delete;
+    EventMap& operator=(EventMap&&) = delete;
 
     // Attaches new callback to an event
-    void addEventCallback(sf::Event::EventType type, EventCallback callback)
+    EventSubscription addEventCallback(sf::Event::EventType type, EventCallback callback, int priority = 0)
     {
-        m_events_callmap[type] = callback;
+        return subscribe(m_event_callbacks[type], std::move(callback), priority);
     }
 
     // Adds a key pressed callback
-    void addKeyPressedCallback(sf::Keyboard::Key key_code, EventCallback callback)
+    EventSubscription addKeyPressedCallback(sf::Keyboard::Key key_code, EventCallback callback, int priority = 0)
     {
-        m_key_pressed_manager.addCallback(key_code, callback);
+        return subscribe(m_key_pressed_callbacks[key_code], std::move(callback), priority);
     }
 
     // Adds a key released callback
-    void addKeyReleasedCallback(sf::Keyboard::Key key_code, EventCallback callback)
+    EventSubscription addKeyReleasedCallback(sf::Keyboard::Key key_code, EventCallback callback, int priority = 0)
     {
-        m_key_released_manager.addCallback(key_code, callback);
+        return subscribe(m_key_released_callbacks[key_code], std::move(callback), priority);
     }
 
     // Adds a mouse pressed callback
-    void addMousePressedCallback(sf::Mouse::Button button, EventCallback callback)
+    EventSubscription addMousePressedCallback(sf::Mouse::Button button, EventCallback callback, int priority = 0)
     {
-        m_mouse_pressed_manager.addCallback(button, callback);
+        return subscribe(m_mouse_pressed_callbacks[button], std::move(callback), priority);
     }
 
     // Adds a mouse released callback
-    void addMouseReleasedCallback(sf::Mouse::Button button, EventCallback callback)
+    EventSubscription addMouseReleasedCallback(sf::Mouse::Button button, EventCallback callback, int priority = 0)
     {
-        m_mouse_released_manager.addCallback(button, callback);
+        return subscribe(m_mouse_released_callbacks[button], std::move(callback), priority);
     }
 
-    // Runs the callback associated with an event
-    void executeCallback(const sf::Event& e, EventCallback fallback = nullptr) const
+    // Removes a callback
+    void removeCallback(EventSubscription id)
     {
-        auto it(m_events_callmap.find(e.type));
-        if (it != m_events_callmap.end()) {
-            // Call its associated callback
-            (it->second)(e);
-        }
-        else if (fallback) {
-            fallback(e);
+        if (id < m_subscriptions.size() && m_subscriptions[id])
+        {
+            m_subscriptions[id]->remove(id);
+            m_subscriptions[id] = nullptr;
         }
     }
 
-    // Removes a callback
-    void removeCallback(sf::Event::EventType type)
+    // Runs the callbacks associated with an event, returns true if one consumed it
+    bool executeCallback(const sf::Event& e)
     {
-        // If event type is registred
-        auto it(m_events_callmap.find(type));
-        if (it != m_events_callmap.end()) {
-            // Remove its associated callback
-            m_events_callmap.erase(it);
+        EventCallbackList* sub_callbacks = getSubCallbacks(e);
+        if (sub_callbacks && sub_callbacks->dispatch(e))
+        {
+            return true;
         }
+
+        return e.type < sf::Event::Count && m_event_callbacks[e.type].dispatch(e);
     }
 
 private:
-    SubTypeManager<sf::Keyboard::Key> m_key_pressed_manager;
-    SubTypeManager<sf::Keyboard::Key> m_key_released_manager;
-    SubTypeManager<sf::Mouse::Button> m_mouse_pressed_manager;
-    SubTypeManager<sf::Mouse::Button> m_mouse_released_manager;
-    EventCallbackMap<sf::Event::EventType> m_events_callmap;
+    EventSubscription subscribe(EventCallbackList& callbacks, EventCallback callback, int priority)
+    {
+        const EventSubscription id = static_cast<EventSubscription>(m_subscriptions.size());
+        m_subscriptions.push_back(&callbacks);
+        callbacks.add(id, priority, std::move(callback));
+        return id;
+    }
+
+    EventCallbackList* getSubCallbacks(const sf::Event& e)
+    {
+        switch (e.type)
+        {
+        case sf::Event::KeyPressed:
+            return isKnownKey(e.key.code) ? &m_key_pressed_callbacks[e.key.code] : nullptr;
+        case sf::Event::KeyReleased:
+            return isKnownKey(e.key.code) ? &m_key_released_callbacks[e.key.code] : nullptr;
+        case sf::Event::MouseButtonPressed:
+            return isKnownButton(e.mouseButton.button) ? &m_mouse_pressed_callbacks[e.mouseButton.button] : nullptr;
+        case sf::Event::MouseButtonReleased:
+            return isKnownButton(e.mouseButton.button) ? &m_mouse_released_callbacks[e.mouseButton.button] : nullptr;
+        default:
+            return nullptr;
+        }
+    }
+
+    static bool isKnownKey(sf::Keyboard::Key key_code)
+    {
+        return key_code >= 0 && key_code < sf::Keyboard::KeyCount;
+    }
+
+    static bool isKnownButton(sf::Mouse::Button button)
+    {
+        return button >= 0 && button < sf::Mouse::ButtonCount;
+    }
+
+    std::array<EventCallbackList, sf::Event::Count> m_event_callbacks;
+    std::array<EventCallbackList, sf::Keyboard::KeyCount> m_key_pressed_callbacks;
+    std::array<EventCallbackList, sf::Keyboard::KeyCount> m_key_released_callbacks;
+    std::array<EventCallbackList, sf::Mouse::ButtonCount> m_mouse_pressed_callbacks;
+    std::array<EventCallbackList, sf::Mouse::ButtonCount> m_mouse_released_callbacks;
+
+    // The list of each subscription, null once removed.
+    std::vector<EventCallbackList*> m_subscriptions;
 };
 
 
 /*
     This class handles any type of event and call its associated callbacks if any.
-    To process key event in a more convenient way its using a KeyManager
 */
 class EventManager
 {
 public:
-    EventManager(std::shared_ptr<sf::RenderWindow> window, bool use_builtin_helpers = true) :
-        m_window(window),
-        m_event_map(use_builtin_helpers)
+    EventManager(std::shared_ptr<sf::RenderWindow> window) :
+        m_window(window)
     {
     }
 
-    // Calls events' attached callbacks
-    void processEvents(EventCallback fallback = nullptr) const
+    // Calls events' attached callbacks, the fallback gets the events nobody consumed
+    void processEvents(std::function<void(const sf::Event&)> fallback = nullptr)
     {
         // Iterate over events
         sf::Event event;
         while (m_window->pollEvent(event)) {
-            m_event_map.executeCallback(event, fallback);
+            if (!m_event_map.executeCallback(event) && fallback) {
+                fallback(event);
+            }
         }
     }
 
     // Attaches new callback to an event
-    void addEventCallback(sf::Event::EventType type, EventCallback callback)
+    EventSubscription addEventCallback(sf::Event::EventType type, EventCallback callback, int priority = 0)
     {
-        m_event_map.addEventCallback(type, callback);
+        return m_event_map.addEventCallback(type, std::move(callback), priority);
     }
 
     // Removes a callback
-    void removeCallback(sf::Event::EventType type)
+    void removeCallback(EventSubscription id)
     {
-        m_event_map.removeCallback(type);
+        m_event_map.removeCallback(id);
     }
 
     // Adds a key pressed callback
-    void addKeyPressedCallback(sf::Keyboard::Key key, EventCallback callback)
+    EventSubscription addKeyPressedCallback(sf::Keyboard::Key key, EventCallback callback, int priority = 0)
     {
-        m_event_map.addKeyPressedCallback(key, callback);
+        return m_event_map.addKeyPressedCallback(key, std::move(callback), priority);
     }
 
     // Adds a key released callback
-    void addKeyReleasedCallback(sf::Keyboard::Key key, EventCallback callback)
+    EventSubscription addKeyReleasedCallback(sf::Keyboard::Key key, EventCallback callback, int priority = 0)
     {
-        m_event_map.addKeyReleasedCallback(key, callback);
+        return m_event_map.addKeyReleasedCallback(key, std::move(callback), priority);
     }
 
     // Adds a mouse pressed callback
-    void addMousePressedCallback(sf::Mouse::Button button, EventCallback callback)
+    EventSubscription addMousePressedCallback(sf::Mouse::Button button, EventCallback callback, int priority = 0)
     {
-        m_event_map.addMousePressedCallback(button, callback);
+        return m_event_map.addMousePressedCallback(button, std::move(callback), priority);
     }
 
     // Adds a mouse released callback
-    void addMouseReleasedCallback(sf::Mouse::Button button, EventCallback callback)
+    EventSubscription addMouseReleasedCallback(sf::Mouse::Button button, EventCallback callback, int priority = 0)
     {
-        m_event_map.addMouseReleasedCallback(button, callback);
+        return m_event_map.addMouseReleasedCallback(button, std::move(callback), priority);
     }
 
     std::shared_ptr<sf::RenderWindow>& getWindow()
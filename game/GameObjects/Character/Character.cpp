@@ -1,13 +1,22 @@
 #include "game/GameObjects/Character/Character.h"
+#include "game/GameObjects/CollisionLayers.h"
 
 constexpr int window_height = 1080;
 
 
-Character::Character(Vec2 pos, sf::Keyboard::Key left, sf::Keyboard::Key right, int index): left(left), right(right), index(index)
+Character::Character(World* world, Vec2 pos, sf::Keyboard::Key left, sf::Keyboard::Key right, int index)
 {
-	m_body = EntityFactory::create<RectEntity>(Vec2{ 40.f,  40.f }, pos, BodyType::dynamicBody);
+	m_control.left = left;
+	m_control.right = right;
+	m_control.index = index;
+
+	m_body = EntityFactory::create<RectEntity>(world, Vec2{ 40.f,  40.f }, pos, dynamicBody, GetCharacterLayer(index));
+	m_character = m_body->rb->GetFixtureList().front();
 	m_boundingBox = new sf::RectangleShape({ m_body->size.x, m_body->size.y });
-	m_startJumping = false;
+	m_boundingBox->setPosition({ pos.x, pos.y });
+
+	// The scene moves the bounding box from the world transform buffer.
+	m_body->rb->SetUserData(GetCharacterBodyId(index));
 	m_health = 100.f;
 	m_maxHealth = 100.f;
 
@@ -23,6 +32,11 @@ const float Character::getMaxHealth()
 	return m_maxHealth;
 }
 
+const Fixture* Character::getFixture() const
+{
+	return m_character;
+}
+
 void Character::takeDamage(float damage)
 {
 	m_health -= damage;
@@ -1,28 +1,29 @@
 #pragma once
 
-#include "game/Components/InputComponents/Character/ICCharacter.h"
+#include <cstdint>
+
+#include "game/Components/InputComponents/ICVoid.h"
 #include "game/Components/PhysicsComponents/Character/PCCharacter.h"
 #include "game/Components/GraphicsComponents/Character/GCCharacter.h"
 #include "engine/GameObject/GameObject.h"
 #include "engine/Entity/RectEntity.h"
+#include "game/Systems/CharacterSystems.h"
 
-class Character : public GameObject<ICCharacter, PCCharacter, GCCharacter>, Entity {
+// Its input goes through the keys the scene subscribes for it, see GameScene::registerEvents.
+class Character : public GameObject<ICVoid, PCCharacter, GCCharacter>, Entity {
 
 public:
-	Character(Vec2 pos, sf::Keyboard::Key left, sf::Keyboard::Key right, int index);
+	Character(World* world, Vec2 pos, sf::Keyboard::Key left, sf::Keyboard::Key right, int index);
 	~Character() override = default;
 
 	void takeDamage(float damage);
 	const float getHealth();
 	const float getMaxHealth();
+	const Fixture* getFixture() const;
 
 	std::shared_ptr<RectEntity> m_body;
 	sf::RectangleShape* m_boundingBox;
-	sf::Keyboard::Key left;
-	sf::Keyboard::Key right;
-	bool m_isJumping;
-	bool m_startJumping;
-	int index;
+	CharacterControl m_control;
 
 protected:
 
@@ -34,3 +35,14 @@ protected:
 
 };
 
+// User data of the body of the character of a player, exported with the moved
+// transforms. Zero is the body of nobody, hence the offset.
+inline uintptr_t GetCharacterBodyId(int playerIndex)
+{
+	return uintptr_t(playerIndex) + 1;
+}
+
+inline int GetCharacterIndex(uintptr_t bodyId)
+{
+	return int(bodyId) - 1;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "physicsEngine/dynamics/World.h"
+
+// Collision layers of the game objects, one per player for the characters and
+// their bullets so a shot never hits its shooter.
+enum CollisionLayersEnum {
+	GROUND_LAYER,
+	WALL_LAYER,
+	CHARACTER_1_LAYER,
+	CHARACTER_2_LAYER,
+	BULLET_1_LAYER,
+	BULLET_2_LAYER,
+	FRAGMENT_LAYER
+};
+
+inline int GetCharacterLayer(int playerIndex)
+{
+	return playerIndex == 0 ? CHARACTER_1_LAYER : CHARACTER_2_LAYER;
+}
+
+inline int GetBulletLayer(int playerIndex)
+{
+	return playerIndex == 0 ? BULLET_1_LAYER : BULLET_2_LAYER;
+}
+
+inline void SetupCollisionLayers(World& world)
+{
+	world.SetLayerCollision(BULLET_1_LAYER, CHARACTER_1_LAYER, false);
+	world.SetLayerCollision(BULLET_2_LAYER, CHARACTER_2_LAYER, false);
+	world.SetLayerCollision(FRAGMENT_LAYER, FRAGMENT_LAYER, false);
+}
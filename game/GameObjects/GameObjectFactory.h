@@ -1,9 +1,8 @@
 #pragma once
 #include "../../engine/utils/Factory/Factory.h"
 struct Ground;
-struct Bullet;
 struct Character;
 struct Wall;
 
-using AvailableGOTypes = typelist<Ground, Bullet, Character, Wall>;
+using AvailableGOTypes = typelist<Ground, Character, Wall>;
 using GameObjectFactory = Factory<AvailableGOTypes, std::shared_ptr>;
\ No newline at end of file
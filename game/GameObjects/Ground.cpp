@@ -1,9 +1,10 @@
 #include "Ground.h"
+#include "CollisionLayers.h"
 
 #include <iostream>
 
-Ground::Ground(std::vector<Vec2>& vertices, Vec2& position) {
-	m_body = EntityFactory::create<PolygonEntity>(vertices, position);
+Ground::Ground(World* world, std::vector<Vec2>& vertices, Vec2& position) {
+	m_body = EntityFactory::create<PolygonEntity>(world, vertices, position, GROUND_LAYER);
 	thor::ConcaveShape concaveShape;
 
 	concaveShape.setPointCount(vertices.size());
@@ -14,7 +14,7 @@
 
 struct Ground : GameObject<GCGround, PCVoid, ICVoid>
 {
-	Ground(std::vector<Vec2>& vertices, Vec2& position);
+	Ground(World* world, std::vector<Vec2>& vertices, Vec2& position);
 	~Ground() override = default;
 
 
@@ -0,0 +1,13 @@
+#pragma once
+
+// Render layers of the game, drawn in increasing order. A HUD element takes its
+// layer and the two next ones, for its shape, its sprite and its text, so the
+// layers are spaced out.
+enum RenderLayersEnum {
+	PANEL_RENDER_LAYER = 0,
+	GROUND_RENDER_LAYER = 10,
+	OBJECT_RENDER_LAYER = 20,
+	BULLET_RENDER_LAYER = 30,
+	HUD_RENDER_LAYER = 40,
+	MENU_RENDER_LAYER = 50
+};
@@ -1,5 +1,7 @@
 #include "Button.h"
 
+#include "engine/Resources/ResourceCache.h"
+
 Button::Button(float x, float y, float width, float height, std::function<void(Button* button)> const& onLeftClick) :
 	m_buttonState(BUTTON_IDLE), m_idleColor(sf::Color::White), m_hoverColor(sf::Color::White), m_pressedColor(sf::Color::White), m_callbackOnLeftClick(onLeftClick), m_callbackOnRightClick(nullptr)
 {
@@ -19,11 +21,12 @@ Button::Button(float x, float y, float width, float height, std::string text, sf
 	initShape(x, y, width, height);
 
 
-	if (!m_font.loadFromFile("assets/fonts/Doom2016Text.ttf")) {
+	m_font = ResourceCache::GetInstance()->getFont("assets/fonts/Doom2016Text.ttf");
+	if (!m_font) {
 		throw("ERROR::BUTTTON::COULD NOT LOAD FONT");
 	}
 
-	m_text.setFont(m_font);
+	m_text.setFont(*m_font);
 
 	m_text.setString(text);
 	m_text.setFillColor(sf::Color::White);
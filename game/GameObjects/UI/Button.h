@@ -2,6 +2,7 @@
 #define BUTTON_H
 
 #include <functional>
+#include <memory>
 
 #include "game/Components/InputComponents/ICVoid.h"
 #include "game/Components/PhysicsComponents/PCvoid.h"
@@ -41,7 +42,7 @@ protected:
 
 	sf::RectangleShape m_shape;
 	sf::Text m_text;
-	sf::Font m_font;
+	std::shared_ptr<sf::Font> m_font;
 
 
 	sf::Color m_idleColor;
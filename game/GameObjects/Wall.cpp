@@ -1,7 +1,8 @@
 #include "Wall.h"
+#include "CollisionLayers.h"
 
-Wall::Wall(Vec2& size, Vec2& position) {
-    m_body = EntityFactory::create<RectEntity>(size, position, staticBody);
+Wall::Wall(World* world, Vec2& size, Vec2& position) {
+    m_body = EntityFactory::create<RectEntity>(world, size, position, b2_staticBody, WALL_LAYER);
 
     m_shape = sf::RectangleShape{ {size.x, size.y } };
     m_shape.setPosition({ position.x, position.y });
@@ -12,7 +12,7 @@
 
 struct Wall : GameObject<GCWall, PCVoid, ICVoid>
 {
-	Wall(Vec2& size, Vec2& position);
+	Wall(World* world, Vec2& size, Vec2& position);
 	~Wall() override = default;
 
 
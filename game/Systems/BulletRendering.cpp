@@ -0,0 +1,21 @@
+#include "BulletRendering.h"
+
+#include "game/GameObjects/RenderLayers.h"
+#include "physicsEngine/dynamics/Body.h"
+
+constexpr int bullet_segments = 12;
+
+void RenderBullets(const BulletArchetype& bullets, BatchRenderer& renderer)
+{
+	const std::vector<BulletBody>& bodies = bullets.column<BulletBody>();
+	const std::vector<BulletShape>& shapes = bullets.column<BulletShape>();
+
+	for (size_t i = 0; i < bullets.size(); ++i)
+	{
+		const Vec2 position = bodies[i].body->GetPosition();
+		const float radius = shapes[i].radius;
+
+		// Placed like the sf::CircleShape it replaces, whose origin is its top left corner.
+		renderer.addCircle(BULLET_RENDER_LAYER, sf::Vector2f(position.x + radius, position.y + radius), radius, sf::Color::White, bullet_segments);
+	}
+}
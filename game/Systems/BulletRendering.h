@@ -0,0 +1,7 @@
+#pragma once
+
+#include "engine/Render/BatchRenderer.h"
+#include "game/Systems/BulletSystems.h"
+
+// Add every bullet to the stream of the bullet layer.
+void RenderBullets(const BulletArchetype& bullets, BatchRenderer& renderer);
@@ -0,0 +1,179 @@
+#include "BulletSystems.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "engine/Entity/CircleEntity.h"
+#include "engine/utils/Math/Common.h"
+#include "game/GameObjects/CollisionLayers.h"
+#include "game/Utils/Utils.h"
+#include "physicsEngine/dynamics/World.h"
+
+static float GetBulletRadius(bool isFragmentation)
+{
+	return isFragmentation ? 2.f : 5.f;
+}
+
+static Body* CreateBulletBody(World* world, Vec2 position, bool isFragmentation, int shooterIndex)
+{
+	int layer = isFragmentation ? FRAGMENT_LAYER : GetBulletLayer(shooterIndex);
+	Body* body = CircleEntity::CreateBody(world, GetBulletRadius(isFragmentation), position, dynamicBody, layer);
+	// Shells are small and fast, they are the only bodies that need continuous collision.
+	body->SetBullet(true);
+	return body;
+}
+
+static void PlaceAtRest(Body* body, Vec2 position)
+{
+	body->SetTransform(position, 0.f);
+	body->SetLinearVelocity(Vec2_zero);
+	body->SetAngularVelocity(0.f);
+}
+
+void BulletPool::reserve(World* world, int shellCount, int fragmentCount)
+{
+	for (int shooterIndex = 0; shooterIndex < 2; ++shooterIndex)
+	{
+		for (int i = 0; i < shellCount; ++i)
+		{
+			Body* body = CreateBulletBody(world, Vec2_zero, false, shooterIndex);
+			body->SetEnabled(false);
+			m_shells[shooterIndex].push_back(body);
+		}
+	}
+
+	for (int i = 0; i < fragmentCount; ++i)
+	{
+		Body* body = CreateBulletBody(world, Vec2_zero, true, 0);
+		body->SetEnabled(false);
+		m_fragments.push_back(body);
+	}
+}
+
+std::vector<Body*>& BulletPool::getFreeBodies(bool isFragmentation, int shooterIndex)
+{
+	return isFragmentation ? m_fragments : m_shells[shooterIndex];
+}
+
+Body* BulletPool::acquire(World* world, Vec2 position, bool isFragmentation, int shooterIndex)
+{
+	std::vector<Body*>& freeBodies = getFreeBodies(isFragmentation, shooterIndex);
+	if (freeBodies.empty())
+	{
+		return CreateBulletBody(world, position, isFragmentation, shooterIndex);
+	}
+
+	Body* body = freeBodies.back();
+	freeBodies.pop_back();
+
+	PlaceAtRest(body, position);
+	body->SetEnabled(true);
+	return body;
+}
+
+void BulletPool::release(Body* body, bool isFragmentation, int shooterIndex)
+{
+	body->SetEnabled(false);
+	getFreeBodies(isFragmentation, shooterIndex).push_back(body);
+}
+
+void BulletPool::dropDebris(World* world, Vec2 position)
+{
+	if (m_debris.size() < max_inert_fragments)
+	{
+		m_debris.push_back(acquire(world, position, true));
+		return;
+	}
+
+	Body* body = m_debris[m_nextDebris];
+	m_nextDebris = (m_nextDebris + 1) % m_debris.size();
+
+	PlaceAtRest(body, position);
+	body->SetAwake(true);
+}
+
+EntityHandle SpawnBullet(BulletArchetype& bullets, BulletPool& pool, World* world, Vec2 position, bool isFragmentation, int shooterIndex)
+{
+	Body* body = pool.acquire(world, position, isFragmentation, shooterIndex);
+	return bullets.create({ body, isFragmentation, shooterIndex }, { GetBulletRadius(isFragmentation) });
+}
+
+EntityHandle FireShell(BulletArchetype& bullets, BulletPool& pool, World* world, const Body* shooter, float shooterWidth, int shooterIndex, float angle, float power)
+{
+	const Vec2 shooterPosition = shooter->GetPosition();
+	EntityHandle shell = SpawnBullet(bullets, pool, world, shooterPosition, false, shooterIndex);
+	Body* body = bullets.get<BulletBody>(shell).body;
+
+	const float angleToShoot = angle * PI / 180;
+	const float offset = shooterWidth + GetBulletRadius(false);
+	const Vec2 direction(std::cos(angleToShoot), std::sin(angleToShoot));
+
+	body->SetTransform(Vec2(shooterPosition.x + offset * direction.x, shooterPosition.y + offset * direction.y), 0.f);
+	body->SetFixedRotation(true);
+	body->SetGravityScale(0.3f);
+	body->SetAngularVelocity(0.f);
+	body->SetLinearVelocity(Vec2(direction.x * power, direction.y * power));
+	return shell;
+}
+
+void UpdateBullets(BulletArchetype& bullets, const BulletContext& context, float damage[2])
+{
+	World& world = *context.world;
+
+	std::vector<const Body*> touched;
+	CollectTouchedBodies(world, touched);
+
+	const float windAngle = context.windAngle * PI / 180;
+	const Vec2 wind(std::cos(windAngle) * context.windForce, std::sin(windAngle) * context.windForce);
+
+	// Fragments are appended past count, they take part from the next frame on.
+	const size_t count = bullets.size();
+	for (size_t i = 0; i < count; ++i)
+	{
+		const BulletBody bullet = bullets.column<BulletBody>()[i];
+		if (!std::binary_search(touched.begin(), touched.end(), bullet.body))
+		{
+			bullet.body->ApplyForceToCenter(wind, true);
+			continue;
+		}
+
+		const Vec2 bulletPosition = bullet.body->GetPosition();
+		for (int j = 0; j < 2; ++j)
+		{
+			float distance = Distance(bulletPosition, context.characters[j]->GetPosition());
+			damage[j] += GetBlastDamage(distance, bullet.isFragmentation);
+		}
+
+		context.pool->release(bullet.body, bullet.isFragmentation, bullet.shooterIndex);
+		bullets.destroy(bullets.getHandle(i));
+
+		if (bullet.isFragmentation)
+		{
+			continue;
+		}
+
+		for (int j = 0; j < 4; ++j)
+		{
+			float angleToShoot = (-70 - 10 * j) * PI / 180;
+
+			EntityHandle fragment = SpawnBullet(bullets, *context.pool, &world, Vec2(bulletPosition.x - 2 * j, bulletPosition.y - 10 * j), true);
+			bullets.get<BulletBody>(fragment).body->SetLinearVelocity(Vec2(std::cos(angleToShoot) * 100, std::sin(angleToShoot) * 200));
+
+			// The game has always left an inert fragment at the impact as well.
+			context.pool->dropDebris(&world, bulletPosition);
+		}
+	}
+}
+
+void ReleaseBullets(BulletArchetype& bullets, BulletPool& pool)
+{
+	// The bullets destroyed by an update are back in the pool already.
+	bullets.flush();
+
+	for (const BulletBody& bullet : bullets.column<BulletBody>())
+	{
+		pool.release(bullet.body, bullet.isFragmentation, bullet.shooterIndex);
+	}
+	bullets.clear();
+}
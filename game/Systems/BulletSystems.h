@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+
+#include "engine/ECS/Archetype.h"
+#include "physicsEngine/common/Math.h"
+
+// The bullet simulation builds without SFML, the headless targets (server,
+// benchmark) run the same systems as the game. RenderBullets is in BulletRendering.h.
+
+class Body;
+class World;
+
+// Bodies a scene reserves up front, enough fragments for a few volleys bursting at once.
+constexpr int reserved_shells = 4;
+constexpr int reserved_fragments = 128;
+
+// Physics state of a bullet. Fragments do not burst again.
+struct BulletBody
+{
+	Body* body;
+	bool isFragmentation;
+	int shooterIndex;
+};
+
+// Render state of a bullet.
+struct BulletShape
+{
+	float radius;
+};
+
+using BulletArchetype = Archetype<BulletBody, BulletShape>;
+
+// Bullet bodies created up front and kept disabled while unused, so firing and
+// bursting only re-enable and move a body. There is one list of shells per
+// shooter, their layers differ, and one list of fragments. When a list runs
+// out a new body is created.
+class BulletPool
+{
+public:
+	void reserve(World* world, int shellCount, int fragmentCount);
+
+	// An enabled body at rest at position.
+	Body* acquire(World* world, Vec2 position, bool isFragmentation, int shooterIndex = 0);
+
+	// Disable the body and keep it for the next acquire.
+	void release(Body* body, bool isFragmentation, int shooterIndex = 0);
+
+	// Leave an inert fragment at position. Once max_inert_fragments lie around,
+	// the oldest one is moved here instead of taking a new body.
+	void dropDebris(World* world, Vec2 position);
+
+private:
+	std::vector<Body*>& getFreeBodies(bool isFragmentation, int shooterIndex);
+
+	std::vector<Body*> m_shells[2];
+	std::vector<Body*> m_fragments;
+
+	// Ring of the inert fragments, m_nextDebris is the oldest once the ring is full.
+	std::vector<Body*> m_debris;
+	size_t m_nextDebris = 0;
+};
+
+// What the bullet systems read from the scene.
+struct BulletContext
+{
+	World* world;
+	BulletPool* pool;
+	const Body* characters[2];
+	float windAngle;
+	float windForce;
+};
+
+// Create a bullet at rest, the caller launches it.
+EntityHandle SpawnBullet(BulletArchetype& bullets, BulletPool& pool, World* world, Vec2 position, bool isFragmentation, int shooterIndex = 0);
+
+// Fire a shell from a character: placed just outside the shooter along the angle,
+// in degrees, and launched at power.
+EntityHandle FireShell(BulletArchetype& bullets, BulletPool& pool, World* world, const Body* shooter, float shooterWidth, int shooterIndex, float angle, float power);
+
+// The bullets that started touching something explode: they burst into fragments
+// and are destroyed on the next flush, their bodies go back to the pool. The blast
+// damage to each character is added to damage, the caller applies it. The others
+// are pushed by the wind.
+void UpdateBullets(BulletArchetype& bullets, const BulletContext& context, float damage[2]);
+
+// Send every bullet back to the pool at once, e.g. when a turn ends with bullets still flying.
+void ReleaseBullets(BulletArchetype& bullets, BulletPool& pool);
@@ -0,0 +1,64 @@
+#include "CharacterSystems.h"
+
+#include "physicsEngine/dynamics/Body.h"
+#include "physicsEngine/dynamics/ContactEvents.h"
+
+void ProcessCharacterInput(CharacterControl& control, Body* body, const sf::Event& inputEvent, int playerIndexToPlay)
+{
+	if (control.index != playerIndexToPlay) return;
+
+	if (inputEvent.type == sf::Event::KeyPressed && inputEvent.key.code == control.left) {
+
+		body->SetFixedRotation(true);
+		body->SetLinearVelocity(Vec2{ -10.f , -1.f});
+		body->SetGravityScale(3.f);
+
+	}
+	else if (inputEvent.type == sf::Event::KeyPressed && inputEvent.key.code == control.right) {
+
+		body->SetFixedRotation(true);
+		body->SetLinearVelocity(Vec2{ 10.f , -1.f });
+		body->SetGravityScale(3.f);
+
+	}
+	if (inputEvent.type == sf::Event::KeyReleased) 
+	{
+		body->SetLinearVelocity(Vec2{ 0.f , 5.f });
+		if (inputEvent.key.code == sf::Keyboard::Enter)
+		{
+			control.startJumping = false;
+		}
+	}
+	if (!control.isJumping && inputEvent.type == sf::Event::KeyPressed && inputEvent.key.code == sf::Keyboard::Enter) {
+		control.isJumping = true;
+		control.startJumping = true;
+		body->SetFixedRotation(true);
+		body->SetLinearVelocity(Vec2{ 0.f , -200.f });
+		body->SetGravityScale(.5f);
+
+	}
+}
+
+static void AddTouches(const Fixture* fixtureA, const Fixture* fixtureB, int touches, CharacterControl* const controls[], const Fixture* const fixtures[], int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		if (fixtures[i] == fixtureA || fixtures[i] == fixtureB)
+		{
+			controls[i]->touchCount += touches;
+		}
+	}
+}
+
+void CountCharacterContacts(const ContactEvents& events, CharacterControl* const controls[], const Fixture* const fixtures[], int count)
+{
+	for (const ContactBeginTouchEvent& event : events.beginEvents)
+	{
+		AddTouches(event.fixtureA, event.fixtureB, 1, controls, fixtures, count);
+	}
+
+	for (const ContactEndTouchEvent& event : events.endEvents)
+	{
+		AddTouches(event.fixtureA, event.fixtureB, -1, controls, fixtures, count);
+	}
+}
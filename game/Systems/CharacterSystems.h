@@ -0,0 +1,28 @@
+#pragma once
+
+#include <SFML/Window/Event.hpp>
+
+class Body;
+class Fixture;
+struct ContactEvents;
+
+// Input state of a character.
+struct CharacterControl
+{
+	sf::Keyboard::Key left;
+	sf::Keyboard::Key right;
+	int index;
+	bool isJumping = false;
+	bool startJumping = false;
+
+	// Contacts the character touches something with, kept from the contact events.
+	int touchCount = 0;
+};
+
+// Move or jump the character of the player whose turn it is.
+void ProcessCharacterInput(CharacterControl& control, Body* body, const sf::Event& inputEvent, int playerIndexToPlay);
+
+// Count the contacts the characters begin and end during the last world step, in one
+// pass over the contact events. Only the character fixtures are compared, the other
+// fixture of an end event may be destroyed.
+void CountCharacterContacts(const ContactEvents& events, CharacterControl* const controls[], const Fixture* const fixtures[], int count);
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "engine/Entity/PolygonEntity.h"
+#include "engine/Entity/RectEntity.h"
+#include "game/GameObjects/CollisionLayers.h"
+#include "game/Utils/Utils.h"
+
+// The bodies of the GameScene level without their graphics, shared by the
+// headless targets (server, benchmark) so they simulate the same world as the game.
+
+constexpr float level_width = 1920.f;
+constexpr float level_height = 1080.f;
+constexpr float level_gravity = 9.81f;
+
+struct LevelBodies
+{
+    std::shared_ptr<RectEntity> characters[2];
+    std::shared_ptr<PolygonEntity> ground;
+    std::shared_ptr<RectEntity> walls[2];
+};
+
+// Same layout as the GameScene constructor, the terrain comes from the seed.
+inline LevelBodies CreateLevelBodies(World* world, unsigned seed)
+{
+    SetupCollisionLayers(*world);
+
+    LevelBodies level;
+
+    const Vec2 character_1_start_pos = { 150.f, level_height - 500 };
+    const Vec2 character_2_start_pos = { level_width - 150, level_height - 500 };
+    level.characters[0] = EntityFactory::create<RectEntity>(world, Vec2{ 40.f, 40.f }, character_1_start_pos, dynamicBody, GetCharacterLayer(0));
+    level.characters[1] = EntityFactory::create<RectEntity>(world, Vec2{ 40.f, 40.f }, character_2_start_pos, dynamicBody, GetCharacterLayer(1));
+
+    std::vector<Vec2> vertices;
+    GenerateFloorVertex({ 0.f, 200.f }, { level_width, 200.f }, 10, vertices, seed);
+    level.ground = EntityFactory::create<PolygonEntity>(world, vertices, Vec2(0, level_height - 200), GROUND_LAYER);
+
+    level.walls[0] = EntityFactory::create<RectEntity>(world, Vec2{ 10.f, 10000000.f }, Vec2{ 1.f, 0.f }, b2_staticBody, WALL_LAYER);
+    level.walls[1] = EntityFactory::create<RectEntity>(world, Vec2{ 10.f, 10000000.f }, Vec2{ level_width - 1.f, 0.f }, b2_staticBody, WALL_LAYER);
+
+    return level;
+}
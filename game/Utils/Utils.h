@@ -1,5 +1,10 @@
 #pragma once
+#include <algorithm>
+#include <vector>
+
 #include "tools/PerlinNoise.h"
+#include "physicsEngine/dynamics/World.h"
+#include "physicsEngine/dynamics/Fixture.h"
 
 template<typename T>
 T MapValue(T value, T fromLow, T fromHigh, T toLow, T toHigh) {
@@ -27,17 +32,15 @@ constexpr float max = 100.f;
 constexpr float n = 10;
 
 
-inline void GenerateFloorVertex(Vec2 start, Vec2 end, int number_of_points, std::vector<Vec2>& vertices)
+// Same terrain for the same seed, used to replay a match.
+inline void GenerateFloorVertex(Vec2 start, Vec2 end, int number_of_points, std::vector<Vec2>& vertices, unsigned seed)
 {
     vertices.reserve(number_of_points + 2);
     vertices.emplace_back(0.f, 0.f);
     vertices.emplace_back(end.x, 0.f);
     vertices.emplace_back(end.x, -end.y);
 
-    srand((unsigned)time(NULL));
-    int my_rand = rand();
-
-    const siv::PerlinNoise perlin{ static_cast<siv::BasicPerlinNoise<double>::seed_type>(my_rand) };
+    const siv::PerlinNoise perlin{ static_cast<siv::BasicPerlinNoise<double>::seed_type>(seed) };
 
     for (int i = number_of_points - 2; i >= 1; --i)
     {
@@ -50,3 +53,42 @@ inline void GenerateFloorVertex(Vec2 start, Vec2 end, int number_of_points, std:
     vertices.emplace_back(0.f, -start.y);
 
 }
+
+inline void GenerateFloorVertex(Vec2 start, Vec2 end, int number_of_points, std::vector<Vec2>& vertices)
+{
+    srand((unsigned)time(NULL));
+    int my_rand = rand();
+
+    GenerateFloorVertex(start, end, number_of_points, vertices, static_cast<unsigned>(my_rand));
+}
+
+// Every shell leaves inert fragments at its impact, only the latest ones stay in the
+// world, the older ones are moved to the new impacts.
+constexpr int max_inert_fragments = 32;
+
+// Damage of an explosion at the given distance of a character, zero when out of reach.
+inline float GetBlastDamage(float distance, bool isFragmentation)
+{
+    const float min_damage = isFragmentation ? 5.f : 25.f;
+    const float max_damage = isFragmentation ? 50.f : 10.f;
+    const float reach = isFragmentation ? 50.f : 100.f;
+    if (distance > reach)
+    {
+        return 0.f;
+    }
+
+    return MapValue(distance, 0.f, 100.f, max_damage, min_damage);
+}
+
+// The bodies that started touching something during the last world step, sorted
+// so each body is looked up with a binary search.
+inline void CollectTouchedBodies(const World& world, std::vector<const Body*>& touched)
+{
+    touched.clear();
+    for (const ContactBeginTouchEvent& event : world.GetContactEvents().beginEvents)
+    {
+        touched.push_back(event.fixtureA->GetBody());
+        touched.push_back(event.fixtureB->GetBody());
+    }
+    std::sort(touched.begin(), touched.end());
+}
@@ -1,22 +1,79 @@
 #include <iostream>
 #include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <string>
 #include <engine/Game/Game.h>
+#include <engine/Resources/ResourceCache.h>
 
 #include "Scenes/StartScene.h"
 #include "scenes/GameScene.h"
 #include "Scenes/SceneEnum.h"
 
 
-int main()
+// ballistic-project [--record file]
+// ballistic-project --replay file [--headless] [--timings file.csv]
+int main(int argc, char** argv)
 {
+    std::string recordPath;
+    std::string replayPath;
+    std::string timingsPath;
+    bool headless = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (arg == "--timings" && i + 1 < argc)
+            timingsPath = argv[++i];
+        else if (arg == "--headless")
+            headless = true;
+    }
+
+    // Everything random in a match derives from this seed, a replay reuses the recorded one.
+    InputRecording recording;
+    unsigned seed = static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count());
+    if (!replayPath.empty())
+    {
+        if (!recording.load(replayPath))
+            return 1;
+        seed = recording.getSeed();
+    }
+    srand(seed);
+
+    // Loaded once for all the widgets of the scenes.
+    ResourceCache* resources = ResourceCache::GetInstance();
+    resources->preloadFont("Assets/Game.ttf");
+    resources->preloadTexture("Assets/Background.jpg");
+    resources->preloadTexture("Assets/WindArrow.png");
+    resources->preloadTexture("Assets/WoodenTexture.png");
+
     Game* game = Game::GetInstance();
     game->addScenes(new StartScene());
     game->addScenes(new GameScene());
 
     game->setCurrentScene(ScenesEnum::START_SCENE);
 
+    if (!replayPath.empty())
+    {
+        std::ofstream timings;
+        if (!timingsPath.empty())
+            timings.open(timingsPath);
+
+        game->replay(recording, headless, timings.is_open() ? &timings : nullptr, sf::VideoMode(1920, 1080), "ballistic-project", sf::Style::Resize);
+        return 0;
+    }
+
+    if (!recordPath.empty())
+        game->startRecording(seed);
+
     game->run(sf::VideoMode(1920, 1080), "ballistic-project", sf::Style::Resize);
 
+    if (!recordPath.empty())
+        game->getRecording()->save(recordPath);
+
     return 0;
 }
-
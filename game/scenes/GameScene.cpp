@@ -12,12 +12,14 @@
 #include "engine/Entity/Entity.h"
 #include "engine/Entity/CircleEntity.h"
 #include "engine/Entity/RectEntity.h"
-#include "game/GameObjects/Bullet.h"
 #include <game/GameObjects/GameObjectFactory.h>
 #include <game/Utils/Utils.h>
 
 #include "game/GameObjects/Wall.h"
+#include "game/GameObjects/CollisionLayers.h"
+#include "game/GameObjects/RenderLayers.h"
 #include "game/GameObjects/Character/Character.h"
+#include "game/Systems/BulletRendering.h"
 
 
 constexpr int window_width = 1920;
@@ -52,34 +54,38 @@ GameScene::GameScene() {
 
 	time = 30.f;
 
+	m_world = std::make_unique<World>(Vec2(0.f, 9.81f));
+	SetupCollisionLayers(*m_world);
+	m_bulletPool.reserve(m_world.get(), reserved_shells, reserved_fragments);
+
 	const Vec2 character_1_start_pos = { 150.f, window_height - 500 };
-	player1 = GameObjectFactory::create<Character>(character_1_start_pos, sf::Keyboard::Q, sf::Keyboard::D, 0);
+	player1 = GameObjectFactory::create<Character>(m_world.get(), character_1_start_pos, sf::Keyboard::Q, sf::Keyboard::D, 0);
 
 	addGameObjects(player1);
 
 	Vec2 character_2_start_pos = { window_width - 150, window_height - 500 };
-	player2 = GameObjectFactory::create<Character>(character_2_start_pos, sf::Keyboard::Left, sf::Keyboard::Right, 1);
+	player2 = GameObjectFactory::create<Character>(m_world.get(), character_2_start_pos, sf::Keyboard::Left, sf::Keyboard::Right, 1);
 
 	lifeBar1 = UiFactory::create < HudEntityFixed < float>>(FVector2(-50.f, 50.f), FVector2(100.f, 10.f), sf::Color(191, 109, 33, 255), player1);
 	lifeBar2 = UiFactory::create < HudEntityFixed < float>>(FVector2(-50.f, 50.f), FVector2(100.f, 10.f), sf::Color(191, 109, 33, 255), player2);
 
 	addGameObjects(player2);
 
-	m_world = World::GetWorld();
-
 	std::vector<Vec2> vertices;
-	GenerateFloorVertex({ 0.f, 200.f }, { window_width , 200.f }, 10, vertices);
-	m_platform = GameObjectFactory::create<Ground>(vertices, Vec2(0, window_height - 200));
+	// The terrain seed comes from the game RNG so a recorded match replays on the same terrain.
+	GenerateFloorVertex({ 0.f, 200.f }, { window_width , 200.f }, 10, vertices, static_cast<unsigned>(rand()));
+	m_platform = GameObjectFactory::create<Ground>(m_world.get(), vertices, Vec2(0, window_height - 200));
 	addGameObjects(m_platform);
 
-	auto m_wall = GameObjectFactory::create<Wall>(Vec2{ 10.f, 10000000.f }, Vec2{ 1.f, 0.f });
+	auto m_wall = GameObjectFactory::create<Wall>(m_world.get(), Vec2{ 10.f, 10000000.f }, Vec2{ 1.f, 0.f });
 	addGameObjects(m_wall);
-	auto m_wall2 = GameObjectFactory::create<Wall>(Vec2{ 10.f, 10000000.f }, Vec2{ window_width - 1.f, 0.f });
+	auto m_wall2 = GameObjectFactory::create<Wall>(m_world.get(), Vec2{ 10.f, 10000000.f }, Vec2{ window_width - 1.f, 0.f });
 	addGameObjects(m_wall2);
 
 	m_currentCharacter = player1;
 	displaymenu = false;
 	initButtons();
+	registerEvents();
 }
 
 void goToMenu() {
@@ -119,57 +125,83 @@ void GameScene::NextPlayer()
 	canShoot = true;
 }
 
-void GameScene::processInput(sf::Event& inputEvent) {
-
-	if (inputEvent.KeyPressed && inputEvent.key.code == sf::Keyboard::N)
-	{
-		time = 0.5f;
-	}
+void GameScene::registerEvents()
+{
+	// The menu is drawn over the match, its clicks go no further.
+	const int menu_priority = 10;
 
-	if (canShoot == true && inputEvent.KeyPressed && inputEvent.key.code == sf::Keyboard::Space) {
-		canShoot = false;
+	m_eventMap.addMouseReleasedCallback(sf::Mouse::Left, [this](const sf::Event& event) {
+		if (!displaymenu)
+			return false;
 
+		// From the event rather than the live mouse, so a replay clicks the same place.
+		FVector2 mousePosition = FVector2(event.mouseButton.x, event.mouseButton.y);
+		startButton->handleClick(mousePosition);
+		exitButton->handleClick(mousePosition);
+		return true;
+	}, menu_priority);
 
-		std::shared_ptr<Bullet> bullet = GameObjectFactory::create<Bullet>(shootingAngle, Vec2{ m_currentCharacter->m_body->rb->GetPosition().x, m_currentCharacter->m_body->rb->GetPosition().y });
-		float angleToShoot = bullet->angle * PI / 180;
+	m_eventMap.addKeyPressedCallback(sf::Keyboard::N, [this](const sf::Event&) {
+		time = 0.5f;
+		return false;
+	});
 
-		float point_x = m_currentCharacter->m_body->rb->GetPosition().x + (m_currentCharacter->m_body->size.x + bullet->m_body->radius) * std::cos(angleToShoot);
-		float point_y = m_currentCharacter->m_body->rb->GetPosition().y + (m_currentCharacter->m_body->size.x + bullet->m_body->radius) * std::sin(angleToShoot);
-		
-		bullet->m_body->rb->SetTransform(Vec2(point_x, point_y), 0.f);
-		bullet->m_body->rb->SetFixedRotation(true);
-		bullet->m_body->rb->SetGravityScale(0.3f);
-		bullet->m_body->rb->SetAngularVelocity(0.f);
-		bullet->m_body->rb->SetLinearVelocity(Vec2(std::cosf(angleToShoot) * shootPower, std::sinf(angleToShoot) * shootPower));
-		addGameObjects(bullet);
-	}
+	m_eventMap.addKeyPressedCallback(sf::Keyboard::Space, [this](const sf::Event&) {
+		if (canShoot)
+			shoot();
+		return false;
+	});
 
-	if (inputEvent.key.code == sf::Keyboard::Z) {
+	m_eventMap.addKeyPressedCallback(sf::Keyboard::Z, [this](const sf::Event&) {
 		shootingAngle -= 1;
-	}
-	else if (inputEvent.key.code == sf::Keyboard::S)
-	{
+		return false;
+	});
+
+	m_eventMap.addKeyPressedCallback(sf::Keyboard::S, [this](const sf::Event&) {
 		shootingAngle += 1;
-	}
-	else if (inputEvent.key.code == sf::Keyboard::E) {
-		if(shootPower < 100)
+		return false;
+	});
+
+	m_eventMap.addKeyPressedCallback(sf::Keyboard::E, [this](const sf::Event&) {
+		if (shootPower < 100)
 			shootPower += 1;
-	}
-	else if (inputEvent.key.code == sf::Keyboard::A) {
+		return false;
+	});
+
+	m_eventMap.addKeyPressedCallback(sf::Keyboard::A, [this](const sf::Event&) {
 		if (shootPower > 10)
 			shootPower -= 1;
-	}
-
-	if (displaymenu && inputEvent.type == sf::Event::MouseButtonReleased && inputEvent.mouseButton.button == 0) {
+		return false;
+	});
 
-		FVector2 mousePosition = FVector2(sf::Mouse::getPosition().x, sf::Mouse::getPosition().y);
-		startButton->handleClick(mousePosition);
-		exitButton->handleClick(mousePosition);
+	// The characters subscribe to their keys, they are the only objects of the scene that take input.
+	for (Character* character : { player1.get(), player2.get() })
+	{
+		auto control = [this, character](const sf::Event& event) {
+			ProcessCharacterInput(character->m_control, character->m_body->rb, event, player_index_to_play);
+			return false;
+		};
+
+		m_eventMap.addKeyPressedCallback(character->m_control.left, control);
+		m_eventMap.addKeyPressedCallback(character->m_control.right, control);
+		m_eventMap.addKeyPressedCallback(sf::Keyboard::Enter, control);
+		// Releasing any key stops the character.
+		m_eventMap.addEventCallback(sf::Event::KeyReleased, control);
 	}
+}
+
+void GameScene::shoot()
+{
+	canShoot = false;
 
-	IScene::processInput(inputEvent);
+	const RectEntity& shooter = *m_currentCharacter->m_body;
+	FireShell(m_bullets, m_bulletPool, m_world.get(), shooter.rb, shooter.size.x, player_index_to_play, shootingAngle, shootPower);
+}
 
+void GameScene::processInput(sf::Event& inputEvent) {
 
+	// Only the subscribers get the event, nothing is broadcast to the objects.
+	m_eventMap.executeCallback(inputEvent);
 }
 
 void GameScene::update(const float& deltaTime) {
@@ -188,6 +220,19 @@ void GameScene::update(const float& deltaTime) {
 
 	m_world->Step(deltaTime, velocityIterations, positionIterations);
 
+	// Move the characters that moved, the user data of their body is their player index plus one (GetCharacterBodyId).
+	Character* characters[] = { player1.get(), player2.get() };
+	const TransformBuffer& transforms = m_world->GetMovedTransforms();
+	for (int i = 0; i < transforms.GetCount(); ++i)
+	{
+		int playerIndex = GetCharacterIndex(transforms.ids[i]);
+		if (playerIndex < 0 || playerIndex >= 2)
+		{
+			continue;
+		}
+		characters[playerIndex]->m_boundingBox->setPosition({ transforms.x[i], transforms.y[i] });
+	}
+
 	/*
 	for (auto element : hudElements)
 	{
@@ -197,11 +242,22 @@ void GameScene::update(const float& deltaTime) {
 
 	windArrow->setPosition(windArrow->getInitialPosition());
 
-	auto currentCharacterContactList = m_currentCharacter->m_body->rb->GetContactList();
-	if (!m_currentCharacter->m_startJumping && currentCharacterContactList != nullptr && currentCharacterContactList->contact->GetManifold()->pointCount > 0) {
-		m_currentCharacter->m_isJumping = false;
+	CharacterControl* controls[] = { &player1->m_control, &player2->m_control };
+	const Fixture* fixtures[] = { player1->getFixture(), player2->getFixture() };
+	CountCharacterContacts(m_world->GetContactEvents(), controls, fixtures, 2);
+
+	// Landing with Enter still held does not begin a new contact, look at the ongoing ones.
+	if (!m_currentCharacter->m_control.startJumping && m_currentCharacter->m_control.touchCount > 0) {
+		m_currentCharacter->m_control.isJumping = false;
 	}
 
+	BulletContext bulletContext = { m_world.get(), &m_bulletPool, { player1->m_body->rb, player2->m_body->rb }, windAngle, windForce };
+	float damage[2] = {};
+	UpdateBullets(m_bullets, bulletContext, damage);
+	m_bullets.flush();
+	player1->takeDamage(damage[0]);
+	player2->takeDamage(damage[1]);
+
 
 
 	lifeBar1->correctSize();
@@ -235,22 +291,23 @@ void GameScene::render() {
 
 	for (auto element : hudElements)
 	{
-		m_window->draw(*element);
+		element->submit(m_renderer, PANEL_RENDER_LAYER);
 	}
-	
-	IScene::render();
 
+	RenderBullets(m_bullets, m_renderer);
 
-	m_window->draw(*windArrow);
-	m_window->draw(*lifeBar1);
-	m_window->draw(*lifeBar2);
+	windArrow->submit(m_renderer, HUD_RENDER_LAYER);
+	lifeBar1->submit(m_renderer, HUD_RENDER_LAYER);
+	lifeBar2->submit(m_renderer, HUD_RENDER_LAYER);
 
 	if (displaymenu)
 	{
-		startButton->draw(*m_window, sf::RenderStates::Default);
-		exitButton->draw(*m_window, sf::RenderStates::Default);
+		startButton->submit(m_renderer, MENU_RENDER_LAYER);
+		exitButton->submit(m_renderer, MENU_RENDER_LAYER);
 	}
 
+	// Adds the objects and draws everything.
+	IScene::render();
 
 
 	float angleToShoot = shootingAngle * PI / 180;
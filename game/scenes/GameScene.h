@@ -1,19 +1,21 @@
 #pragma once
 
-#include "engine/Scene/Scene.h"
+#include "engine/Scene/TypedScene.h"
 #include "engine/Ui/Buttons/RectangleButton.h"
 #include "game/Camera.h"
 #include "game/EventManager.h"
 #include "engine/Ui/HUD/HudElement.h"
+#include "game/GameObjects/GameObjectFactory.h"
 #include "game/GameObjects/Ground.h"
-#include "game/GameObjects/Bullet.h"
+#include "game/GameObjects/Wall.h"
+#include "game/Systems/BulletSystems.h"
 #include "game/GameObjects/Character/Character.h"
 #include "engine/Ui/HUD/HudArrow.h"
 #include "game/GameObjects/Character/Character.h"
 #include "engine/Ui/HUD/HudEntityFixed.h"
 
 
-class GameScene : public IScene
+class GameScene : public TypedScene<AvailableGOTypes>
 {
 public:
 	GameScene();
@@ -25,6 +27,7 @@ public:
 
 	void initButtons();
 	void NextPlayer();
+	void shoot();
 	void initObjects();
 	void registerEvents();
 
@@ -43,7 +46,7 @@ public:
 private:
 
 	//PhysicsWorld* m_physicsWorld;
-	EventManager* m_eventManager;
+	EventMap m_eventMap;
 	Camera* m_camera;
 
 	std::shared_ptr<RectangleButton> startButton;
@@ -57,8 +60,6 @@ public:
 	std::shared_ptr<Character> player1;
 	std::shared_ptr<Character> player2;
 private:
-	std::shared_ptr<World> m_world;
-
 	// Interface elements
 	std::shared_ptr<HudElement<std::string>> pannel;
 	std::shared_ptr<HudElement<std::string>> moveInfo;
@@ -80,8 +81,8 @@ private:
 
 	std::vector < std::shared_ptr<HudElement<std::string>> > hudElements;
 
-public:
-	std::vector<std::shared_ptr<Bullet>> m_fragmentation;
-
+	// Shells and fragments, updated and drawn in bulk.
+	BulletArchetype m_bullets;
+	BulletPool m_bulletPool;
 };
 
@@ -2,19 +2,23 @@
 #include <iostream>
 #include "engine/Game/Game.h"
 #include "game/Scenes/SceneEnum.h"
+#include "engine/Resources/ResourceCache.h"
 #include "engine/Ui/UiFactory.h"
+#include "game/GameObjects/RenderLayers.h"
 
 
 StartScene::StartScene() : IScene()
 {
-    sf::Texture* backgroundTexture = new sf::Texture();
-    if (!backgroundTexture->loadFromFile("Assets/Background.jpg")) {
-        std::cout << "Error loading texture" << std::endl;
-    }
+    m_backgroundTexture = ResourceCache::GetInstance()->getTexture("Assets/Background.jpg");
     
     // Create background sprite
     m_backgroundSprite = new sf::Sprite();
-    m_backgroundSprite->setTexture(*backgroundTexture);
+    if (!m_backgroundTexture) {
+        std::cout << "Error loading texture" << std::endl;
+    }
+    else {
+        m_backgroundSprite->setTexture(*m_backgroundTexture);
+    }
     m_backgroundSprite->setPosition(0, 0);
 
     initButtons();
@@ -56,7 +60,8 @@ void StartScene::processInput(sf::Event& inputEvent)
 
     if (inputEvent.type == sf::Event::MouseButtonReleased && inputEvent.mouseButton.button == 0){
 
-        FVector2 mousePosition = FVector2(sf::Mouse::getPosition().x, sf::Mouse::getPosition().y);
+        // From the event rather than the live mouse, so a replay clicks the same place.
+        FVector2 mousePosition = FVector2(inputEvent.mouseButton.x, inputEvent.mouseButton.y);
         startButton->handleClick(mousePosition);
         exitButton->handleClick(mousePosition);
     }
@@ -72,9 +77,9 @@ void StartScene::update(const float& deltaTime)
 
 void StartScene::render()
 {
-    m_window->draw(*m_backgroundSprite);
-    startButton->draw(*m_window, sf::RenderStates::Default);
-    exitButton->draw(*m_window, sf::RenderStates::Default);
+    m_renderer.addSprite(PANEL_RENDER_LAYER, *m_backgroundSprite);
+    startButton->submit(m_renderer, MENU_RENDER_LAYER);
+    exitButton->submit(m_renderer, MENU_RENDER_LAYER);
 
     IScene::render();
 }
\ No newline at end of file
@@ -20,6 +20,7 @@ private:
 	std::shared_ptr<RectangleButton> startButton;
 	std::shared_ptr<RectangleButton> exitButton;
 
+	std::shared_ptr<sf::Texture> m_backgroundTexture;
 	sf::Sprite* m_backgroundSprite;
 
 };
@@ -1,16 +1,31 @@
 #include "BroadPhase.h"
 
+#include <algorithm>
+
 BroadPhase::BroadPhase()
 {
 	m_proxyCount = 0;
 
 	m_pairCapacity = 16;
 	m_pairCount = 0;
-	m_pairBuffer = std::vector<Pair*>(m_pairCapacity);
+	m_pairBuffer = std::vector<Pair>(m_pairCapacity);
 
 	m_moveCapacity = 16;
 	m_moveCount = 0;
 	m_moveBuffer = std::vector<int>(m_moveCapacity);
+
+	for (int i = 0; i < b2_maxCollisionLayers; ++i)
+	{
+		m_layerMasks[i] = 0xFFFFFFFF;
+	}
+
+	m_rebuildFactor = b2_treeRebuildFactor;
+	m_bestAreaRatio = 0.0f;
+	m_qualityCheckCounter = 0;
+	m_rebuildStepCount = 0;
+	m_treeRebuildCount = 0;
+
+	m_moveStats = {};
 }
 
 BroadPhase::~BroadPhase()
@@ -19,9 +34,9 @@ BroadPhase::~BroadPhase()
 	m_moveBuffer.clear();
 }
 
-int BroadPhase::CreateProxy(const AABB& aabb, void* userData)
+int BroadPhase::CreateProxy(const AABB& aabb, void* userData, int layer)
 {
-	int proxyId = m_tree.CreateProxy(aabb, userData);
+	int proxyId = m_tree.CreateProxy(aabb, userData, layer);
 	++m_proxyCount;
 	BufferMove(proxyId);
 	return proxyId;
@@ -29,6 +44,9 @@ int BroadPhase::CreateProxy(const AABB& aabb, void* userData)
 
 void BroadPhase::DestroyProxy(int proxyId)
 {
+	// Do not leave a queued move on a freed node.
+	ApplyMoves();
+
 	UnBufferMove(proxyId);
 	--m_proxyCount;
 	m_tree.DestroyProxy(proxyId);
@@ -43,19 +61,213 @@ void BroadPhase::MoveProxy(int proxyId, const AABB& aabb, const Vec2& displaceme
 	}
 }
 
+void BroadPhase::QueueMove(int proxyId, const AABB& aabb, const Vec2& displacement)
+{
+	m_moveQueue.proxyIds.push_back(proxyId);
+	m_moveQueue.lowerX.push_back(aabb.lowerBound.x);
+	m_moveQueue.lowerY.push_back(aabb.lowerBound.y);
+	m_moveQueue.upperX.push_back(aabb.upperBound.x);
+	m_moveQueue.upperY.push_back(aabb.upperBound.y);
+	m_moveQueue.dx.push_back(displacement.x);
+	m_moveQueue.dy.push_back(displacement.y);
+}
+
+void BroadPhase::ApplyMoves()
+{
+	MoveQueue& q = m_moveQueue;
+	const int count = q.GetCount();
+	if (count == 0)
+	{
+		return;
+	}
+
+	m_moveStats.queuedCount += count;
+
+	// Escape test against the current fat AABBs, same rules as DynamicTree::MoveProxy.
+	// A proxy escapes if its tight AABB left the fat AABB or if the fat AABB is
+	// much larger than needed (the body was fast and slowed down).
+	m_escaped.clear();
+	const float r = b2_aabbExtension;
+	const float huge = 4.0f * r;
+	for (int i = 0; i < count; ++i)
+	{
+		const AABB& treeAABB = m_tree.GetFatAABB(q.proxyIds[i]);
+		bool contained = treeAABB.lowerBound.x <= q.lowerX[i] && treeAABB.lowerBound.y <= q.lowerY[i]
+			&& q.upperX[i] <= treeAABB.upperBound.x && q.upperY[i] <= treeAABB.upperBound.y;
+
+		// Turn the tight AABB into the fat AABB, predicting the movement.
+		float dx = b2_aabbMultiplier * q.dx[i];
+		float dy = b2_aabbMultiplier * q.dy[i];
+		q.lowerX[i] += Min(dx, 0.0f) - r;
+		q.lowerY[i] += Min(dy, 0.0f) - r;
+		q.upperX[i] += Max(dx, 0.0f) + r;
+		q.upperY[i] += Max(dy, 0.0f) + r;
+
+		bool tooLarge = treeAABB.lowerBound.x < q.lowerX[i] - huge || treeAABB.lowerBound.y < q.lowerY[i] - huge
+			|| q.upperX[i] + huge < treeAABB.upperBound.x || q.upperY[i] + huge < treeAABB.upperBound.y;
+
+		if (contained == false || tooLarge)
+		{
+			m_escaped.push_back(i);
+		}
+	}
+
+	// Touch the tree in proxy order, neighbouring ids are usually close in the node pool.
+	std::sort(m_escaped.begin(), m_escaped.end(), [&q](int a, int b)
+	{
+		return q.proxyIds[a] < q.proxyIds[b];
+	});
+
+	for (int i : m_escaped)
+	{
+		int proxyId = q.proxyIds[i];
+
+		AABB fatAABB;
+		fatAABB.lowerBound.Set(q.lowerX[i], q.lowerY[i]);
+		fatAABB.upperBound.Set(q.upperX[i], q.upperY[i]);
+
+		AABB hugeAABB;
+		hugeAABB.lowerBound.Set(q.lowerX[i] - huge, q.lowerY[i] - huge);
+		hugeAABB.upperBound.Set(q.upperX[i] + huge, q.upperY[i] + huge);
+
+		// A small move only needs to grow the ancestors. Shrinking or a jump
+		// away from the old location re-inserts the leaf to keep the tree tight.
+		const AABB& treeAABB = m_tree.GetFatAABB(proxyId);
+		if (b2TestOverlap(treeAABB, fatAABB) && hugeAABB.Contains(treeAABB))
+		{
+			m_tree.EnlargeProxy(proxyId, fatAABB);
+			++m_moveStats.enlargedCount;
+		}
+		else
+		{
+			m_tree.ReinsertProxy(proxyId, fatAABB);
+			++m_moveStats.reinsertedCount;
+		}
+
+		BufferMove(proxyId);
+	}
+
+	q.Clear();
+}
+
+void BroadPhase::UpdateTreeQuality()
+{
+	b2Assert(m_moveQueue.GetCount() == 0);
+
+	if (m_tree.IsRebuilding())
+	{
+		// Same step whatever the pace of the worker, the proxy ids come out the same.
+		if (++m_rebuildStepCount >= b2_treeRebuildLatency && m_tree.FinishRebuild(true))
+		{
+			++m_treeRebuildCount;
+			m_bestAreaRatio = m_tree.GetAreaRatio();
+		}
+		return;
+	}
+
+	if (m_rebuildFactor <= 0.0f)
+	{
+		return;
+	}
+
+	// The area ratio walks the whole node pool, only sample it now and then.
+	if (++m_qualityCheckCounter < b2_treeQualityInterval)
+	{
+		return;
+	}
+	m_qualityCheckCounter = 0;
+
+	if (m_proxyCount < b2_treeRebuildMinProxies)
+	{
+		return;
+	}
+
+	float areaRatio = m_tree.GetAreaRatio();
+	if (m_bestAreaRatio == 0.0f || areaRatio < m_bestAreaRatio)
+	{
+		m_bestAreaRatio = areaRatio;
+		return;
+	}
+
+	if (areaRatio > m_rebuildFactor * m_bestAreaRatio)
+	{
+		m_tree.StartRebuild();
+		m_rebuildStepCount = 0;
+	}
+}
+
+void BroadPhase::MoveQueue::Clear()
+{
+	proxyIds.clear();
+	lowerX.clear();
+	lowerY.clear();
+	upperX.clear();
+	upperY.clear();
+	dx.clear();
+	dy.clear();
+}
+
+void BroadPhase::CopyFrom(const BroadPhase& other)
+{
+	b2Assert(other.m_moveQueue.GetCount() == 0);
+
+	m_tree.CopyFrom(other.m_tree);
+	m_proxyCount = other.m_proxyCount;
+
+	m_moveBuffer = other.m_moveBuffer;
+	m_moveCapacity = other.m_moveCapacity;
+	m_moveCount = other.m_moveCount;
+
+	for (int i = 0; i < b2_maxCollisionLayers; ++i)
+	{
+		m_layerMasks[i] = other.m_layerMasks[i];
+	}
+
+	m_rebuildFactor = other.m_rebuildFactor;
+	m_bestAreaRatio = other.m_bestAreaRatio;
+	m_qualityCheckCounter = other.m_qualityCheckCounter;
+	m_rebuildStepCount = other.m_rebuildStepCount;
+}
+
 void BroadPhase::TouchProxy(int proxyId)
 {
 	BufferMove(proxyId);
 }
 
+void BroadPhase::SetProxyLayer(int proxyId, int layer)
+{
+	if (m_tree.GetLayer(proxyId) == layer)
+	{
+		return;
+	}
+
+	m_tree.SetLayer(proxyId, layer);
+	BufferMove(proxyId);
+}
+
+void BroadPhase::SetLayerCollision(int layerA, int layerB, bool flag)
+{
+	b2Assert(0 <= layerA && layerA < b2_maxCollisionLayers);
+	b2Assert(0 <= layerB && layerB < b2_maxCollisionLayers);
+
+	if (flag)
+	{
+		m_layerMasks[layerA] |= 1u << layerB;
+		m_layerMasks[layerB] |= 1u << layerA;
+	}
+	else
+	{
+		m_layerMasks[layerA] &= ~(1u << layerB);
+		m_layerMasks[layerB] &= ~(1u << layerA);
+	}
+}
+
 void BroadPhase::BufferMove(int proxyId)
 {
 	if (m_moveCount == m_moveCapacity)
 	{
-		std::vector<int> oldBuffer = m_moveBuffer;
 		m_moveCapacity *= 2;
-		m_moveBuffer = std::vector<int>(m_moveCapacity);
-		oldBuffer.clear();
+		m_moveBuffer.resize(m_moveCapacity);
 	}
 
 	m_moveBuffer[m_moveCount] = proxyId;
@@ -92,14 +304,12 @@ bool BroadPhase::QueryCallback(int proxyId)
 	// Grow the pair buffer as needed.
 	if (m_pairCount == m_pairCapacity)
 	{
-		std::vector<Pair*> oldBuffer = m_pairBuffer;
 		m_pairCapacity = m_pairCapacity + (m_pairCapacity >> 1);
-		m_pairBuffer = std::vector<Pair*>(m_pairCapacity);
-		oldBuffer.clear();
+		m_pairBuffer.resize(m_pairCapacity);
 	}
 
-	m_pairBuffer[m_pairCount]->proxyIdA = Min(proxyId, m_queryProxyId);
-	m_pairBuffer[m_pairCount]->proxyIdB = Max(proxyId, m_queryProxyId);
+	m_pairBuffer[m_pairCount].proxyIdA = Min(proxyId, m_queryProxyId);
+	m_pairBuffer[m_pairCount].proxyIdB = Max(proxyId, m_queryProxyId);
 	++m_pairCount;
 
 	return true;
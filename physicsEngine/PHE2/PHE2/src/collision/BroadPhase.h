@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "Collision.h"
 #include "DynamicTree.h"
 
@@ -9,6 +11,16 @@ struct Pair
 	int proxyIdB;
 };
 
+/// Proxy move counters, accumulated until ResetMoveStats. Useful to tune
+/// b2_aabbExtension and b2_aabbMultiplier: a high escape ratio means the fat
+/// AABBs are too tight, a high query cost with few escapes means they are too loose.
+struct ProxyMoveStats
+{
+	int queuedCount;		///< proxies synchronized
+	int enlargedCount;		///< proxies that escaped and were enlarged in place
+	int reinsertedCount;	///< proxies that escaped and were re-inserted
+};
+
 /// The broad-phase is used for computing pairs and performing volume queries and ray casts.
 /// This broad-phase does not persist pairs. Instead, this reports potentially new pairs.
 /// It is up to the client to consume the new pairs and to track subsequent overlap.
@@ -26,7 +38,7 @@ public:
 
 	/// Create a proxy with an initial AABB. Pairs are not reported until
 	/// UpdatePairs is called.
-	int CreateProxy(const AABB& aabb, void* userData);
+	int CreateProxy(const AABB& aabb, void* userData, int layer = 0);
 
 	/// Destroy a proxy. It is up to the client to remove any pairs.
 	void DestroyProxy(int proxyId);
@@ -35,15 +47,51 @@ public:
 	/// call UpdatePairs to finalized the proxy pairs (for your time step).
 	void MoveProxy(int proxyId, const AABB& aabb, const Vec2& displacement);
 
+	/// Queue a proxy move, the tree is not touched until ApplyMoves. A proxy
+	/// should be queued at most once between two calls to ApplyMoves.
+	void QueueMove(int proxyId, const AABB& aabb, const Vec2& displacement);
+
+	/// Apply the queued moves in one pass. Proxies still inside their fat AABB
+	/// are left alone, the others are enlarged or re-inserted in proxy order.
+	void ApplyMoves();
+
+	/// Get the proxy move counters.
+	const ProxyMoveStats& GetMoveStats() const;
+
+	/// Reset the proxy move counters.
+	void ResetMoveStats();
+
 	/// Call to trigger a re-processing of it's pairs on the next call to UpdatePairs.
 	void TouchProxy(int proxyId);
 
+	/// Change the collision layer of a proxy. The proxy is touched so new pairs
+	/// are found on the next call to UpdatePairs.
+	void SetProxyLayer(int proxyId, int layer);
+
+	/// Enable/disable collision between two layers. The matrix is kept symmetric.
+	/// All layers collide by default.
+	void SetLayerCollision(int layerA, int layerB, bool flag);
+
+	/// Get the mask of the layers colliding with a layer.
+	unsigned int GetLayerMask(int layer) const;
+
+	/// Test if two proxies are on layers that collide.
+	bool TestLayers(int proxyIdA, int proxyIdB) const;
+
 	/// Get the fat AABB for a proxy.
 	const AABB& GetFatAABB(int proxyId) const;
 
 	/// Get user data from a proxy. Returns nullptr if the id is invalid.
 	void* GetUserData(int proxyId) const;
 
+	/// Set the user data of a proxy.
+	void SetUserData(int proxyId, void* userData);
+
+	/// Copy the proxies, pending moves and settings of another broad-phase.
+	/// Proxy ids are kept, the user data must be set again. The other
+	/// broad-phase must have no queued moves.
+	void CopyFrom(const BroadPhase& other);
+
 	/// Test overlap of fat AABBs.
 	bool TestOverlap(int proxyIdA, int proxyIdB) const;
 
@@ -78,6 +126,18 @@ public:
 	/// Get the quality metric of the embedded tree.
 	float GetTreeQuality() const;
 
+	/// Watch the tree quality and rebuild the tree in the background when it
+	/// degrades. The rebuild is swapped in here b2_treeRebuildLatency calls after
+	/// it started, so call this between time steps, with no queued moves.
+	void UpdateTreeQuality();
+
+	/// Set the area ratio growth that triggers a background rebuild, see
+	/// b2_treeRebuildFactor. Zero disables the rebuilds.
+	void SetTreeRebuildFactor(float factor);
+
+	/// Get the number of background rebuilds swapped in.
+	int GetTreeRebuildCount() const;
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
@@ -100,11 +160,36 @@ private:
 	int m_moveCapacity;
 	int m_moveCount;
 
-	std::vector<Pair*> m_pairBuffer;
+	std::vector<Pair> m_pairBuffer;
 	int m_pairCapacity;
 	int m_pairCount;
 
 	int m_queryProxyId;
+
+	// Queued moves in SoA layout, the tight AABB is turned into the fat AABB in place.
+	struct MoveQueue
+	{
+		void Clear();
+		int GetCount() const { return int(proxyIds.size()); }
+
+		std::vector<int> proxyIds;
+		std::vector<float> lowerX, lowerY, upperX, upperY;
+		std::vector<float> dx, dy;
+	};
+
+	// Tree quality policy.
+	float m_rebuildFactor;
+	float m_bestAreaRatio;
+	int m_qualityCheckCounter;
+	int m_rebuildStepCount;
+	int m_treeRebuildCount;
+
+	MoveQueue m_moveQueue;
+	std::vector<int> m_escaped;
+	ProxyMoveStats m_moveStats;
+
+	// One row per layer, bit j of row i is set if layer i collides with layer j.
+	unsigned int m_layerMasks[b2_maxCollisionLayers];
 };
 
 inline void* BroadPhase::GetUserData(int proxyId) const
@@ -112,6 +197,11 @@ inline void* BroadPhase::GetUserData(int proxyId) const
 	return m_tree.GetUserData(proxyId);
 }
 
+inline void BroadPhase::SetUserData(int proxyId, void* userData)
+{
+	m_tree.SetUserData(proxyId, userData);
+}
+
 inline bool BroadPhase::TestOverlap(int proxyIdA, int proxyIdB) const
 {
 	const AABB& aabbA = m_tree.GetFatAABB(proxyIdA);
@@ -119,11 +209,44 @@ inline bool BroadPhase::TestOverlap(int proxyIdA, int proxyIdB) const
 	return b2TestOverlap(aabbA, aabbB);
 }
 
+inline unsigned int BroadPhase::GetLayerMask(int layer) const
+{
+	b2Assert(0 <= layer && layer < b2_maxCollisionLayers);
+	return m_layerMasks[layer];
+}
+
+inline bool BroadPhase::TestLayers(int proxyIdA, int proxyIdB) const
+{
+	int layerA = m_tree.GetLayer(proxyIdA);
+	int layerB = m_tree.GetLayer(proxyIdB);
+	return ((m_layerMasks[layerA] >> layerB) & 1) != 0;
+}
+
 inline const AABB& BroadPhase::GetFatAABB(int proxyId) const
 {
 	return m_tree.GetFatAABB(proxyId);
 }
 
+inline const ProxyMoveStats& BroadPhase::GetMoveStats() const
+{
+	return m_moveStats;
+}
+
+inline void BroadPhase::ResetMoveStats()
+{
+	m_moveStats = {};
+}
+
+inline void BroadPhase::SetTreeRebuildFactor(float factor)
+{
+	m_rebuildFactor = factor;
+}
+
+inline int BroadPhase::GetTreeRebuildCount() const
+{
+	return m_treeRebuildCount;
+}
+
 inline int BroadPhase::GetProxyCount() const
 {
 	return m_proxyCount;
@@ -147,6 +270,13 @@ inline float BroadPhase::GetTreeQuality() const
 template <typename T>
 void BroadPhase::UpdatePairs(T* callback)
 {
+	// Moves still in the queue would be missed by the queries.
+	ApplyMoves();
+
+	// The tree is done changing for this step, the pair queries and the
+	// game queries until the next change run on the wide layout.
+	m_tree.UpdateWideLayout();
+
 	// Reset pair buffer
 	m_pairCount = 0;
 
@@ -163,14 +293,16 @@ void BroadPhase::UpdatePairs(T* callback)
 		// we don't fail to create a pair that may touch later.
 		const AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
 
-		// Query tree, create pairs and add them pair buffer.
-		m_tree.Query(this, fatAABB);
+		// Query tree, create pairs and add them pair buffer. Leaves on layers
+		// that do not collide with this proxy are skipped by the tree.
+		const unsigned int layerMask = m_layerMasks[m_tree.GetLayer(m_queryProxyId)];
+		m_tree.Query(this, fatAABB, layerMask);
 	}
 
 	// Send pairs to caller
 	for (int i = 0; i < m_pairCount; ++i)
 	{
-		Pair* primaryPair = m_pairBuffer[i];
+		const Pair* primaryPair = &m_pairBuffer[i];
 		void* userDataA = m_tree.GetUserData(primaryPair->proxyIdA);
 		void* userDataB = m_tree.GetUserData(primaryPair->proxyIdB);
 
@@ -6,7 +6,8 @@
 #include "EdgeShape.h"
 
 // GJK using Voronoi regions (Christer Ericson) and Barycentric coordinates.
-int b2_gjkCalls, b2_gjkIters, b2_gjkMaxIters;
+// Profiling counters, one set per thread since worlds may be stepped on several threads.
+thread_local int b2_gjkCalls, b2_gjkIters, b2_gjkMaxIters;
 
 void DistanceProxy::Set(const Shape* shape, int index)
 {
@@ -2,6 +2,8 @@
 #include "DynamicTree.h"
 
 #include <string.h>
+#include <algorithm>
+#include <chrono>
 #include "../common/Math.h"
 
 DynamicTree::DynamicTree()
@@ -10,19 +12,23 @@ DynamicTree::DynamicTree()
 
 	m_nodeCapacity = 16;
 	m_nodeCount = 0;
-	m_nodes = std::vector<TreeNode*>(m_nodeCapacity);
+	m_nodes = std::vector<TreeNode>(m_nodeCapacity);
 
 	// Build a linked list for the free list.
 	for (int i = 0; i < m_nodeCapacity - 1; ++i)
 	{
-		m_nodes[i]->next = i + 1;
-		m_nodes[i]->height = -1;
+		m_nodes[i].next = i + 1;
+		m_nodes[i].height = -1;
 	}
-	m_nodes[m_nodeCapacity-1]->next = b2_nullNode;
-	m_nodes[m_nodeCapacity-1]->height = -1;
+	m_nodes[m_nodeCapacity-1].next = b2_nullNode;
+	m_nodes[m_nodeCapacity-1].height = -1;
 	m_freeList = 0;
 
 	m_insertionCount = 0;
+
+	m_wideValid = false;
+
+	m_rebuildDiscarded = false;
 }
 
 DynamicTree::~DynamicTree()
@@ -31,6 +37,26 @@ DynamicTree::~DynamicTree()
 	m_nodes.clear();
 }
 
+void DynamicTree::CopyFrom(const DynamicTree& other)
+{
+	m_nodeCapacity = other.m_nodeCapacity;
+	m_nodeCount = other.m_nodeCount;
+	m_nodes = other.m_nodes;
+
+	m_root = other.m_root;
+	m_freeList = other.m_freeList;
+	m_insertionCount = other.m_insertionCount;
+
+	// Leaf ids are the same, the wide layout holds no user data.
+	m_wide = other.m_wide;
+	m_wideValid = other.m_wideValid;
+
+	// A running rebuild carries over, the copy swaps it in like the original.
+	m_rebuild = other.m_rebuild;
+	m_rebuildDirty = other.m_rebuildDirty;
+	m_rebuildDiscarded = other.m_rebuildDiscarded;
+}
+
 // Allocate a node from the pool. Grow the pool if necessary.
 int DynamicTree::AllocateNode()
 {
@@ -39,34 +65,32 @@ int DynamicTree::AllocateNode()
 	{
 		b2Assert(m_nodeCount == m_nodeCapacity);
 
-		// The free list is empty. Rebuild a bigger pool.
-		std::vector<TreeNode*> oldNodes = m_nodes;
+		// The free list is empty. Grow the pool, the nodes keep their ids.
 		m_nodeCapacity *= 2;
-		m_nodes = std::vector<TreeNode*>(m_nodeCapacity);
-
-		oldNodes.clear();
+		m_nodes.resize(m_nodeCapacity);
 
 		// Build a linked list for the free list. The parent
 		// pointer becomes the "next" pointer.
 		for (int i = m_nodeCount; i < m_nodeCapacity - 1; ++i)
 		{
-			m_nodes[i]->next = i + 1;
-			m_nodes[i]->height = -1;
+			m_nodes[i].next = i + 1;
+			m_nodes[i].height = -1;
 		}
-		m_nodes[m_nodeCapacity-1]->next = b2_nullNode;
-		m_nodes[m_nodeCapacity-1]->height = -1;
+		m_nodes[m_nodeCapacity-1].next = b2_nullNode;
+		m_nodes[m_nodeCapacity-1].height = -1;
 		m_freeList = m_nodeCount;
 	}
 
 	// Peel a node off the free list.
 	int nodeId = m_freeList;
-	m_freeList = m_nodes[nodeId]->next;
-	m_nodes[nodeId]->parent = b2_nullNode;
-	m_nodes[nodeId]->child1 = b2_nullNode;
-	m_nodes[nodeId]->child2 = b2_nullNode;
-	m_nodes[nodeId]->height = 0;
-	m_nodes[nodeId]->userData = nullptr;
-	m_nodes[nodeId]->moved = false;
+	m_freeList = m_nodes[nodeId].next;
+	m_nodes[nodeId].parent = b2_nullNode;
+	m_nodes[nodeId].child1 = b2_nullNode;
+	m_nodes[nodeId].child2 = b2_nullNode;
+	m_nodes[nodeId].height = 0;
+	m_nodes[nodeId].userData = nullptr;
+	m_nodes[nodeId].layer = 0;
+	m_nodes[nodeId].moved = false;
 	++m_nodeCount;
 	return nodeId;
 }
@@ -76,8 +100,8 @@ void DynamicTree::FreeNode(int nodeId)
 {
 	b2Assert(0 <= nodeId && nodeId < m_nodeCapacity);
 	b2Assert(0 < m_nodeCount);
-	m_nodes[nodeId]->next = m_freeList;
-	m_nodes[nodeId]->height = -1;
+	m_nodes[nodeId].next = m_freeList;
+	m_nodes[nodeId].height = -1;
 	m_freeList = nodeId;
 	--m_nodeCount;
 }
@@ -85,19 +109,23 @@ void DynamicTree::FreeNode(int nodeId)
 // Create a proxy in the tree as a leaf node. We return the index
 // of the node instead of a pointer so that we can grow
 // the node pool.
-int DynamicTree::CreateProxy(const AABB& aabb, void* userData)
+int DynamicTree::CreateProxy(const AABB& aabb, void* userData, int layer)
 {
+	b2Assert(0 <= layer && layer < b2_maxCollisionLayers);
+
 	int proxyId = AllocateNode();
 
 	// Fatten the aabb.
 	Vec2 r(b2_aabbExtension, b2_aabbExtension);
-	m_nodes[proxyId]->aabb.lowerBound = aabb.lowerBound - r;
-	m_nodes[proxyId]->aabb.upperBound = aabb.upperBound + r;
-	m_nodes[proxyId]->userData = userData;
-	m_nodes[proxyId]->height = 0;
-	m_nodes[proxyId]->moved = true;
+	m_nodes[proxyId].aabb.lowerBound = aabb.lowerBound - r;
+	m_nodes[proxyId].aabb.upperBound = aabb.upperBound + r;
+	m_nodes[proxyId].userData = userData;
+	m_nodes[proxyId].height = 0;
+	m_nodes[proxyId].layer = (unsigned char)layer;
+	m_nodes[proxyId].moved = true;
 
 	InsertLeaf(proxyId);
+	MarkRebuildDirty(proxyId);
 
 	return proxyId;
 }
@@ -105,17 +133,18 @@ int DynamicTree::CreateProxy(const AABB& aabb, void* userData)
 void DynamicTree::DestroyProxy(int proxyId)
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
-	b2Assert(m_nodes[proxyId]->IsLeaf());
+	b2Assert(m_nodes[proxyId].IsLeaf());
 
 	RemoveLeaf(proxyId);
 	FreeNode(proxyId);
+	MarkRebuildDirty(proxyId);
 }
 
 bool DynamicTree::MoveProxy(int proxyId, const AABB& aabb, const Vec2& displacement)
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
 
-	b2Assert(m_nodes[proxyId]->IsLeaf());
+	b2Assert(m_nodes[proxyId].IsLeaf());
 
 	// Extend AABB
 	AABB fatAABB;
@@ -144,7 +173,7 @@ bool DynamicTree::MoveProxy(int proxyId, const AABB& aabb, const Vec2& displacem
 		fatAABB.upperBound.y += d.y;
 	}
 
-	const AABB& treeAABB = m_nodes[proxyId]->aabb;
+	const AABB& treeAABB = m_nodes[proxyId].aabb;
 	if (treeAABB.Contains(aabb))
 	{
 		// The tree AABB still contains the object, but it might be too large.
@@ -164,40 +193,75 @@ bool DynamicTree::MoveProxy(int proxyId, const AABB& aabb, const Vec2& displacem
 		// Otherwise the tree AABB is huge and needs to be shrunk
 	}
 
+	ReinsertProxy(proxyId, fatAABB);
+
+	return true;
+}
+
+void DynamicTree::EnlargeProxy(int proxyId, const AABB& fatAABB)
+{
+	m_wideValid = false;
+	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+	b2Assert(m_nodes[proxyId].IsLeaf());
+
+	m_nodes[proxyId].aabb = fatAABB;
+	m_nodes[proxyId].moved = true;
+	MarkRebuildDirty(proxyId);
+
+	// Parents only need to grow, stop at the first one that already contains the leaf.
+	int index = m_nodes[proxyId].parent;
+	while (index != b2_nullNode)
+	{
+		TreeNode* node = &m_nodes[index];
+		if (node->aabb.Contains(fatAABB))
+		{
+			break;
+		}
+
+		node->aabb.Combine(fatAABB);
+		index = node->parent;
+	}
+}
+
+void DynamicTree::ReinsertProxy(int proxyId, const AABB& fatAABB)
+{
+	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+	b2Assert(m_nodes[proxyId].IsLeaf());
+
 	RemoveLeaf(proxyId);
 
-	m_nodes[proxyId]->aabb = fatAABB;
+	m_nodes[proxyId].aabb = fatAABB;
 
 	InsertLeaf(proxyId);
 
-	m_nodes[proxyId]->moved = true;
-
-	return true;
+	m_nodes[proxyId].moved = true;
+	MarkRebuildDirty(proxyId);
 }
 
 void DynamicTree::InsertLeaf(int leaf)
 {
+	m_wideValid = false;
 	++m_insertionCount;
 
 	if (m_root == b2_nullNode)
 	{
 		m_root = leaf;
-		m_nodes[m_root]->parent = b2_nullNode;
+		m_nodes[m_root].parent = b2_nullNode;
 		return;
 	}
 
 	// Find the best sibling for this node
-	AABB leafAABB = m_nodes[leaf]->aabb;
+	AABB leafAABB = m_nodes[leaf].aabb;
 	int index = m_root;
-	while (m_nodes[index]->IsLeaf() == false)
+	while (m_nodes[index].IsLeaf() == false)
 	{
-		int child1 = m_nodes[index]->child1;
-		int child2 = m_nodes[index]->child2;
+		int child1 = m_nodes[index].child1;
+		int child2 = m_nodes[index].child2;
 
-		float area = m_nodes[index]->aabb.GetPerimeter();
+		float area = m_nodes[index].aabb.GetPerimeter();
 
 		AABB combinedAABB;
-		combinedAABB.Combine(m_nodes[index]->aabb, leafAABB);
+		combinedAABB.Combine(m_nodes[index].aabb, leafAABB);
 		float combinedArea = combinedAABB.GetPerimeter();
 
 		// Cost of creating a new parent for this node and the new leaf
@@ -208,34 +272,34 @@ void DynamicTree::InsertLeaf(int leaf)
 
 		// Cost of descending into child1
 		float cost1;
-		if (m_nodes[child1]->IsLeaf())
+		if (m_nodes[child1].IsLeaf())
 		{
 			AABB aabb;
-			aabb.Combine(leafAABB, m_nodes[child1]->aabb);
+			aabb.Combine(leafAABB, m_nodes[child1].aabb);
 			cost1 = aabb.GetPerimeter() + inheritanceCost;
 		}
 		else
 		{
 			AABB aabb;
-			aabb.Combine(leafAABB, m_nodes[child1]->aabb);
-			float oldArea = m_nodes[child1]->aabb.GetPerimeter();
+			aabb.Combine(leafAABB, m_nodes[child1].aabb);
+			float oldArea = m_nodes[child1].aabb.GetPerimeter();
 			float newArea = aabb.GetPerimeter();
 			cost1 = (newArea - oldArea) + inheritanceCost;
 		}
 
 		// Cost of descending into child2
 		float cost2;
-		if (m_nodes[child2]->IsLeaf())
+		if (m_nodes[child2].IsLeaf())
 		{
 			AABB aabb;
-			aabb.Combine(leafAABB, m_nodes[child2]->aabb);
+			aabb.Combine(leafAABB, m_nodes[child2].aabb);
 			cost2 = aabb.GetPerimeter() + inheritanceCost;
 		}
 		else
 		{
 			AABB aabb;
-			aabb.Combine(leafAABB, m_nodes[child2]->aabb);
-			float oldArea = m_nodes[child2]->aabb.GetPerimeter();
+			aabb.Combine(leafAABB, m_nodes[child2].aabb);
+			float oldArea = m_nodes[child2].aabb.GetPerimeter();
 			float newArea = aabb.GetPerimeter();
 			cost2 = newArea - oldArea + inheritanceCost;
 		}
@@ -260,56 +324,56 @@ void DynamicTree::InsertLeaf(int leaf)
 	int sibling = index;
 
 	// Create a new parent.
-	int oldParent = m_nodes[sibling]->parent;
+	int oldParent = m_nodes[sibling].parent;
 	int newParent = AllocateNode();
-	m_nodes[newParent]->parent = oldParent;
-	m_nodes[newParent]->userData = nullptr;
-	m_nodes[newParent]->aabb.Combine(leafAABB, m_nodes[sibling]->aabb);
-	m_nodes[newParent]->height = m_nodes[sibling]->height + 1;
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].userData = nullptr;
+	m_nodes[newParent].aabb.Combine(leafAABB, m_nodes[sibling].aabb);
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
 
 	if (oldParent != b2_nullNode)
 	{
 		// The sibling was not the root.
-		if (m_nodes[oldParent]->child1 == sibling)
+		if (m_nodes[oldParent].child1 == sibling)
 		{
-			m_nodes[oldParent]->child1 = newParent;
+			m_nodes[oldParent].child1 = newParent;
 		}
 		else
 		{
-			m_nodes[oldParent]->child2 = newParent;
+			m_nodes[oldParent].child2 = newParent;
 		}
 
-		m_nodes[newParent]->child1 = sibling;
-		m_nodes[newParent]->child2 = leaf;
-		m_nodes[sibling]->parent = newParent;
-		m_nodes[leaf]->parent = newParent;
+		m_nodes[newParent].child1 = sibling;
+		m_nodes[newParent].child2 = leaf;
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
 	}
 	else
 	{
 		// The sibling was the root.
-		m_nodes[newParent]->child1 = sibling;
-		m_nodes[newParent]->child2 = leaf;
-		m_nodes[sibling]->parent = newParent;
-		m_nodes[leaf]->parent = newParent;
+		m_nodes[newParent].child1 = sibling;
+		m_nodes[newParent].child2 = leaf;
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
 		m_root = newParent;
 	}
 
 	// Walk back up the tree fixing heights and AABBs
-	index = m_nodes[leaf]->parent;
+	index = m_nodes[leaf].parent;
 	while (index != b2_nullNode)
 	{
 		index = Balance(index);
 
-		int child1 = m_nodes[index]->child1;
-		int child2 = m_nodes[index]->child2;
+		int child1 = m_nodes[index].child1;
+		int child2 = m_nodes[index].child2;
 
 		b2Assert(child1 != b2_nullNode);
 		b2Assert(child2 != b2_nullNode);
 
-		m_nodes[index]->height = 1 + Max(m_nodes[child1]->height, m_nodes[child2]->height);
-		m_nodes[index]->aabb.Combine(m_nodes[child1]->aabb, m_nodes[child2]->aabb);
+		m_nodes[index].height = 1 + Max(m_nodes[child1].height, m_nodes[child2].height);
+		m_nodes[index].aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
 
-		index = m_nodes[index]->parent;
+		index = m_nodes[index].parent;
 	}
 
 	//Validate();
@@ -317,36 +381,37 @@ void DynamicTree::InsertLeaf(int leaf)
 
 void DynamicTree::RemoveLeaf(int leaf)
 {
+	m_wideValid = false;
 	if (leaf == m_root)
 	{
 		m_root = b2_nullNode;
 		return;
 	}
 
-	int parent = m_nodes[leaf]->parent;
-	int grandParent = m_nodes[parent]->parent;
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
 	int sibling;
-	if (m_nodes[parent]->child1 == leaf)
+	if (m_nodes[parent].child1 == leaf)
 	{
-		sibling = m_nodes[parent]->child2;
+		sibling = m_nodes[parent].child2;
 	}
 	else
 	{
-		sibling = m_nodes[parent]->child1;
+		sibling = m_nodes[parent].child1;
 	}
 
 	if (grandParent != b2_nullNode)
 	{
 		// Destroy parent and connect sibling to grandParent.
-		if (m_nodes[grandParent]->child1 == parent)
+		if (m_nodes[grandParent].child1 == parent)
 		{
-			m_nodes[grandParent]->child1 = sibling;
+			m_nodes[grandParent].child1 = sibling;
 		}
 		else
 		{
-			m_nodes[grandParent]->child2 = sibling;
+			m_nodes[grandParent].child2 = sibling;
 		}
-		m_nodes[sibling]->parent = grandParent;
+		m_nodes[sibling].parent = grandParent;
 		FreeNode(parent);
 
 		// Adjust ancestor bounds.
@@ -355,19 +420,19 @@ void DynamicTree::RemoveLeaf(int leaf)
 		{
 			index = Balance(index);
 
-			int child1 = m_nodes[index]->child1;
-			int child2 = m_nodes[index]->child2;
+			int child1 = m_nodes[index].child1;
+			int child2 = m_nodes[index].child2;
 
-			m_nodes[index]->aabb.Combine(m_nodes[child1]->aabb, m_nodes[child2]->aabb);
-			m_nodes[index]->height = 1 + Max(m_nodes[child1]->height, m_nodes[child2]->height);
+			m_nodes[index].aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+			m_nodes[index].height = 1 + Max(m_nodes[child1].height, m_nodes[child2].height);
 
-			index = m_nodes[index]->parent;
+			index = m_nodes[index].parent;
 		}
 	}
 	else
 	{
 		m_root = sibling;
-		m_nodes[sibling]->parent = b2_nullNode;
+		m_nodes[sibling].parent = b2_nullNode;
 		FreeNode(parent);
 	}
 
@@ -380,7 +445,7 @@ int DynamicTree::Balance(int iA)
 {
 	b2Assert(iA != b2_nullNode);
 
-	TreeNode* A = m_nodes[iA];
+	TreeNode* A = &m_nodes[iA];
 	if (A->IsLeaf() || A->height < 2)
 	{
 		return iA;
@@ -391,8 +456,8 @@ int DynamicTree::Balance(int iA)
 	b2Assert(0 <= iB && iB < m_nodeCapacity);
 	b2Assert(0 <= iC && iC < m_nodeCapacity);
 
-	TreeNode* B = m_nodes[iB];
-	TreeNode* C = m_nodes[iC];
+	TreeNode* B = &m_nodes[iB];
+	TreeNode* C = &m_nodes[iC];
 
 	int balance = C->height - B->height;
 
@@ -401,8 +466,8 @@ int DynamicTree::Balance(int iA)
 	{
 		int iF = C->child1;
 		int iG = C->child2;
-		TreeNode* F = m_nodes[iF];
-		TreeNode* G = m_nodes[iG];
+		TreeNode* F = &m_nodes[iF];
+		TreeNode* G = &m_nodes[iG];
 		b2Assert(0 <= iF && iF < m_nodeCapacity);
 		b2Assert(0 <= iG && iG < m_nodeCapacity);
 
@@ -414,14 +479,14 @@ int DynamicTree::Balance(int iA)
 		// A's old parent should point to C
 		if (C->parent != b2_nullNode)
 		{
-			if (m_nodes[C->parent]->child1 == iA)
+			if (m_nodes[C->parent].child1 == iA)
 			{
-				m_nodes[C->parent]->child1 = iC;
+				m_nodes[C->parent].child1 = iC;
 			}
 			else
 			{
-				b2Assert(m_nodes[C->parent]->child2 == iA);
-				m_nodes[C->parent]->child2 = iC;
+				b2Assert(m_nodes[C->parent].child2 == iA);
+				m_nodes[C->parent].child2 = iC;
 			}
 		}
 		else
@@ -461,8 +526,8 @@ int DynamicTree::Balance(int iA)
 	{
 		int iD = B->child1;
 		int iE = B->child2;
-		TreeNode* D = m_nodes[iD];
-		TreeNode* E = m_nodes[iE];
+		TreeNode* D = &m_nodes[iD];
+		TreeNode* E = &m_nodes[iE];
 		b2Assert(0 <= iD && iD < m_nodeCapacity);
 		b2Assert(0 <= iE && iE < m_nodeCapacity);
 
@@ -474,14 +539,14 @@ int DynamicTree::Balance(int iA)
 		// A's old parent should point to B
 		if (B->parent != b2_nullNode)
 		{
-			if (m_nodes[B->parent]->child1 == iA)
+			if (m_nodes[B->parent].child1 == iA)
 			{
-				m_nodes[B->parent]->child1 = iB;
+				m_nodes[B->parent].child1 = iB;
 			}
 			else
 			{
-				b2Assert(m_nodes[B->parent]->child2 == iA);
-				m_nodes[B->parent]->child2 = iB;
+				b2Assert(m_nodes[B->parent].child2 == iA);
+				m_nodes[B->parent].child2 = iB;
 			}
 		}
 		else
@@ -526,7 +591,7 @@ int DynamicTree::GetHeight() const
 		return 0;
 	}
 
-	return m_nodes[m_root]->height;
+	return m_nodes[m_root].height;
 }
 
 //
@@ -537,13 +602,13 @@ float DynamicTree::GetAreaRatio() const
 		return 0.0f;
 	}
 
-	const TreeNode* root = m_nodes[m_root];
+	const TreeNode* root = &m_nodes[m_root];
 	float rootArea = root->aabb.GetPerimeter();
 
 	float totalArea = 0.0f;
 	for (int i = 0; i < m_nodeCapacity; ++i)
 	{
-		const TreeNode* node = m_nodes[i];
+		const TreeNode* node = &m_nodes[i];
 		if (node->height < 0)
 		{
 			// Free node in pool
@@ -560,7 +625,7 @@ float DynamicTree::GetAreaRatio() const
 int DynamicTree::ComputeHeight(int nodeId) const
 {
 	b2Assert(0 <= nodeId && nodeId < m_nodeCapacity);
-	TreeNode* node = m_nodes[nodeId];
+	const TreeNode* node = &m_nodes[nodeId];
 
 	if (node->IsLeaf())
 	{
@@ -587,10 +652,10 @@ void DynamicTree::ValidateStructure(int index) const
 
 	if (index == m_root)
 	{
-		b2Assert(m_nodes[index]->parent == b2_nullNode);
+		b2Assert(m_nodes[index].parent == b2_nullNode);
 	}
 
-	const TreeNode* node = m_nodes[index];
+	const TreeNode* node = &m_nodes[index];
 
 	int child1 = node->child1;
 	int child2 = node->child2;
@@ -606,8 +671,8 @@ void DynamicTree::ValidateStructure(int index) const
 	b2Assert(0 <= child1 && child1 < m_nodeCapacity);
 	b2Assert(0 <= child2 && child2 < m_nodeCapacity);
 
-	b2Assert(m_nodes[child1]->parent == index);
-	b2Assert(m_nodes[child2]->parent == index);
+	b2Assert(m_nodes[child1].parent == index);
+	b2Assert(m_nodes[child2].parent == index);
 
 	ValidateStructure(child1);
 	ValidateStructure(child2);
@@ -620,7 +685,7 @@ void DynamicTree::ValidateMetrics(int index) const
 		return;
 	}
 
-	const TreeNode* node = m_nodes[index];
+	const TreeNode* node = &m_nodes[index];
 
 	int child1 = node->child1;
 	int child2 = node->child2;
@@ -636,14 +701,14 @@ void DynamicTree::ValidateMetrics(int index) const
 	b2Assert(0 <= child1 && child1 < m_nodeCapacity);
 	b2Assert(0 <= child2 && child2 < m_nodeCapacity);
 
-	int height1 = m_nodes[child1]->height;
-	int height2 = m_nodes[child2]->height;
+	int height1 = m_nodes[child1].height;
+	int height2 = m_nodes[child2].height;
 	int height;
 	height = 1 + Max(height1, height2);
 	b2Assert(node->height == height);
 
 	AABB aabb;
-	aabb.Combine(m_nodes[child1]->aabb, m_nodes[child2]->aabb);
+	aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
 
 	b2Assert(aabb.lowerBound == node->aabb.lowerBound);
 	b2Assert(aabb.upperBound == node->aabb.upperBound);
@@ -652,6 +717,17 @@ void DynamicTree::ValidateMetrics(int index) const
 	ValidateMetrics(child2);
 }
 
+void DynamicTree::UpdateWideLayout()
+{
+	if (m_wideValid)
+	{
+		return;
+	}
+
+	m_wide.Build(m_nodes.data(), m_root);
+	m_wideValid = true;
+}
+
 void DynamicTree::Validate() const
 {
 #if defined(b2DEBUG)
@@ -663,7 +739,7 @@ void DynamicTree::Validate() const
 	while (freeIndex != b2_nullNode)
 	{
 		b2Assert(0 <= freeIndex && freeIndex < m_nodeCapacity);
-		freeIndex = m_nodes[freeIndex]->next;
+		freeIndex = m_nodes[freeIndex].next;
 		++freeCount;
 	}
 
@@ -678,7 +754,7 @@ int DynamicTree::GetMaxBalance() const
 	int maxBalance = 0;
 	for (int i = 0; i < m_nodeCapacity; ++i)
 	{
-		const TreeNode* node = m_nodes[i];
+		const TreeNode* node = &m_nodes[i];
 		if (node->height <= 1)
 		{
 			continue;
@@ -688,7 +764,7 @@ int DynamicTree::GetMaxBalance() const
 
 		int child1 = node->child1;
 		int child2 = node->child2;
-		int balance = Abs(m_nodes[child2]->height - m_nodes[child1]->height);
+		int balance = Abs(m_nodes[child2].height - m_nodes[child1].height);
 		maxBalance = Max(maxBalance, balance);
 	}
 
@@ -697,21 +773,25 @@ int DynamicTree::GetMaxBalance() const
 
 void DynamicTree::RebuildBottomUp()
 {
+	// The background result no longer matches the tree.
+	m_rebuildDiscarded = IsRebuilding();
+	m_wideValid = false;
+
 	std::vector<int> nodes(m_nodeCount);
 	int count = 0;
 
 	// Build array of leaves. Free the rest.
 	for (int i = 0; i < m_nodeCapacity; ++i)
 	{
-		if (m_nodes[i]->height < 0)
+		if (m_nodes[i].height < 0)
 		{
 			// free node in pool
 			continue;
 		}
 
-		if (m_nodes[i]->IsLeaf())
+		if (m_nodes[i].IsLeaf())
 		{
-			m_nodes[i]->parent = b2_nullNode;
+			m_nodes[i].parent = b2_nullNode;
 			nodes[count] = i;
 			++count;
 		}
@@ -727,11 +807,11 @@ void DynamicTree::RebuildBottomUp()
 		int iMin = -1, jMin = -1;
 		for (int i = 0; i < count; ++i)
 		{
-			AABB aabbi = m_nodes[nodes[i]]->aabb;
+			AABB aabbi = m_nodes[nodes[i]].aabb;
 
 			for (int j = i + 1; j < count; ++j)
 			{
-				AABB aabbj = m_nodes[nodes[j]]->aabb;
+				AABB aabbj = m_nodes[nodes[j]].aabb;
 				AABB b;
 				b.Combine(aabbi, aabbj);
 				float cost = b.GetPerimeter();
@@ -746,11 +826,11 @@ void DynamicTree::RebuildBottomUp()
 
 		int index1 = nodes[iMin];
 		int index2 = nodes[jMin];
-		TreeNode* child1 = m_nodes[index1];
-		TreeNode* child2 = m_nodes[index2];
+		TreeNode* child1 = &m_nodes[index1];
+		TreeNode* child2 = &m_nodes[index2];
 
 		int parentIndex = AllocateNode();
-		TreeNode* parent = m_nodes[parentIndex];
+		TreeNode* parent = &m_nodes[parentIndex];
 		parent->child1 = index1;
 		parent->child2 = index2;
 		parent->height = 1 + Max(child1->height, child2->height);
@@ -773,10 +853,275 @@ void DynamicTree::RebuildBottomUp()
 
 void DynamicTree::ShiftOrigin(const Vec2& newOrigin)
 {
+	// The background result has the old origin.
+	m_rebuildDiscarded = IsRebuilding();
+	m_wideValid = false;
+
 	// Build array of leaves. Free the rest.
 	for (int i = 0; i < m_nodeCapacity; ++i)
 	{
-		m_nodes[i]->aabb.lowerBound -= newOrigin;
-		m_nodes[i]->aabb.upperBound -= newOrigin;
+		m_nodes[i].aabb.lowerBound -= newOrigin;
+		m_nodes[i].aabb.upperBound -= newOrigin;
+	}
+}
+
+void DynamicTree::StartRebuild()
+{
+	if (IsRebuilding() || m_root == b2_nullNode)
+	{
+		return;
+	}
+
+	std::vector<RebuildLeaf> leaves;
+	leaves.reserve(m_nodeCount / 2 + 1);
+	for (int i = 0; i < m_nodeCapacity; ++i)
+	{
+		const TreeNode* node = &m_nodes[i];
+		if (node->height != 0)
+		{
+			// free node or internal node
+			continue;
+		}
+
+		leaves.push_back({ node->aabb, node->aabb.GetCenter(), i });
+	}
+
+	m_rebuildDirty.clear();
+	m_rebuildDiscarded = false;
+
+	// The worker only sees its own copy of the leaves.
+	m_rebuild = std::async(std::launch::async, [leaves = std::move(leaves)]() mutable
+	{
+		RebuildResult result;
+		result.nodes.reserve(leaves.size());
+		result.root = BuildRange(result.nodes, leaves, 0, int(leaves.size()));
+		return result;
+	}).share();
+}
+
+bool DynamicTree::FinishRebuild(bool wait)
+{
+	if (IsRebuilding() == false)
+	{
+		return false;
+	}
+
+	if (wait == false && m_rebuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		return false;
+	}
+
+	std::shared_future<RebuildResult> rebuild = std::move(m_rebuild);
+	const RebuildResult& result = rebuild.get();
+	if (m_rebuildDiscarded)
+	{
+		m_rebuildDirty.clear();
+		m_rebuildDiscarded = false;
+		return false;
+	}
+
+	// Proxies touched since the snapshot are left out of the new hierarchy
+	// and re-inserted afterwards with their current AABB.
+	std::vector<bool> dirty(m_nodeCapacity, false);
+	for (int proxyId : m_rebuildDirty)
+	{
+		dirty[proxyId] = true;
+	}
+
+	// Free the internal nodes, the leaves keep their ids.
+	for (int i = 0; i < m_nodeCapacity; ++i)
+	{
+		if (m_nodes[i].height > 0)
+		{
+			FreeNode(i);
+		}
+		else if (m_nodes[i].height == 0)
+		{
+			m_nodes[i].parent = b2_nullNode;
+		}
+	}
+
+	m_wideValid = false;
+	m_root = LinkRebuilt(result, result.root, dirty);
+
+	for (int proxyId : m_rebuildDirty)
+	{
+		// Skip destroyed proxies and duplicates.
+		if (dirty[proxyId] == false || m_nodes[proxyId].height != 0)
+		{
+			continue;
+		}
+
+		dirty[proxyId] = false;
+		InsertLeaf(proxyId);
+	}
+
+	m_rebuildDirty.clear();
+
+	Validate();
+
+	return true;
+}
+
+void DynamicTree::MarkRebuildDirty(int proxyId)
+{
+	if (IsRebuilding())
+	{
+		m_rebuildDirty.push_back(proxyId);
+	}
+}
+
+// Create the tree nodes of a rebuilt sub-tree, dropping the dirty leaves.
+// Returns the sub-tree root or b2_nullNode if every leaf was dropped.
+int DynamicTree::LinkRebuilt(const RebuildResult& result, int child, const std::vector<bool>& dirty)
+{
+	if (child < 0)
+	{
+		int proxyId = -(child + 1);
+		return dirty[proxyId] ? b2_nullNode : proxyId;
+	}
+
+	const RebuildNode& rebuildNode = result.nodes[child];
+	int child1 = LinkRebuilt(result, rebuildNode.child1, dirty);
+	int child2 = LinkRebuilt(result, rebuildNode.child2, dirty);
+
+	if (child1 == b2_nullNode)
+	{
+		return child2;
+	}
+
+	if (child2 == b2_nullNode)
+	{
+		return child1;
+	}
+
+	int parentIndex = AllocateNode();
+	TreeNode* parent = &m_nodes[parentIndex];
+	parent->child1 = child1;
+	parent->child2 = child2;
+	parent->height = 1 + Max(m_nodes[child1].height, m_nodes[child2].height);
+	parent->aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+
+	m_nodes[child1].parent = parentIndex;
+	m_nodes[child2].parent = parentIndex;
+
+	return parentIndex;
+}
+
+// Top-down binned SAH build of leaves [begin, end). The leaves are binned by
+// centroid along the longest axis and split where the summed perimeters
+// weighted by leaf count is the smallest. Runs on the worker thread.
+int DynamicTree::BuildRange(std::vector<RebuildNode>& nodes, std::vector<RebuildLeaf>& leaves, int begin, int end)
+{
+	const int count = end - begin;
+	if (count == 1)
+	{
+		return -(leaves[begin].proxyId + 1);
+	}
+
+	AABB centerBounds;
+	centerBounds.lowerBound = leaves[begin].center;
+	centerBounds.upperBound = leaves[begin].center;
+	for (int i = begin + 1; i < end; ++i)
+	{
+		centerBounds.lowerBound = Min(centerBounds.lowerBound, leaves[i].center);
+		centerBounds.upperBound = Max(centerBounds.upperBound, leaves[i].center);
 	}
+
+	Vec2 extents = centerBounds.upperBound - centerBounds.lowerBound;
+	const int axis = extents.x >= extents.y ? 0 : 1;
+	const float lower = axis == 0 ? centerBounds.lowerBound.x : centerBounds.lowerBound.y;
+	const float extent = axis == 0 ? extents.x : extents.y;
+
+	int mid = begin + count / 2;
+
+	if (extent > b2_epsilon)
+	{
+		const int binCount = 16;
+		int binLeafCounts[binCount] = {};
+		AABB binAABBs[binCount];
+
+		const float scale = binCount / extent;
+		auto binOf = [&](const RebuildLeaf& leaf)
+		{
+			float c = axis == 0 ? leaf.center.x : leaf.center.y;
+			return Min(int(scale * (c - lower)), binCount - 1);
+		};
+
+		for (int i = begin; i < end; ++i)
+		{
+			int bin = binOf(leaves[i]);
+			if (binLeafCounts[bin] == 0)
+			{
+				binAABBs[bin] = leaves[i].aabb;
+			}
+			else
+			{
+				binAABBs[bin].Combine(leaves[i].aabb);
+			}
+			++binLeafCounts[bin];
+		}
+
+		// Cost of the right side of each split plane, sweeping from the right.
+		float rightCosts[binCount] = {};
+		// The sides start empty, inverted so the first combine sets them.
+		const AABB emptyAABB = { {b2_maxFloat, b2_maxFloat}, {-b2_maxFloat, -b2_maxFloat} };
+		AABB rightAABB = emptyAABB;
+		int rightCount = 0;
+		for (int bin = binCount - 1; bin > 0; --bin)
+		{
+			if (binLeafCounts[bin] > 0)
+			{
+				rightAABB.Combine(binAABBs[bin]);
+				rightCount += binLeafCounts[bin];
+			}
+			rightCosts[bin] = rightCount == 0 ? 0.0f : rightCount * rightAABB.GetPerimeter();
+		}
+
+		// Sweep from the left, the split plane is before bin 'split'.
+		float bestCost = b2_maxFloat;
+		int bestSplit = -1;
+		AABB leftAABB = emptyAABB;
+		int leftCount = 0;
+		for (int split = 1; split < binCount; ++split)
+		{
+			int bin = split - 1;
+			if (binLeafCounts[bin] > 0)
+			{
+				leftAABB.Combine(binAABBs[bin]);
+				leftCount += binLeafCounts[bin];
+			}
+
+			if (leftCount == 0 || leftCount == count)
+			{
+				continue;
+			}
+
+			float cost = leftCount * leftAABB.GetPerimeter() + rightCosts[split];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = split;
+			}
+		}
+
+		if (bestSplit > 0)
+		{
+			auto it = std::partition(leaves.begin() + begin, leaves.begin() + end,
+				[&](const RebuildLeaf& leaf) { return binOf(leaf) < bestSplit; });
+			mid = int(it - leaves.begin());
+		}
+	}
+
+	// All the centers are in one spot, split in the middle.
+	if (mid == begin || mid == end)
+	{
+		mid = begin + count / 2;
+	}
+
+	int child1 = BuildRange(nodes, leaves, begin, mid);
+	int child2 = BuildRange(nodes, leaves, mid, end);
+
+	nodes.push_back({ child1, child2 });
+	return int(nodes.size()) - 1;
 }
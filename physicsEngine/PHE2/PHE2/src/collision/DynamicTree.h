@@ -1,7 +1,10 @@
 #pragma once
+#include <bit>
+#include <future>
 #include <vector>
 
 #include "Collision.h"
+#include "QuadBVH.h"
 #include "../common/Common.h"
 
 #define b2_nullNode (-1)
@@ -33,6 +36,9 @@ struct TreeNode
 	// leaf = 0, free node = -1
 	int height;
 
+	// Collision layer of the leaf, see BroadPhase::SetLayerCollision.
+	unsigned char layer;
+
 	bool moved;
 };
 
@@ -44,6 +50,9 @@ struct TreeNode
 /// object to move by small amounts without triggering a tree update.
 ///
 /// Nodes are pooled and relocatable, so we use node indices rather than pointers.
+///
+/// Queries and ray casts run on a 4-wide copy of the hierarchy when it is up to date,
+/// see UpdateWideLayout. The binary tree is the one that gets updated.
 class DynamicTree
 {
 public:
@@ -53,8 +62,9 @@ public:
 	/// Destroy the tree, freeing the node pool.
 	~DynamicTree();
 
-	/// Create a proxy. Provide a tight fitting AABB and a userData pointer.
-	int CreateProxy(const AABB& aabb, void* userData);
+	/// Create a proxy. Provide a tight fitting AABB, a userData pointer and
+	/// the collision layer of the proxy.
+	int CreateProxy(const AABB& aabb, void* userData, int layer = 0);
 
 	/// Destroy a proxy. This asserts if the id is invalid.
 	void DestroyProxy(int proxyId);
@@ -65,20 +75,42 @@ public:
 	/// @return true if the proxy was re-inserted.
 	bool MoveProxy(int proxyId, const AABB& aabb1, const Vec2& displacement);
 
+	/// Replace the fat AABB of a proxy and grow its ancestors until one already
+	/// contains it. Cheaper than a re-insertion but the tree quality degrades, so
+	/// only use it for small moves. The proxy is flagged as moved.
+	void EnlargeProxy(int proxyId, const AABB& fatAABB);
+
+	/// Remove a proxy from the tree and insert it back with a new fat AABB.
+	/// The proxy is flagged as moved.
+	void ReinsertProxy(int proxyId, const AABB& fatAABB);
+
 	/// Get proxy user data.
 	/// @return the proxy user data or 0 if the id is invalid.
 	void* GetUserData(int proxyId) const;
 
+	/// Set proxy user data.
+	void SetUserData(int proxyId, void* userData);
+
+	/// Copy the node pool of another tree, proxy ids are kept. The user data
+	/// still points to the other tree's objects until it is set again.
+	/// A background rebuild of the other tree is not copied.
+	void CopyFrom(const DynamicTree& other);
+
 	bool WasMoved(int proxyId) const;
 	void ClearMoved(int proxyId);
 
+	/// Get/set the collision layer of a proxy.
+	int GetLayer(int proxyId) const;
+	void SetLayer(int proxyId, int layer);
+
 	/// Get the fat AABB for a proxy.
 	const AABB& GetFatAABB(int proxyId) const;
 
 	/// Query an AABB for overlapping proxies. The callback class
-	/// is called for each proxy that overlaps the supplied AABB.
+	/// is called for each proxy that overlaps the supplied AABB and whose
+	/// layer bit is set in layerMask.
 	template <typename T>
-	void Query(T* callback, const AABB& aabb) const;
+	void Query(T* callback, const AABB& aabb, unsigned int layerMask = 0xFFFFFFFF) const;
 
 	/// Ray-cast against the proxies in the tree. This relies on the callback
 	/// to perform a exact ray-cast in the case were the proxy contains a shape.
@@ -90,6 +122,10 @@ public:
 	template <typename T>
 	void RayCast(T* callback, const b2RayCastInput& input) const;
 
+	/// Collapse the tree into the 4-wide query layout if it changed since the last
+	/// call. Queries and ray casts use this layout until the tree changes again.
+	void UpdateWideLayout();
+
 	/// Validate this tree. For testing.
 	void Validate() const;
 
@@ -107,6 +143,21 @@ public:
 	/// Build an optimal tree. Very expensive. For testing.
 	void RebuildBottomUp();
 
+	/// Rebuild the tree on a worker thread with a binned SAH builder. The leaf
+	/// AABBs are copied now and the tree keeps working meanwhile. Does nothing
+	/// if a rebuild is already running.
+	void StartRebuild();
+
+	/// Swap in the rebuilt tree if the worker is done. Proxies created, moved or
+	/// destroyed since StartRebuild are re-inserted with their current AABB.
+	/// The free list and the proxy ids change, wait for a deterministic swap.
+	/// @param wait block until the worker is done.
+	/// @return true if the tree was replaced.
+	bool FinishRebuild(bool wait = false);
+
+	/// Is a background rebuild running or waiting to be swapped in?
+	bool IsRebuilding() const;
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
@@ -114,6 +165,38 @@ public:
 
 private:
 
+	// Leaf copied for the background rebuild.
+	struct RebuildLeaf
+	{
+		AABB aabb;
+		Vec2 center;
+		int proxyId;
+	};
+
+	// Internal node of the background rebuild. A child >= 0 is another rebuild
+	// node, a child < 0 is the leaf -(child + 1).
+	struct RebuildNode
+	{
+		int child1;
+		int child2;
+	};
+
+	struct RebuildResult
+	{
+		std::vector<RebuildNode> nodes;
+		int root;
+	};
+
+	template <typename T>
+	void QueryWide(T* callback, const AABB& aabb, unsigned int layerMask) const;
+
+	template <typename T>
+	void RayCastWide(T* callback, const b2RayCastInput& input) const;
+
+	static int BuildRange(std::vector<RebuildNode>& nodes, std::vector<RebuildLeaf>& leaves, int begin, int end);
+	int LinkRebuilt(const RebuildResult& result, int child, const std::vector<bool>& dirty);
+	void MarkRebuildDirty(int proxyId);
+
 	int AllocateNode();
 	void FreeNode(int node);
 
@@ -130,42 +213,81 @@ private:
 
 	int m_root;
 
-	std::vector<TreeNode*> m_nodes;
+	std::vector<TreeNode> m_nodes;
 	int m_nodeCount;
 	int m_nodeCapacity;
 
 	int m_freeList;
 
 	int m_insertionCount;
+
+	// Read-only query layout, valid until the next change of the binary tree.
+	QuadBVH m_wide;
+	bool m_wideValid;
+
+	// Shared with the copies of the tree, they swap in the same result.
+	std::shared_future<RebuildResult> m_rebuild;
+	std::vector<int> m_rebuildDirty;
+	bool m_rebuildDiscarded;
 };
 
+inline bool DynamicTree::IsRebuilding() const
+{
+	return m_rebuild.valid();
+}
+
 inline void* DynamicTree::GetUserData(int proxyId) const
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
-	return m_nodes[proxyId]->userData;
+	return m_nodes[proxyId].userData;
+}
+
+inline void DynamicTree::SetUserData(int proxyId, void* userData)
+{
+	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+	m_nodes[proxyId].userData = userData;
 }
 
 inline bool DynamicTree::WasMoved(int proxyId) const
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
-	return m_nodes[proxyId]->moved;
+	return m_nodes[proxyId].moved;
 }
 
 inline void DynamicTree::ClearMoved(int proxyId)
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
-	m_nodes[proxyId]->moved = false;
+	m_nodes[proxyId].moved = false;
+}
+
+inline int DynamicTree::GetLayer(int proxyId) const
+{
+	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+	return m_nodes[proxyId].layer;
+}
+
+inline void DynamicTree::SetLayer(int proxyId, int layer)
+{
+	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+	b2Assert(0 <= layer && layer < b2_maxCollisionLayers);
+	m_nodes[proxyId].layer = (unsigned char)layer;
 }
 
 inline const AABB& DynamicTree::GetFatAABB(int proxyId) const
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
-	return m_nodes[proxyId]->aabb;
+	return m_nodes[proxyId].aabb;
 }
 
 template <typename T>
-inline void DynamicTree::Query(T* callback, const AABB& aabb) const
+inline void DynamicTree::Query(T* callback, const AABB& aabb, unsigned int layerMask) const
 {
+	if (m_wideValid)
+	{
+		QueryWide(callback, aabb, layerMask);
+		return;
+	}
+
 	std::vector<int> stack;
 	stack.reserve(256);
 	stack.push_back(m_root);
@@ -179,12 +301,18 @@ inline void DynamicTree::Query(T* callback, const AABB& aabb) const
 			continue;
 		}
 
-		const TreeNode* node = m_nodes[nodeId];
+		const TreeNode* node = &m_nodes[nodeId];
 
 		if (b2TestOverlap(node->aabb, aabb))
 		{
 			if (node->IsLeaf())
 			{
+				// Reject the leaf before it reaches the callback.
+				if (((layerMask >> node->layer) & 1) == 0)
+				{
+					continue;
+				}
+
 				bool proceed = callback->QueryCallback(nodeId);
 				if (proceed == false)
 				{
@@ -203,6 +331,12 @@ inline void DynamicTree::Query(T* callback, const AABB& aabb) const
 template <typename T>
 inline void DynamicTree::RayCast(T* callback, const b2RayCastInput& input) const
 {
+	if (m_wideValid)
+	{
+		RayCastWide(callback, input);
+		return;
+	}
+
 	Vec2 p1 = input.p1;
 	Vec2 p2 = input.p2;
 	Vec2 r = p2 - p1;
@@ -239,7 +373,7 @@ inline void DynamicTree::RayCast(T* callback, const b2RayCastInput& input) const
 			continue;
 		}
 
-		const TreeNode* node = m_nodes[nodeId];
+		const TreeNode* node = &m_nodes[nodeId];
 
 		if (b2TestOverlap(node->aabb, segmentAABB) == false)
 		{
@@ -287,3 +421,128 @@ inline void DynamicTree::RayCast(T* callback, const b2RayCastInput& input) const
 		}
 	}
 }
+
+template <typename T>
+inline void DynamicTree::QueryWide(T* callback, const AABB& aabb, unsigned int layerMask) const
+{
+	if (m_wide.IsEmpty())
+	{
+		return;
+	}
+
+	std::vector<int> stack;
+	stack.reserve(64);
+	stack.push_back(m_wide.GetRoot());
+
+	while (stack.size() > 0)
+	{
+		int index = stack.back();
+		stack.pop_back();
+
+		const QuadBVH::Node& node = m_wide.GetNode(index);
+		unsigned int mask = (unsigned int)m_wide.TestOverlap(index, aabb);
+		while (mask != 0)
+		{
+			int i = std::countr_zero(mask);
+			mask &= mask - 1;
+
+			int child = node.children[i];
+			if (child >= 0)
+			{
+				stack.push_back(child);
+				continue;
+			}
+
+			int proxyId = -(child + 1);
+
+			// Reject the leaf before it reaches the callback.
+			if (((layerMask >> m_nodes[proxyId].layer) & 1) == 0)
+			{
+				continue;
+			}
+
+			bool proceed = callback->QueryCallback(proxyId);
+			if (proceed == false)
+			{
+				return;
+			}
+		}
+	}
+}
+
+template <typename T>
+inline void DynamicTree::RayCastWide(T* callback, const b2RayCastInput& input) const
+{
+	if (m_wide.IsEmpty())
+	{
+		return;
+	}
+
+	Vec2 p1 = input.p1;
+	Vec2 p2 = input.p2;
+	Vec2 r = p2 - p1;
+	b2Assert(r.LengthSquared() > 0.0f);
+	r.Normalize();
+
+	// v is perpendicular to the segment.
+	Vec2 v = Cross(1.0f, r);
+	Vec2 abs_v = Abs(v);
+
+	float maxFraction = input.maxFraction;
+
+	// Build a bounding box for the segment.
+	AABB segmentAABB;
+	{
+		Vec2 t = p1 + maxFraction * (p2 - p1);
+		segmentAABB.lowerBound = Min(p1, t);
+		segmentAABB.upperBound = Max(p1, t);
+	}
+
+	std::vector<int> stack;
+	stack.reserve(64);
+	stack.push_back(m_wide.GetRoot());
+
+	while (stack.size() > 0)
+	{
+		int index = stack.back();
+		stack.pop_back();
+
+		const QuadBVH::Node& node = m_wide.GetNode(index);
+		unsigned int mask = (unsigned int)m_wide.TestSegment(index, segmentAABB, p1, v, abs_v);
+		while (mask != 0)
+		{
+			int i = std::countr_zero(mask);
+			mask &= mask - 1;
+
+			int child = node.children[i];
+			if (child >= 0)
+			{
+				stack.push_back(child);
+				continue;
+			}
+
+			b2RayCastInput subInput;
+			subInput.p1 = input.p1;
+			subInput.p2 = input.p2;
+			subInput.maxFraction = maxFraction;
+
+			float value = callback->rayCastCallback(subInput, -(child + 1));
+
+			if (value == 0.0f)
+			{
+				// The client has terminated the ray cast.
+				return;
+			}
+
+			if (value > 0.0f)
+			{
+				// Update segment bounding box and drop the siblings it no longer reaches.
+				maxFraction = value;
+				Vec2 t = p1 + maxFraction * (p2 - p1);
+				segmentAABB.lowerBound = Min(p1, t);
+				segmentAABB.upperBound = Max(p1, t);
+				mask &= (unsigned int)m_wide.TestSegment(index, segmentAABB, p1, v, abs_v);
+			}
+		}
+	}
+}
@@ -0,0 +1,395 @@
+#include "ManifoldBatch.h"
+#include "CircleShape.h"
+#include "EdgeShape.h"
+
+#if defined(B2_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+// Feature hit by the circle in the edge and circle kernel.
+enum b2EdgeCircleRegion
+{
+	e_edgeNoContact = 0,
+	e_edgeVertexA,
+	e_edgeVertexB,
+	e_edgeFace
+};
+
+void CircleCircleBatch::Clear()
+{
+	pAx.clear(); pAy.clear(); cA.clear(); sA.clear();
+	localAx.clear(); localAy.clear(); rA.clear();
+	pBx.clear(); pBy.clear(); cB.clear(); sB.clear();
+	localBx.clear(); localBy.clear(); rB.clear();
+}
+
+void CircleCircleBatch::Add(const CircleShape* circleA, const Transform& xfA,
+							const CircleShape* circleB, const Transform& xfB)
+{
+	pAx.push_back(xfA.p.x); pAy.push_back(xfA.p.y); cA.push_back(xfA.q.c); sA.push_back(xfA.q.s);
+	localAx.push_back(circleA->m_p.x); localAy.push_back(circleA->m_p.y); rA.push_back(circleA->m_radius);
+	pBx.push_back(xfB.p.x); pBy.push_back(xfB.p.y); cB.push_back(xfB.q.c); sB.push_back(xfB.q.s);
+	localBx.push_back(circleB->m_p.x); localBy.push_back(circleB->m_p.y); rB.push_back(circleB->m_radius);
+}
+
+void EdgeCircleBatch::Clear()
+{
+	pAx.clear(); pAy.clear(); cA.clear(); sA.clear();
+	v0x.clear(); v0y.clear(); v1x.clear(); v1y.clear();
+	v2x.clear(); v2y.clear(); v3x.clear(); v3y.clear();
+	oneSided.clear(); rA.clear();
+	pBx.clear(); pBy.clear(); cB.clear(); sB.clear();
+	localBx.clear(); localBy.clear(); rB.clear();
+}
+
+void EdgeCircleBatch::Add(const EdgeShape* edgeA, const Transform& xfA,
+						  const CircleShape* circleB, const Transform& xfB)
+{
+	pAx.push_back(xfA.p.x); pAy.push_back(xfA.p.y); cA.push_back(xfA.q.c); sA.push_back(xfA.q.s);
+	v0x.push_back(edgeA->m_vertex0.x); v0y.push_back(edgeA->m_vertex0.y);
+	v1x.push_back(edgeA->m_vertex1.x); v1y.push_back(edgeA->m_vertex1.y);
+	v2x.push_back(edgeA->m_vertex2.x); v2y.push_back(edgeA->m_vertex2.y);
+	v3x.push_back(edgeA->m_vertex3.x); v3y.push_back(edgeA->m_vertex3.y);
+	oneSided.push_back(edgeA->m_oneSided ? 1.0f : 0.0f);
+	rA.push_back(edgeA->m_radius);
+	pBx.push_back(xfB.p.x); pBy.push_back(xfB.p.y); cB.push_back(xfB.q.c); sB.push_back(xfB.q.s);
+	localBx.push_back(circleB->m_p.x); localBy.push_back(circleB->m_p.y); rB.push_back(circleB->m_radius);
+}
+
+static void b2WriteCirclesManifold(Manifold* manifold, const CircleCircleBatch& batch, int i, bool touching)
+{
+	manifold->pointCount = 0;
+	if (touching == false)
+	{
+		return;
+	}
+
+	manifold->type = Manifold::e_circles;
+	manifold->localPoint.Set(batch.localAx[i], batch.localAy[i]);
+	manifold->localNormal.SetZero();
+	manifold->pointCount = 1;
+
+	manifold->points[0].localPoint.Set(batch.localBx[i], batch.localBy[i]);
+	manifold->points[0].id.key = 0;
+}
+
+// Same operations as b2CollideCircles, used for the remainder of the batch.
+static bool b2TestCirclesLane(const CircleCircleBatch& batch, int i)
+{
+	float pAx = (batch.cA[i] * batch.localAx[i] - batch.sA[i] * batch.localAy[i]) + batch.pAx[i];
+	float pAy = (batch.sA[i] * batch.localAx[i] + batch.cA[i] * batch.localAy[i]) + batch.pAy[i];
+	float pBx = (batch.cB[i] * batch.localBx[i] - batch.sB[i] * batch.localBy[i]) + batch.pBx[i];
+	float pBy = (batch.sB[i] * batch.localBx[i] + batch.cB[i] * batch.localBy[i]) + batch.pBy[i];
+
+	float dx = pBx - pAx;
+	float dy = pBy - pAy;
+	float distSqr = dx * dx + dy * dy;
+	float radius = batch.rA[i] + batch.rB[i];
+	return (distSqr > radius * radius) == false;
+}
+
+void b2CollideCirclesBatch(Manifold* manifolds, const CircleCircleBatch& batch)
+{
+	const int count = batch.GetCount();
+	int i = 0;
+
+#if defined(B2_SIMD_SSE2)
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 cA = _mm_loadu_ps(&batch.cA[i]);
+		__m128 sA = _mm_loadu_ps(&batch.sA[i]);
+		__m128 lAx = _mm_loadu_ps(&batch.localAx[i]);
+		__m128 lAy = _mm_loadu_ps(&batch.localAy[i]);
+		__m128 cB = _mm_loadu_ps(&batch.cB[i]);
+		__m128 sB = _mm_loadu_ps(&batch.sB[i]);
+		__m128 lBx = _mm_loadu_ps(&batch.localBx[i]);
+		__m128 lBy = _mm_loadu_ps(&batch.localBy[i]);
+
+		// pA = Mul(xfA, circleA->m_p), pB = Mul(xfB, circleB->m_p)
+		__m128 pAx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(cA, lAx), _mm_mul_ps(sA, lAy)), _mm_loadu_ps(&batch.pAx[i]));
+		__m128 pAy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sA, lAx), _mm_mul_ps(cA, lAy)), _mm_loadu_ps(&batch.pAy[i]));
+		__m128 pBx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(cB, lBx), _mm_mul_ps(sB, lBy)), _mm_loadu_ps(&batch.pBx[i]));
+		__m128 pBy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sB, lBx), _mm_mul_ps(cB, lBy)), _mm_loadu_ps(&batch.pBy[i]));
+
+		__m128 dx = _mm_sub_ps(pBx, pAx);
+		__m128 dy = _mm_sub_ps(pBy, pAy);
+		__m128 distSqr = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		__m128 radius = _mm_add_ps(_mm_loadu_ps(&batch.rA[i]), _mm_loadu_ps(&batch.rB[i]));
+
+		int touching = _mm_movemask_ps(_mm_cmpngt_ps(distSqr, _mm_mul_ps(radius, radius)));
+
+		for (int k = 0; k < 4; ++k)
+		{
+			b2WriteCirclesManifold(manifolds + i + k, batch, i + k, (touching >> k) & 1);
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		b2WriteCirclesManifold(manifolds + i, batch, i, b2TestCirclesLane(batch, i));
+	}
+}
+
+static void b2WriteEdgeAndCircleManifold(Manifold* manifold, const EdgeCircleBatch& batch, int i,
+										 int region, float nx, float ny)
+{
+	manifold->pointCount = 0;
+	if (region == e_edgeNoContact)
+	{
+		return;
+	}
+
+	b2ContactFeature cf;
+	cf.indexB = 0;
+	cf.typeB = b2ContactFeature::e_vertex;
+
+	if (region == e_edgeFace)
+	{
+		cf.indexA = 0;
+		cf.typeA = b2ContactFeature::e_face;
+		manifold->type = Manifold::e_faceA;
+		manifold->localNormal.Set(nx, ny);
+		manifold->localPoint.Set(batch.v1x[i], batch.v1y[i]);
+	}
+	else
+	{
+		cf.indexA = region == e_edgeVertexA ? 0 : 1;
+		cf.typeA = b2ContactFeature::e_vertex;
+		manifold->type = Manifold::e_circles;
+		manifold->localNormal.SetZero();
+		if (region == e_edgeVertexA)
+		{
+			manifold->localPoint.Set(batch.v1x[i], batch.v1y[i]);
+		}
+		else
+		{
+			manifold->localPoint.Set(batch.v2x[i], batch.v2y[i]);
+		}
+	}
+
+	manifold->pointCount = 1;
+	manifold->points[0].id.key = 0;
+	manifold->points[0].id.cf = cf;
+	manifold->points[0].localPoint.Set(batch.localBx[i], batch.localBy[i]);
+}
+
+// Same operations as b2CollideEdgeAndCircle, used for the remainder of the batch.
+static int b2TestEdgeAndCircleLane(const EdgeCircleBatch& batch, int i, float* nx, float* ny)
+{
+	// Compute circle in frame of edge
+	float wx = (batch.cB[i] * batch.localBx[i] - batch.sB[i] * batch.localBy[i]) + batch.pBx[i];
+	float wy = (batch.sB[i] * batch.localBx[i] + batch.cB[i] * batch.localBy[i]) + batch.pBy[i];
+	float px = wx - batch.pAx[i];
+	float py = wy - batch.pAy[i];
+	Vec2 Q((batch.cA[i] * px + batch.sA[i] * py), (-batch.sA[i] * px + batch.cA[i] * py));
+
+	Vec2 A(batch.v1x[i], batch.v1y[i]), B(batch.v2x[i], batch.v2y[i]);
+	Vec2 e = B - A;
+
+	Vec2 n(e.y, -e.x);
+	float offset = Dot(n, Q - A);
+
+	bool oneSided = batch.oneSided[i] != 0.0f;
+	if (oneSided && offset < 0.0f)
+	{
+		return e_edgeNoContact;
+	}
+
+	float u = Dot(e, B - Q);
+	float v = Dot(e, Q - A);
+
+	float radius = batch.rA[i] + batch.rB[i];
+
+	if (v <= 0.0f)
+	{
+		Vec2 d = Q - A;
+		if (Dot(d, d) > radius * radius)
+		{
+			return e_edgeNoContact;
+		}
+
+		if (oneSided)
+		{
+			Vec2 e1 = A - Vec2(batch.v0x[i], batch.v0y[i]);
+			if (Dot(e1, A - Q) > 0.0f)
+			{
+				return e_edgeNoContact;
+			}
+		}
+
+		return e_edgeVertexA;
+	}
+
+	if (u <= 0.0f)
+	{
+		Vec2 d = Q - B;
+		if (Dot(d, d) > radius * radius)
+		{
+			return e_edgeNoContact;
+		}
+
+		if (oneSided)
+		{
+			Vec2 e2 = Vec2(batch.v3x[i], batch.v3y[i]) - B;
+			if (Dot(e2, Q - B) > 0.0f)
+			{
+				return e_edgeNoContact;
+			}
+		}
+
+		return e_edgeVertexB;
+	}
+
+	float den = Dot(e, e);
+	b2Assert(den > 0.0f);
+	Vec2 P = (1.0f / den) * (u * A + v * B);
+	Vec2 d = Q - P;
+	if (Dot(d, d) > radius * radius)
+	{
+		return e_edgeNoContact;
+	}
+
+	if (offset < 0.0f)
+	{
+		n.Set(-n.x, -n.y);
+	}
+	n.Normalize();
+
+	*nx = n.x;
+	*ny = n.y;
+	return e_edgeFace;
+}
+
+void b2CollideEdgeAndCircleBatch(Manifold* manifolds, const EdgeCircleBatch& batch)
+{
+	const int count = batch.GetCount();
+	int i = 0;
+
+#if defined(B2_SIMD_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 epsilon = _mm_set1_ps(b2_epsilon);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// Q = MulT(xfA, Mul(xfB, circleB->m_p))
+		__m128 cB = _mm_loadu_ps(&batch.cB[i]);
+		__m128 sB = _mm_loadu_ps(&batch.sB[i]);
+		__m128 lBx = _mm_loadu_ps(&batch.localBx[i]);
+		__m128 lBy = _mm_loadu_ps(&batch.localBy[i]);
+		__m128 wx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(cB, lBx), _mm_mul_ps(sB, lBy)), _mm_loadu_ps(&batch.pBx[i]));
+		__m128 wy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sB, lBx), _mm_mul_ps(cB, lBy)), _mm_loadu_ps(&batch.pBy[i]));
+
+		__m128 cA = _mm_loadu_ps(&batch.cA[i]);
+		__m128 sA = _mm_loadu_ps(&batch.sA[i]);
+		__m128 px = _mm_sub_ps(wx, _mm_loadu_ps(&batch.pAx[i]));
+		__m128 py = _mm_sub_ps(wy, _mm_loadu_ps(&batch.pAy[i]));
+		__m128 Qx = _mm_add_ps(_mm_mul_ps(cA, px), _mm_mul_ps(sA, py));
+		__m128 Qy = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(zero, sA), px), _mm_mul_ps(cA, py));
+
+		__m128 Ax = _mm_loadu_ps(&batch.v1x[i]);
+		__m128 Ay = _mm_loadu_ps(&batch.v1y[i]);
+		__m128 Bx = _mm_loadu_ps(&batch.v2x[i]);
+		__m128 By = _mm_loadu_ps(&batch.v2y[i]);
+		__m128 ex = _mm_sub_ps(Bx, Ax);
+		__m128 ey = _mm_sub_ps(By, Ay);
+
+		// Normal points to the right for a CCW winding
+		__m128 nx = ey;
+		__m128 ny = _mm_sub_ps(zero, ex);
+		__m128 QAx = _mm_sub_ps(Qx, Ax);
+		__m128 QAy = _mm_sub_ps(Qy, Ay);
+		__m128 offset = _mm_add_ps(_mm_mul_ps(nx, QAx), _mm_mul_ps(ny, QAy));
+
+		__m128 oneSided = _mm_cmpneq_ps(_mm_loadu_ps(&batch.oneSided[i]), zero);
+		__m128 rejected = _mm_and_ps(oneSided, _mm_cmplt_ps(offset, zero));
+
+		// Barycentric coordinates
+		__m128 BQx = _mm_sub_ps(Bx, Qx);
+		__m128 BQy = _mm_sub_ps(By, Qy);
+		__m128 u = _mm_add_ps(_mm_mul_ps(ex, BQx), _mm_mul_ps(ey, BQy));
+		__m128 v = _mm_add_ps(_mm_mul_ps(ex, QAx), _mm_mul_ps(ey, QAy));
+
+		__m128 radius = _mm_add_ps(_mm_loadu_ps(&batch.rA[i]), _mm_loadu_ps(&batch.rB[i]));
+		__m128 radiusSqr = _mm_mul_ps(radius, radius);
+
+		__m128 regionA = _mm_cmple_ps(v, zero);
+		__m128 regionB = _mm_andnot_ps(regionA, _mm_cmple_ps(u, zero));
+		__m128 regionAB = _mm_andnot_ps(_mm_or_ps(regionA, regionB), _mm_cmpeq_ps(zero, zero));
+
+		// Region A
+		__m128 ddA = _mm_add_ps(_mm_mul_ps(QAx, QAx), _mm_mul_ps(QAy, QAy));
+		__m128 e1x = _mm_sub_ps(Ax, _mm_loadu_ps(&batch.v0x[i]));
+		__m128 e1y = _mm_sub_ps(Ay, _mm_loadu_ps(&batch.v0y[i]));
+		__m128 u1 = _mm_add_ps(_mm_mul_ps(e1x, _mm_sub_ps(Ax, Qx)), _mm_mul_ps(e1y, _mm_sub_ps(Ay, Qy)));
+		__m128 hitA = _mm_and_ps(_mm_cmpngt_ps(ddA, radiusSqr),
+								 _mm_andnot_ps(_mm_and_ps(oneSided, _mm_cmpgt_ps(u1, zero)), _mm_cmpeq_ps(zero, zero)));
+
+		// Region B
+		__m128 QBx = _mm_sub_ps(Qx, Bx);
+		__m128 QBy = _mm_sub_ps(Qy, By);
+		__m128 ddB = _mm_add_ps(_mm_mul_ps(QBx, QBx), _mm_mul_ps(QBy, QBy));
+		__m128 e2x = _mm_sub_ps(_mm_loadu_ps(&batch.v3x[i]), Bx);
+		__m128 e2y = _mm_sub_ps(_mm_loadu_ps(&batch.v3y[i]), By);
+		__m128 v2 = _mm_add_ps(_mm_mul_ps(e2x, QBx), _mm_mul_ps(e2y, QBy));
+		__m128 hitB = _mm_and_ps(_mm_cmpngt_ps(ddB, radiusSqr),
+								 _mm_andnot_ps(_mm_and_ps(oneSided, _mm_cmpgt_ps(v2, zero)), _mm_cmpeq_ps(zero, zero)));
+
+		// Region AB
+		__m128 den = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+		__m128 invDen = _mm_div_ps(one, den);
+		__m128 Px = _mm_mul_ps(invDen, _mm_add_ps(_mm_mul_ps(u, Ax), _mm_mul_ps(v, Bx)));
+		__m128 Py = _mm_mul_ps(invDen, _mm_add_ps(_mm_mul_ps(u, Ay), _mm_mul_ps(v, By)));
+		__m128 dx = _mm_sub_ps(Qx, Px);
+		__m128 dy = _mm_sub_ps(Qy, Py);
+		__m128 ddAB = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		__m128 hitAB = _mm_cmpngt_ps(ddAB, radiusSqr);
+
+		// Flip the normal toward the circle and normalize it.
+		__m128 flip = _mm_and_ps(_mm_cmplt_ps(offset, zero), _mm_set1_ps(-0.0f));
+		nx = _mm_xor_ps(nx, flip);
+		ny = _mm_xor_ps(ny, flip);
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)));
+		__m128 invLength = _mm_div_ps(one, length);
+		__m128 normalize = _mm_cmpnlt_ps(length, epsilon);
+		nx = _mm_or_ps(_mm_and_ps(normalize, _mm_mul_ps(nx, invLength)), _mm_andnot_ps(normalize, nx));
+		ny = _mm_or_ps(_mm_and_ps(normalize, _mm_mul_ps(ny, invLength)), _mm_andnot_ps(normalize, ny));
+
+		int maskA = _mm_movemask_ps(_mm_andnot_ps(rejected, _mm_and_ps(regionA, hitA)));
+		int maskB = _mm_movemask_ps(_mm_andnot_ps(rejected, _mm_and_ps(regionB, hitB)));
+		int maskAB = _mm_movemask_ps(_mm_andnot_ps(rejected, _mm_and_ps(regionAB, hitAB)));
+
+		alignas(16) float normalX[4];
+		alignas(16) float normalY[4];
+		_mm_store_ps(normalX, nx);
+		_mm_store_ps(normalY, ny);
+
+		for (int k = 0; k < 4; ++k)
+		{
+			int region = e_edgeNoContact;
+			if ((maskA >> k) & 1)
+			{
+				region = e_edgeVertexA;
+			}
+			else if ((maskB >> k) & 1)
+			{
+				region = e_edgeVertexB;
+			}
+			else if ((maskAB >> k) & 1)
+			{
+				region = e_edgeFace;
+			}
+
+			b2WriteEdgeAndCircleManifold(manifolds + i + k, batch, i + k, region, normalX[k], normalY[k]);
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		float nx = 0.0f, ny = 0.0f;
+		int region = b2TestEdgeAndCircleLane(batch, i, &nx, &ny);
+		b2WriteEdgeAndCircleManifold(manifolds + i, batch, i, region, nx, ny);
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+#include "Collision.h"
+
+class CircleShape;
+class EdgeShape;
+
+/// Circle versus circle pairs in SoA layout, used to compute several manifolds at
+/// once. Transforms are split in position and rotation (cos, sin).
+struct CircleCircleBatch
+{
+	void Clear();
+	void Add(const CircleShape* circleA, const Transform& xfA,
+			 const CircleShape* circleB, const Transform& xfB);
+	int GetCount() const { return int(rA.size()); }
+
+	// Circle A
+	std::vector<float> pAx, pAy, cA, sA;
+	std::vector<float> localAx, localAy, rA;
+
+	// Circle B
+	std::vector<float> pBx, pBy, cB, sB;
+	std::vector<float> localBx, localBy, rB;
+};
+
+/// Edge versus circle pairs in SoA layout, used to compute several manifolds at
+/// once. Transforms are split in position and rotation (cos, sin).
+struct EdgeCircleBatch
+{
+	void Clear();
+	void Add(const EdgeShape* edgeA, const Transform& xfA,
+			 const CircleShape* circleB, const Transform& xfB);
+	int GetCount() const { return int(rB.size()); }
+
+	// Edge A
+	std::vector<float> pAx, pAy, cA, sA;
+	std::vector<float> v0x, v0y, v1x, v1y, v2x, v2y, v3x, v3y;
+	std::vector<float> oneSided;	///< 1 for one-sided edges, 0 otherwise
+	std::vector<float> rA;
+
+	// Circle B
+	std::vector<float> pBx, pBy, cB, sB;
+	std::vector<float> localBx, localBy, rB;
+};
+
+/// Compute the manifolds of a batch of circle pairs, 4 pairs at a time with SSE.
+/// The results match b2CollideCircles.
+/// @param manifolds output, one per pair.
+void b2CollideCirclesBatch(Manifold* manifolds, const CircleCircleBatch& batch);
+
+/// Compute the manifolds of a batch of edge and circle pairs, 4 pairs at a time
+/// with SSE. The results match b2CollideEdgeAndCircle up to float rounding of the normal.
+/// @param manifolds output, one per pair.
+void b2CollideEdgeAndCircleBatch(Manifold* manifolds, const EdgeCircleBatch& batch);
@@ -0,0 +1,95 @@
+#include "QuadBVH.h"
+#include "DynamicTree.h"
+
+void QuadBVH::Build(const TreeNode* nodes, int root)
+{
+	m_nodes.clear();
+
+	if (root == b2_nullNode)
+	{
+		return;
+	}
+
+	BuildNode(nodes, root);
+}
+
+// Collapse the binary sub-tree under binaryIndex into one wide node, opening the
+// largest internal children first until there are four children.
+int QuadBVH::BuildNode(const TreeNode* nodes, int binaryIndex)
+{
+	int index = int(m_nodes.size());
+	m_nodes.push_back(Node());
+
+	int slots[4];
+	int count = 0;
+
+	const TreeNode* binaryNode = &nodes[binaryIndex];
+	if (binaryNode->IsLeaf())
+	{
+		// Single leaf tree.
+		slots[count++] = binaryIndex;
+	}
+	else
+	{
+		slots[count++] = binaryNode->child1;
+		slots[count++] = binaryNode->child2;
+
+		while (count < 4)
+		{
+			int best = -1;
+			float bestPerimeter = -1.0f;
+			for (int i = 0; i < count; ++i)
+			{
+				const TreeNode* node = &nodes[slots[i]];
+				if (node->IsLeaf() == false && node->aabb.GetPerimeter() > bestPerimeter)
+				{
+					best = i;
+					bestPerimeter = node->aabb.GetPerimeter();
+				}
+			}
+
+			if (best == -1)
+			{
+				// Only leaves left.
+				break;
+			}
+
+			const TreeNode* opened = &nodes[slots[best]];
+			slots[best] = opened->child1;
+			slots[count++] = opened->child2;
+		}
+	}
+
+	// Children first, the recursion grows m_nodes.
+	int children[4];
+	for (int i = 0; i < count; ++i)
+	{
+		const TreeNode* child = &nodes[slots[i]];
+		children[i] = child->IsLeaf() ? -(slots[i] + 1) : BuildNode(nodes, slots[i]);
+	}
+
+	Node& node = m_nodes[index];
+	for (int i = 0; i < 4; ++i)
+	{
+		if (i < count)
+		{
+			const AABB& aabb = nodes[slots[i]].aabb;
+			node.lowerX[i] = aabb.lowerBound.x;
+			node.lowerY[i] = aabb.lowerBound.y;
+			node.upperX[i] = aabb.upperBound.x;
+			node.upperY[i] = aabb.upperBound.y;
+			node.children[i] = children[i];
+		}
+		else
+		{
+			// Inverted bounds, never overlap.
+			node.lowerX[i] = b2_maxFloat;
+			node.lowerY[i] = b2_maxFloat;
+			node.upperX[i] = -b2_maxFloat;
+			node.upperY[i] = -b2_maxFloat;
+			node.children[i] = 0;
+		}
+	}
+
+	return index;
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <vector>
+
+#include "Collision.h"
+
+#if defined(B2_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+struct TreeNode;
+
+/// A read-only 4-wide copy of a dynamic tree hierarchy, used for queries. Each node
+/// stores the AABBs of its children in SoA layout so that the four children are
+/// tested with one SIMD compare. The layout is rebuilt from the binary tree, it is
+/// never updated in place.
+class QuadBVH
+{
+public:
+	/// A node with up to four children. Unused slots have an empty AABB that
+	/// never overlaps anything.
+	struct alignas(16) Node
+	{
+		float lowerX[4];
+		float lowerY[4];
+		float upperX[4];
+		float upperY[4];
+
+		// A child >= 0 is another node, a child < 0 is the leaf -(child + 1).
+		int children[4];
+	};
+
+	/// Collapse a binary tree into the 4-wide layout.
+	/// @param nodes the binary tree node pool.
+	/// @param root the binary tree root, may be b2_nullNode.
+	void Build(const TreeNode* nodes, int root);
+
+	/// Is there no node to query?
+	bool IsEmpty() const { return m_nodes.empty(); }
+
+	/// Get the root node, valid if the layout is not empty.
+	int GetRoot() const { return 0; }
+
+	/// Get a node.
+	const Node& GetNode(int index) const { return m_nodes[index]; }
+
+	/// Get the number of nodes.
+	int GetNodeCount() const { return int(m_nodes.size()); }
+
+	/// Test the children of a node against an AABB.
+	/// @return a mask with bit i set if child i overlaps.
+	int TestOverlap(int index, const AABB& aabb) const;
+
+	/// Test the children of a node against a segment, same tests as DynamicTree::RayCast:
+	/// overlap with the segment AABB and the separating axis of the segment.
+	/// @param v the segment normal.
+	/// @param absV the absolute value of v.
+	/// @return a mask with bit i set if child i may touch the segment.
+	int TestSegment(int index, const AABB& segmentAABB, const Vec2& p1, const Vec2& v, const Vec2& absV) const;
+
+private:
+
+	int BuildNode(const TreeNode* nodes, int binaryIndex);
+
+	std::vector<Node> m_nodes;
+};
+
+inline int QuadBVH::TestOverlap(int index, const AABB& aabb) const
+{
+	const Node& node = m_nodes[index];
+
+#if defined(B2_SIMD_SSE2)
+	__m128 lowerX = _mm_load_ps(node.lowerX);
+	__m128 lowerY = _mm_load_ps(node.lowerY);
+	__m128 upperX = _mm_load_ps(node.upperX);
+	__m128 upperY = _mm_load_ps(node.upperY);
+
+	// Separated if one AABB starts past the end of the other, see b2TestOverlap.
+	__m128 separated = _mm_or_ps(
+		_mm_or_ps(_mm_cmpgt_ps(_mm_set1_ps(aabb.lowerBound.x), upperX), _mm_cmpgt_ps(lowerX, _mm_set1_ps(aabb.upperBound.x))),
+		_mm_or_ps(_mm_cmpgt_ps(_mm_set1_ps(aabb.lowerBound.y), upperY), _mm_cmpgt_ps(lowerY, _mm_set1_ps(aabb.upperBound.y))));
+
+	return ~_mm_movemask_ps(separated) & 0xF;
+#else
+	int mask = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		bool separated = aabb.lowerBound.x > node.upperX[i] || node.lowerX[i] > aabb.upperBound.x
+			|| aabb.lowerBound.y > node.upperY[i] || node.lowerY[i] > aabb.upperBound.y;
+		mask |= separated ? 0 : (1 << i);
+	}
+	return mask;
+#endif
+}
+
+inline int QuadBVH::TestSegment(int index, const AABB& segmentAABB, const Vec2& p1, const Vec2& v, const Vec2& absV) const
+{
+	int mask = TestOverlap(index, segmentAABB);
+	if (mask == 0)
+	{
+		return 0;
+	}
+
+	const Node& node = m_nodes[index];
+
+	// Separating axis for segment (Gino, p80).
+	// |dot(v, p1 - c)| > dot(|v|, h)
+#if defined(B2_SIMD_SSE2)
+	const __m128 half = _mm_set1_ps(0.5f);
+	__m128 lowerX = _mm_load_ps(node.lowerX);
+	__m128 lowerY = _mm_load_ps(node.lowerY);
+	__m128 upperX = _mm_load_ps(node.upperX);
+	__m128 upperY = _mm_load_ps(node.upperY);
+
+	__m128 cx = _mm_mul_ps(half, _mm_add_ps(lowerX, upperX));
+	__m128 cy = _mm_mul_ps(half, _mm_add_ps(lowerY, upperY));
+	__m128 hx = _mm_mul_ps(half, _mm_sub_ps(upperX, lowerX));
+	__m128 hy = _mm_mul_ps(half, _mm_sub_ps(upperY, lowerY));
+
+	__m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v.x), _mm_sub_ps(_mm_set1_ps(p1.x), cx)),
+						  _mm_mul_ps(_mm_set1_ps(v.y), _mm_sub_ps(_mm_set1_ps(p1.y), cy)));
+	__m128 absD = _mm_andnot_ps(_mm_set1_ps(-0.0f), d);
+	__m128 radius = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(absV.x), hx), _mm_mul_ps(_mm_set1_ps(absV.y), hy));
+
+	int separated = _mm_movemask_ps(_mm_cmpgt_ps(_mm_sub_ps(absD, radius), _mm_setzero_ps()));
+	return mask & ~separated;
+#else
+	for (int i = 0; i < 4; ++i)
+	{
+		if ((mask & (1 << i)) == 0)
+		{
+			continue;
+		}
+
+		Vec2 c(0.5f * (node.lowerX[i] + node.upperX[i]), 0.5f * (node.lowerY[i] + node.upperY[i]));
+		Vec2 h(0.5f * (node.upperX[i] - node.lowerX[i]), 0.5f * (node.upperY[i] - node.lowerY[i]));
+		float separation = Abs(Dot(v, p1 - c)) - Dot(absV, h);
+		if (separation > 0.0f)
+		{
+			mask &= ~(1 << i);
+		}
+	}
+	return mask;
+#endif
+}
@@ -2,9 +2,10 @@
 #include "../common/Common.h"
 #include "../common/Timer.h"
 
-float b2_toiTime, b2_toiMaxTime;
-int b2_toiCalls, b2_toiIters, b2_toiMaxIters;
-int b2_toiRootIters, b2_toiMaxRootIters;
+// Profiling counters, one set per thread since worlds may be stepped on several threads.
+thread_local float b2_toiTime, b2_toiMaxTime;
+thread_local int b2_toiCalls, b2_toiIters, b2_toiMaxIters;
+thread_local int b2_toiRootIters, b2_toiMaxRootIters;
 
 struct b2SeparationFunction
 {
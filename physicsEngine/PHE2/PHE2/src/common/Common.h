@@ -8,6 +8,11 @@
 	#define b2DEBUG
 #endif
 
+// SSE2 code paths, x64 always has it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define B2_SIMD_SSE2
+#endif
+
 #define B2_NOT_USED(x) ((void)(x))
 #define b2Assert(A) assert(A)
 
@@ -34,6 +39,11 @@
 /// not change this value.
 #define b2_maxManifoldPoints	2
 
+/// The number of collision layers. Each fixture belongs to exactly one layer and
+/// the world holds a b2_maxCollisionLayers x b2_maxCollisionLayers matrix telling
+/// which layers collide. Do not change this value, the rows are 32 bit masks.
+#define b2_maxCollisionLayers	32
+
 /// This is used to fatten AABBs in the dynamic tree. This allows proxies
 /// to move by a small amount without triggering a tree adjustment.
 /// This is in meters.
@@ -66,6 +76,28 @@
 /// Maximum number of contacts to be handled to solve a TOI impact.
 #define b2_maxTOIContacts			32
 
+/// Default maximum number of TOI events solved per time step. Events past the
+/// budget are dropped and the bodies keep their end of step positions.
+#define b2_maxTOIEvents				64
+
+/// A dynamic body that moves further than this during a time step gets continuous
+/// collision against static and kinematic bodies, like a bullet. Meters.
+#define b2_toiFastDistance			(0.5f * b2_lengthUnitsPerMeter)
+
+/// The broad-phase samples the dynamic tree quality every this many time steps.
+#define b2_treeQualityInterval		60
+
+/// The dynamic tree is rebuilt in the background when its area ratio grows past
+/// this factor of the best ratio seen. Dimensionless.
+#define b2_treeRebuildFactor		1.5f
+
+/// Trees with fewer proxies than this are never rebuilt, incremental updates are enough.
+#define b2_treeRebuildMinProxies	64
+
+/// A background rebuild is swapped in this many time steps after it started, waiting
+/// for the worker if needed, so the simulation does not depend on the thread timing.
+#define b2_treeRebuildLatency		4
+
 /// The maximum linear position correction used when solving constraints. This helps to
 /// prevent overshoot. Meters.
 #define b2_maxLinearCorrection		(0.2f * b2_lengthUnitsPerMeter)
@@ -90,6 +122,9 @@
 #define b2_baumgarte				0.2f
 #define b2_toiBaumgarte				0.75f
 
+/// A contact hit event is only reported above this approach speed. In meters per second.
+#define b2_hitEventThreshold		(1.0f * b2_lengthUnitsPerMeter)
+
 
 // Sleep
 
@@ -12,6 +12,25 @@ struct TimeStep
 	bool warmStarting;
 };
 
+/// Continuous collision counters of a time step.
+struct TOIStats
+{
+	int candidateCount;		///< contacts of bullets and fast bodies
+	int computeCount;		///< time of impact computations
+	int eventCount;			///< TOI events solved
+	int droppedCount;		///< events left in the queue when the budget ran out
+};
+
+/// Profiling data of a time step. Times are in milliseconds.
+struct Profile
+{
+	float step;
+	float collide;
+	float solve;
+	float broadphase;	///< fixture synchronization and new pairs, part of solve
+	float solveTOI;
+};
+
 /// This is an internal structure.
 struct Position
 {
@@ -30,7 +49,7 @@ struct Velocity
 struct SolverData
 {
 	TimeStep step;
-	std::vector<Position*> positions;
-	std::vector<Velocity*> velocities;
+	Position* positions;
+	Velocity* velocities;
 };
 
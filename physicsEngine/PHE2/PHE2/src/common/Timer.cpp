@@ -1,27 +1,27 @@
 #include "Timer.h"
 
-double Timer::s_invFrequency = 0.0;
-
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #endif
 
 #include <windows.h>
 
-Timer::Timer()
+// Milliseconds per tick, queried once for every thread.
+static double GetInvFrequency()
 {
-	LARGE_INTEGER largeInteger;
-
-	if (s_invFrequency == 0.0)
+	static const double invFrequency = []
 	{
+		LARGE_INTEGER largeInteger;
 		QueryPerformanceFrequency(&largeInteger);
-		s_invFrequency = double(largeInteger.QuadPart);
-		if (s_invFrequency > 0.0)
-		{
-			s_invFrequency = 1000.0 / s_invFrequency;
-		}
-	}
+		double frequency = double(largeInteger.QuadPart);
+		return frequency > 0.0 ? 1000.0 / frequency : 0.0;
+	}();
+	return invFrequency;
+}
 
+Timer::Timer()
+{
+	LARGE_INTEGER largeInteger;
 	QueryPerformanceCounter(&largeInteger);
 	m_start = double(largeInteger.QuadPart);
 }
@@ -38,6 +38,6 @@ float Timer::GetMilliseconds() const
 	LARGE_INTEGER largeInteger;
 	QueryPerformanceCounter(&largeInteger);
 	double count = double(largeInteger.QuadPart);
-	float ms = float(s_invFrequency * (count - m_start));
+	float ms = float(GetInvFrequency() * (count - m_start));
 	return ms;
 }
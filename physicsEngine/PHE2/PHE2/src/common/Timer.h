@@ -16,7 +16,6 @@ public:
 
 private:
 	double m_start;
-	static double s_invFrequency;
 
 };
 
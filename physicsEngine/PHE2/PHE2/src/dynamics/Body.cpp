@@ -40,40 +40,44 @@ Body::Body(const BodyDef* bd, World* world)
 
 	m_world = world;
 
-	m_xf.p = bd->position;
-	m_xf.q.Set(bd->angle);
+	m_states = &world->m_bodyStates;
+	m_stateIndex = m_states->Add(this);
+	m_listIndex = -1;
+	m_movedIndex = -1;
 
-	m_sweep.localCenter.SetZero();
-	m_sweep.c0 = m_xf.p;
-	m_sweep.c = m_xf.p;
-	m_sweep.a0 = bd->angle;
-	m_sweep.a = bd->angle;
-	m_sweep.alpha0 = 0.0f;
+	XfRef().p = bd->position;
+	XfRef().q.Set(bd->angle);
+
+	SweepRef().localCenter.SetZero();
+	SweepRef().c0 = XfRef().p;
+	SweepRef().c = XfRef().p;
+	SweepRef().a0 = bd->angle;
+	SweepRef().a = bd->angle;
+	SweepRef().alpha0 = 0.0f;
 
 	m_contactList = {};
 
-	m_linearVelocity = bd->linearVelocity;
-	m_angularVelocity = bd->angularVelocity;
+	LinearVelocityRef() = bd->linearVelocity;
+	AngularVelocityRef() = bd->angularVelocity;
 
 	m_linearDamping = bd->linearDamping;
 	m_angularDamping = bd->angularDamping;
 	m_gravityScale = bd->gravityScale;
 
-	m_force.SetZero();
-	m_torque = 0.0f;
+	ForceRef().SetZero();
+	TorqueRef() = 0.0f;
 
 	m_sleepTime = 0.0f;
 
 	m_type = bd->type;
 
 	m_mass = 0.0f;
-	m_invMass = 0.0f;
-
 	m_I = 0.0f;
-	m_invI = 0.0f;
 
 	m_fixtureList = {};
 	m_fixtureCount = 0;
+
+	m_userData = bd->userData;
 }
 
 Body::~Body()
@@ -99,21 +103,22 @@ void Body::SetType(b2BodyType type)
 
 	if (m_type == b2_staticBody)
 	{
-		m_linearVelocity.SetZero();
-		m_angularVelocity = 0.0f;
-		m_sweep.a0 = m_sweep.a;
-		m_sweep.c0 = m_sweep.c;
+		LinearVelocityRef().SetZero();
+		AngularVelocityRef() = 0.0f;
+		SweepRef().a0 = SweepRef().a;
+		SweepRef().c0 = SweepRef().c;
 		m_flags &= ~e_awakeFlag;
 		SynchronizeFixtures();
+		m_world->m_contactManager.m_broadPhase.ApplyMoves();
 	}
 
 	SetAwake(true);
 
-	m_force.SetZero();
-	m_torque = 0.0f;
+	ForceRef().SetZero();
+	TorqueRef() = 0.0f;
 
-	// Delete the attached contacts.
-	for (auto ce: m_contactList)
+	// Delete the attached contacts. Destroy removes the edges from the list, iterate a copy.
+	for (auto ce: GetContactList())
 	{
 		m_world->m_contactManager.Destroy(ce->contact);
 	}
@@ -126,7 +131,7 @@ void Body::SetType(b2BodyType type)
 		int proxyCount = f->m_proxyCount;
 		for (int i = 0; i < proxyCount; ++i)
 		{
-			broadPhase->TouchProxy(f->m_proxies[i]->proxyId);
+			broadPhase->TouchProxy(f->m_proxies[i].proxyId);
 		}
 	}
 }
@@ -145,7 +150,7 @@ Fixture* Body::CreateFixture(const FixtureDef* def)
 	if (m_flags & e_enabledFlag)
 	{
 		BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
-		fixture->CreateProxies(broadPhase, m_xf);
+		fixture->CreateProxies(broadPhase, XfRef());
 	}
 
 	m_fixtureList.push_back(fixture);
@@ -192,14 +197,14 @@ void Body::DestroyFixture(Fixture* fixture)
 
 	// Remove the fixture from this body's singly linked list.
 	b2Assert(m_fixtureCount > 0);
+	std::erase(m_fixtureList, fixture);
 
 	const float density = fixture->m_density;
 
 	// Destroy any contacts associated with the fixture.
-	for (auto edge: m_contactList)
+	for (auto edge: GetContactList())
 	{
 		Contact* c = edge->contact;
-		edge = edge->next;
 
 		Fixture* fixtureA = c->GetFixtureA();
 		Fixture* fixtureB = c->GetFixtureB();
@@ -218,6 +223,9 @@ void Body::DestroyFixture(Fixture* fixture)
 		fixture->DestroyProxies(broadPhase);
 	}
 
+	// Releases a shared shape.
+	fixture->Destroy();
+
 	fixture->m_body = nullptr;
 	fixture->m_next = nullptr;
 	fixture->~Fixture();
@@ -235,17 +243,17 @@ void Body::ResetMassData()
 {
 	// Compute mass data from shapes. Each shape has its own density.
 	m_mass = 0.0f;
-	m_invMass = 0.0f;
+	InvMassRef() = 0.0f;
 	m_I = 0.0f;
-	m_invI = 0.0f;
-	m_sweep.localCenter.SetZero();
+	InvIRef() = 0.0f;
+	SweepRef().localCenter.SetZero();
 
 	// Static and kinematic bodies have zero mass.
 	if (m_type == b2_staticBody || m_type == b2_kinematicBody)
 	{
-		m_sweep.c0 = m_xf.p;
-		m_sweep.c = m_xf.p;
-		m_sweep.a0 = m_sweep.a;
+		SweepRef().c0 = XfRef().p;
+		SweepRef().c = XfRef().p;
+		SweepRef().a0 = SweepRef().a;
 		return;
 	}
 
@@ -270,8 +278,8 @@ void Body::ResetMassData()
 	// Compute center of mass.
 	if (m_mass > 0.0f)
 	{
-		m_invMass = 1.0f / m_mass;
-		localCenter *= m_invMass;
+		InvMassRef() = 1.0f / m_mass;
+		localCenter *= InvMassRef();
 	}
 
 	if (m_I > 0.0f && (m_flags & e_fixedRotationFlag) == 0)
@@ -279,22 +287,22 @@ void Body::ResetMassData()
 		// Center the inertia about the center of mass.
 		m_I -= m_mass * Dot(localCenter, localCenter);
 		b2Assert(m_I > 0.0f);
-		m_invI = 1.0f / m_I;
+		InvIRef() = 1.0f / m_I;
 
 	}
 	else
 	{
 		m_I = 0.0f;
-		m_invI = 0.0f;
+		InvIRef() = 0.0f;
 	}
 
 	// Move center of mass.
-	Vec2 oldCenter = m_sweep.c;
-	m_sweep.localCenter = localCenter;
-	m_sweep.c0 = m_sweep.c = Mul(m_xf, m_sweep.localCenter);
+	Vec2 oldCenter = SweepRef().c;
+	SweepRef().localCenter = localCenter;
+	SweepRef().c0 = SweepRef().c = Mul(XfRef(), SweepRef().localCenter);
 
 	// Update center of mass velocity.
-	m_linearVelocity += Cross(m_angularVelocity, m_sweep.c - oldCenter);
+	LinearVelocityRef() += Cross(AngularVelocityRef(), SweepRef().c - oldCenter);
 }
 
 void Body::SetMassData(const MassData* massData)
@@ -310,9 +318,9 @@ void Body::SetMassData(const MassData* massData)
 		return;
 	}
 
-	m_invMass = 0.0f;
+	InvMassRef() = 0.0f;
 	m_I = 0.0f;
-	m_invI = 0.0f;
+	InvIRef() = 0.0f;
 
 	m_mass = massData->mass;
 	if (m_mass <= 0.0f)
@@ -320,22 +328,22 @@ void Body::SetMassData(const MassData* massData)
 		m_mass = 1.0f;
 	}
 
-	m_invMass = 1.0f / m_mass;
+	InvMassRef() = 1.0f / m_mass;
 
 	if (massData->I > 0.0f && (m_flags & Body::e_fixedRotationFlag) == 0)
 	{
 		m_I = massData->I - m_mass * Dot(massData->center, massData->center);
 		b2Assert(m_I > 0.0f);
-		m_invI = 1.0f / m_I;
+		InvIRef() = 1.0f / m_I;
 	}
 
 	// Move center of mass.
-	Vec2 oldCenter = m_sweep.c;
-	m_sweep.localCenter =  massData->center;
-	m_sweep.c0 = m_sweep.c = Mul(m_xf, m_sweep.localCenter);
+	Vec2 oldCenter = SweepRef().c;
+	SweepRef().localCenter =  massData->center;
+	SweepRef().c0 = SweepRef().c = Mul(XfRef(), SweepRef().localCenter);
 
 	// Update center of mass velocity.
-	m_linearVelocity += Cross(m_angularVelocity, m_sweep.c - oldCenter);
+	LinearVelocityRef() += Cross(AngularVelocityRef(), SweepRef().c - oldCenter);
 }
 
 bool Body::ShouldCollide(const Body* other) const
@@ -357,20 +365,23 @@ void Body::SetTransform(const Vec2& position, float angle)
 		return;
 	}
 
-	m_xf.q.Set(angle);
-	m_xf.p = position;
+	const Transform previous = XfRef();
+	XfRef().q.Set(angle);
+	XfRef().p = position;
+	FlagIfMoved(previous);
 
-	m_sweep.c = Mul(m_xf, m_sweep.localCenter);
-	m_sweep.a = angle;
+	SweepRef().c = Mul(XfRef(), SweepRef().localCenter);
+	SweepRef().a = angle;
 
-	m_sweep.c0 = m_sweep.c;
-	m_sweep.a0 = angle;
+	SweepRef().c0 = SweepRef().c;
+	SweepRef().a0 = angle;
 
 	BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
 	for (auto f: m_fixtureList)
 	{
-		f->Synchronize(broadPhase, m_xf, m_xf);
+		f->Synchronize(broadPhase, XfRef(), XfRef());
 	}
+	broadPhase->ApplyMoves();
 
 	// Check for new contacts the next step
 	m_world->m_newContacts = true;
@@ -383,19 +394,19 @@ void Body::SynchronizeFixtures()
 	if (m_flags & Body::e_awakeFlag)
 	{
 		Transform xf1;
-		xf1.q.Set(m_sweep.a0);
-		xf1.p = m_sweep.c0 - Mul(xf1.q, m_sweep.localCenter);
+		xf1.q.Set(SweepRef().a0);
+		xf1.p = SweepRef().c0 - Mul(xf1.q, SweepRef().localCenter);
 
 		for (auto f : m_fixtureList)
 		{
-			f->Synchronize(broadPhase, xf1, m_xf);
+			f->Synchronize(broadPhase, xf1, XfRef());
 		}
 	}
 	else
 	{
 		for (auto f : m_fixtureList)
 		{
-			f->Synchronize(broadPhase, m_xf, m_xf);
+			f->Synchronize(broadPhase, XfRef(), XfRef());
 		}
 	}
 }
@@ -417,7 +428,7 @@ void Body::SetEnabled(bool flag)
 		BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
 		for (auto f : m_fixtureList)
 		{
-			f->CreateProxies(broadPhase, m_xf);
+			f->CreateProxies(broadPhase, XfRef());
 		}
 
 		// Contacts are created at the beginning of the next
@@ -435,11 +446,9 @@ void Body::SetEnabled(bool flag)
 		}
 
 		// Destroy the attached contacts.
-		for (auto ce : m_contactList)
+		for (auto ce : GetContactList())
 		{
-			b2ContactEdge* ce0 = ce;
-			ce = ce->next;
-			m_world->m_contactManager.Destroy(ce0->contact);
+			m_world->m_contactManager.Destroy(ce->contact);
 		}
 		m_contactList.clear();
 	}
@@ -462,7 +471,7 @@ void Body::SetFixedRotation(bool flag)
 		m_flags &= ~e_fixedRotationFlag;
 	}
 
-	m_angularVelocity = 0.0f;
+	AngularVelocityRef() = 0.0f;
 
 	ResetMassData();
 }
@@ -1,7 +1,9 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include "../common/Math.h"
 #include "../collision/Shape.h"
+#include "BodyStates.h"
 
 struct MassData;
 class Fixture;
@@ -44,6 +46,7 @@ struct BodyDef
 		type = b2_staticBody;
 		enabled = true;
 		gravityScale = 1.0f;
+		userData = 0;
 	}
 
 	/// The body type: static, kinematic, or dynamic.
@@ -96,6 +99,10 @@ struct BodyDef
 
 	/// Scale the gravity applied to this body.
 	float gravityScale;
+
+	/// Use this to store an application specific id, e.g. the entity owning the body.
+	/// It is exported with the moved transforms, see World::GetMovedTransforms.
+	uintptr_t userData;
 };
 
 /// A rigid body. These are created via World::CreateBody.
@@ -136,23 +143,24 @@ public:
 	/// @param angle the world rotation in radians.
 	void SetTransform(const Vec2& position, float angle);
 
-	/// Get the body transform for the body's origin.
+	/// Get the body transform for the body's origin. Returned by value, the body
+	/// state storage moves when bodies are added or removed.
 	/// @return the world transform of the body's origin.
-	const Transform& GetTransform() const;
+	Transform GetTransform() const;
 
 	/// Get the world body origin position.
 	/// @return the world position of the body's origin.
-	const Vec2& GetPosition() const;
+	Vec2 GetPosition() const;
 
 	/// Get the angle in radians.
 	/// @return the current world rotation angle in radians.
 	float GetAngle() const;
 
 	/// Get the world position of the center of mass.
-	const Vec2& GetWorldCenter() const;
+	Vec2 GetWorldCenter() const;
 
 	/// Get the local position of the center of mass.
-	const Vec2& GetLocalCenter() const;
+	Vec2 GetLocalCenter() const;
 
 	/// Set the linear velocity of the center of mass.
 	/// @param v the new linear velocity of the center of mass.
@@ -160,7 +168,7 @@ public:
 
 	/// Get the linear velocity of the center of mass.
 	/// @return the linear velocity of the center of mass.
-	const Vec2& GetLinearVelocity() const;
+	Vec2 GetLinearVelocity() const;
 
 	/// Set the angular velocity.
 	/// @param omega the new angular velocity in radians/second.
@@ -345,6 +353,12 @@ public:
 	World* GetWorld();
 	const World* GetWorld() const;
 
+	/// Get the user data set in the body definition.
+	uintptr_t GetUserData() const;
+
+	/// Set the user data. Use this to store your application specific data.
+	void SetUserData(uintptr_t data);
+
 private:
 
 	friend class World;
@@ -352,6 +366,7 @@ private:
 	friend class ContactManager;
 	friend class ContactSolver;
 	friend class Contact;
+	friend struct BodyStates;
 
 	friend class b2DistanceJoint;
 	friend class b2FrictionJoint;
@@ -373,7 +388,8 @@ private:
 		e_bulletFlag		= 0x0008,
 		e_fixedRotationFlag	= 0x0010,
 		e_enabledFlag		= 0x0020,
-		e_toiFlag			= 0x0040
+		e_toiFlag			= 0x0040,	// bullet or fast body, needs continuous collision this step
+		e_movedFlag			= 0x0080	// transform changed since the last export
 	};
 
 	Body(const BodyDef* bd, World* world);
@@ -382,6 +398,10 @@ private:
 	void SynchronizeFixtures();
 	void SynchronizeTransform();
 
+	// Flag the body for World::ExportTransforms if its transform is not previous
+	// anymore, and add it to the moved bodies the first time.
+	void FlagIfMoved(const Transform& previous);
+
 	// This is used to prevent connected bodies from colliding.
 	// It may lie, depending on the collideConnected flag.
 	bool ShouldCollide(const Body* other) const;
@@ -394,14 +414,30 @@ private:
 
 	int m_islandIndex;
 
-	Transform m_xf;		// the body origin transform
-	Sweep m_sweep;		// the swept motion for CCD
-
-	Vec2 m_linearVelocity;
-	float m_angularVelocity;
-
-	Vec2 m_force;
-	float m_torque;
+	// Hot state, stored in the world dense arrays at m_stateIndex.
+	Transform& XfRef();
+	const Transform& XfRef() const;
+	Sweep& SweepRef();
+	const Sweep& SweepRef() const;
+	Vec2& LinearVelocityRef();
+	const Vec2& LinearVelocityRef() const;
+	float& AngularVelocityRef();
+	float AngularVelocityRef() const;
+	Vec2& ForceRef();
+	float& TorqueRef();
+	float& InvMassRef();
+	float InvMassRef() const;
+	float& InvIRef();
+	float InvIRef() const;
+
+	BodyStates* m_states;
+	int m_stateIndex;
+
+	// Index in the body list of the world, so a body is removed in O(1).
+	int m_listIndex;
+
+	// Index in BodyStates::moved, valid while the moved flag is set.
+	int m_movedIndex;
 
 	World* m_world;
 
@@ -411,46 +447,118 @@ private:
 	std::vector<b2JointEdge*> m_jointList;
 	std::vector<b2ContactEdge*> m_contactList;
 
-	float m_mass, m_invMass;
+	float m_mass;
 
 	// Rotational inertia about the center of mass.
-	float m_I, m_invI;
+	float m_I;
 
 	float m_linearDamping;
 	float m_angularDamping;
 	float m_gravityScale;
 
 	float m_sleepTime;
+
+	uintptr_t m_userData;
 };
 
+inline Transform& Body::XfRef()
+{
+	return m_states->transforms[m_stateIndex];
+}
+
+inline const Transform& Body::XfRef() const
+{
+	return m_states->transforms[m_stateIndex];
+}
+
+inline Sweep& Body::SweepRef()
+{
+	return m_states->sweeps[m_stateIndex];
+}
+
+inline const Sweep& Body::SweepRef() const
+{
+	return m_states->sweeps[m_stateIndex];
+}
+
+inline Vec2& Body::LinearVelocityRef()
+{
+	return m_states->linearVelocities[m_stateIndex];
+}
+
+inline const Vec2& Body::LinearVelocityRef() const
+{
+	return m_states->linearVelocities[m_stateIndex];
+}
+
+inline float& Body::AngularVelocityRef()
+{
+	return m_states->angularVelocities[m_stateIndex];
+}
+
+inline float Body::AngularVelocityRef() const
+{
+	return m_states->angularVelocities[m_stateIndex];
+}
+
+inline Vec2& Body::ForceRef()
+{
+	return m_states->forces[m_stateIndex];
+}
+
+inline float& Body::TorqueRef()
+{
+	return m_states->torques[m_stateIndex];
+}
+
+inline float& Body::InvMassRef()
+{
+	return m_states->invMasses[m_stateIndex];
+}
+
+inline float Body::InvMassRef() const
+{
+	return m_states->invMasses[m_stateIndex];
+}
+
+inline float& Body::InvIRef()
+{
+	return m_states->invInertias[m_stateIndex];
+}
+
+inline float Body::InvIRef() const
+{
+	return m_states->invInertias[m_stateIndex];
+}
+
 inline b2BodyType Body::GetType() const
 {
 	return m_type;
 }
 
-inline const Transform& Body::GetTransform() const
+inline Transform Body::GetTransform() const
 {
-	return m_xf;
+	return XfRef();
 }
 
-inline const Vec2& Body::GetPosition() const
+inline Vec2 Body::GetPosition() const
 {
-	return m_xf.p;
+	return XfRef().p;
 }
 
 inline float Body::GetAngle() const
 {
-	return m_sweep.a;
+	return SweepRef().a;
 }
 
-inline const Vec2& Body::GetWorldCenter() const
+inline Vec2 Body::GetWorldCenter() const
 {
-	return m_sweep.c;
+	return SweepRef().c;
 }
 
-inline const Vec2& Body::GetLocalCenter() const
+inline Vec2 Body::GetLocalCenter() const
 {
-	return m_sweep.localCenter;
+	return SweepRef().localCenter;
 }
 
 inline void Body::SetLinearVelocity(const Vec2& v)
@@ -465,12 +573,12 @@ inline void Body::SetLinearVelocity(const Vec2& v)
 		SetAwake(true);
 	}
 
-	m_linearVelocity = v;
+	LinearVelocityRef() = v;
 }
 
-inline const Vec2& Body::GetLinearVelocity() const
+inline Vec2 Body::GetLinearVelocity() const
 {
-	return m_linearVelocity;
+	return LinearVelocityRef();
 }
 
 inline void Body::SetAngularVelocity(float w)
@@ -485,12 +593,12 @@ inline void Body::SetAngularVelocity(float w)
 		SetAwake(true);
 	}
 
-	m_angularVelocity = w;
+	AngularVelocityRef() = w;
 }
 
 inline float Body::GetAngularVelocity() const
 {
-	return m_angularVelocity;
+	return AngularVelocityRef();
 }
 
 inline float Body::GetMass() const
@@ -500,41 +608,41 @@ inline float Body::GetMass() const
 
 inline float Body::GetInertia() const
 {
-	return m_I + m_mass * Dot(m_sweep.localCenter, m_sweep.localCenter);
+	return m_I + m_mass * Dot(SweepRef().localCenter, SweepRef().localCenter);
 }
 
 inline MassData Body::GetMassData() const
 {
 	MassData data;
 	data.mass = m_mass;
-	data.I = m_I + m_mass * Dot(m_sweep.localCenter, m_sweep.localCenter);
-	data.center = m_sweep.localCenter;
+	data.I = m_I + m_mass * Dot(SweepRef().localCenter, SweepRef().localCenter);
+	data.center = SweepRef().localCenter;
 	return data;
 }
 
 inline Vec2 Body::GetWorldPoint(const Vec2& localPoint) const
 {
-	return Mul(m_xf, localPoint);
+	return Mul(XfRef(), localPoint);
 }
 
 inline Vec2 Body::GetWorldVector(const Vec2& localVector) const
 {
-	return Mul(m_xf.q, localVector);
+	return Mul(XfRef().q, localVector);
 }
 
 inline Vec2 Body::GetLocalPoint(const Vec2& worldPoint) const
 {
-	return MulT(m_xf, worldPoint);
+	return MulT(XfRef(), worldPoint);
 }
 
 inline Vec2 Body::GetLocalVector(const Vec2& worldVector) const
 {
-	return MulT(m_xf.q, worldVector);
+	return MulT(XfRef().q, worldVector);
 }
 
 inline Vec2 Body::GetLinearVelocityFromWorldPoint(const Vec2& worldPoint) const
 {
-	return m_linearVelocity + Cross(m_angularVelocity, worldPoint - m_sweep.c);
+	return LinearVelocityRef() + Cross(AngularVelocityRef(), worldPoint - SweepRef().c);
 }
 
 inline Vec2 Body::GetLinearVelocityFromLocalPoint(const Vec2& localPoint) const
@@ -605,10 +713,10 @@ inline void Body::SetAwake(bool flag)
 	{
 		m_flags &= ~e_awakeFlag;
 		m_sleepTime = 0.0f;
-		m_linearVelocity.SetZero();
-		m_angularVelocity = 0.0f;
-		m_force.SetZero();
-		m_torque = 0.0f;
+		LinearVelocityRef().SetZero();
+		AngularVelocityRef() = 0.0f;
+		ForceRef().SetZero();
+		TorqueRef() = 0.0f;
 	}
 }
 
@@ -681,8 +789,8 @@ inline void Body::ApplyForce(const Vec2& force, const Vec2& point, bool wake)
 	// Don't accumulate a force if the body is sleeping.
 	if (m_flags & e_awakeFlag)
 	{
-		m_force += force;
-		m_torque += Cross(point - m_sweep.c, force);
+		ForceRef() += force;
+		TorqueRef() += Cross(point - SweepRef().c, force);
 	}
 }
 
@@ -701,7 +809,7 @@ inline void Body::ApplyForceToCenter(const Vec2& force, bool wake)
 	// Don't accumulate a force if the body is sleeping
 	if (m_flags & e_awakeFlag)
 	{
-		m_force += force;
+		ForceRef() += force;
 	}
 }
 
@@ -720,7 +828,7 @@ inline void Body::ApplyTorque(float torque, bool wake)
 	// Don't accumulate a force if the body is sleeping
 	if (m_flags & e_awakeFlag)
 	{
-		m_torque += torque;
+		TorqueRef() += torque;
 	}
 }
 
@@ -739,8 +847,8 @@ inline void Body::ApplyLinearImpulse(const Vec2& impulse, const Vec2& point, boo
 	// Don't accumulate velocity if the body is sleeping
 	if (m_flags & e_awakeFlag)
 	{
-		m_linearVelocity += m_invMass * impulse;
-		m_angularVelocity += m_invI * Cross(point - m_sweep.c, impulse);
+		LinearVelocityRef() += InvMassRef() * impulse;
+		AngularVelocityRef() += InvIRef() * Cross(point - SweepRef().c, impulse);
 	}
 }
 
@@ -759,7 +867,7 @@ inline void Body::ApplyLinearImpulseToCenter(const Vec2& impulse, bool wake)
 	// Don't accumulate velocity if the body is sleeping
 	if (m_flags & e_awakeFlag)
 	{
-		m_linearVelocity += m_invMass * impulse;
+		LinearVelocityRef() += InvMassRef() * impulse;
 	}
 }
 
@@ -778,24 +886,44 @@ inline void Body::ApplyAngularImpulse(float impulse, bool wake)
 	// Don't accumulate velocity if the body is sleeping
 	if (m_flags & e_awakeFlag)
 	{
-		m_angularVelocity += m_invI * impulse;
+		AngularVelocityRef() += InvIRef() * impulse;
+	}
+}
+
+inline void Body::FlagIfMoved(const Transform& previous)
+{
+	if (m_flags & e_movedFlag)
+	{
+		return;
+	}
+
+	const Transform& xf = XfRef();
+	if (xf.p.x != previous.p.x || xf.p.y != previous.p.y || xf.q.c != previous.q.c || xf.q.s != previous.q.s)
+	{
+		m_flags |= e_movedFlag;
+		m_movedIndex = int(m_states->moved.size());
+		m_states->moved.push_back(this);
 	}
 }
 
 inline void Body::SynchronizeTransform()
 {
-	m_xf.q.Set(m_sweep.a);
-	m_xf.p = m_sweep.c - Mul(m_xf.q, m_sweep.localCenter);
+	const Transform previous = XfRef();
+	XfRef().q.Set(SweepRef().a);
+	XfRef().p = SweepRef().c - Mul(XfRef().q, SweepRef().localCenter);
+	FlagIfMoved(previous);
 }
 
 inline void Body::Advance(float alpha)
 {
 	// Advance to the new safe time. This doesn't sync the broad-phase.
-	m_sweep.Advance(alpha);
-	m_sweep.c = m_sweep.c0;
-	m_sweep.a = m_sweep.a0;
-	m_xf.q.Set(m_sweep.a);
-	m_xf.p = m_sweep.c - Mul(m_xf.q, m_sweep.localCenter);
+	const Transform previous = XfRef();
+	SweepRef().Advance(alpha);
+	SweepRef().c = SweepRef().c0;
+	SweepRef().a = SweepRef().a0;
+	XfRef().q.Set(SweepRef().a);
+	XfRef().p = SweepRef().c - Mul(XfRef().q, SweepRef().localCenter);
+	FlagIfMoved(previous);
 }
 
 inline World* Body::GetWorld()
@@ -808,3 +936,12 @@ inline const World* Body::GetWorld() const
 	return m_world;
 }
 
+inline uintptr_t Body::GetUserData() const
+{
+	return m_userData;
+}
+
+inline void Body::SetUserData(uintptr_t data)
+{
+	m_userData = data;
+}
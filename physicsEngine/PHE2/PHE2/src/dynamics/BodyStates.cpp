@@ -0,0 +1,73 @@
+#include "BodyStates.h"
+
+#include <algorithm>
+
+#include "Body.h"
+
+int BodyStates::Add(Body* body)
+{
+	transforms.push_back(Transform());
+	sweeps.push_back(Sweep());
+	linearVelocities.push_back(Vec2(0.0f, 0.0f));
+	angularVelocities.push_back(0.0f);
+	forces.push_back(Vec2(0.0f, 0.0f));
+	torques.push_back(0.0f);
+	invMasses.push_back(0.0f);
+	invInertias.push_back(0.0f);
+	bodies.push_back(body);
+
+	return int(bodies.size()) - 1;
+}
+
+int BodyStates::Add(Body* body, const BodyStates& other, int otherIndex)
+{
+	b2Assert(0 <= otherIndex && otherIndex < other.GetCount());
+
+	transforms.push_back(other.transforms[otherIndex]);
+	sweeps.push_back(other.sweeps[otherIndex]);
+	linearVelocities.push_back(other.linearVelocities[otherIndex]);
+	angularVelocities.push_back(other.angularVelocities[otherIndex]);
+	forces.push_back(other.forces[otherIndex]);
+	torques.push_back(other.torques[otherIndex]);
+	invMasses.push_back(other.invMasses[otherIndex]);
+	invInertias.push_back(other.invInertias[otherIndex]);
+	bodies.push_back(body);
+
+	return int(bodies.size()) - 1;
+}
+
+void BodyStates::Remove(int index)
+{
+	b2Assert(0 <= index && index < GetCount());
+
+	int last = GetCount() - 1;
+	if (index != last)
+	{
+		transforms[index] = transforms[last];
+		sweeps[index] = sweeps[last];
+		linearVelocities[index] = linearVelocities[last];
+		angularVelocities[index] = angularVelocities[last];
+		forces[index] = forces[last];
+		torques[index] = torques[last];
+		invMasses[index] = invMasses[last];
+		invInertias[index] = invInertias[last];
+		bodies[index] = bodies[last];
+		bodies[index]->m_stateIndex = index;
+	}
+
+	transforms.pop_back();
+	sweeps.pop_back();
+	linearVelocities.pop_back();
+	angularVelocities.pop_back();
+	forces.pop_back();
+	torques.pop_back();
+	invMasses.pop_back();
+	invInertias.pop_back();
+	bodies.pop_back();
+}
+
+void BodyStates::ClearForces()
+{
+	std::fill(forces.begin(), forces.end(), Vec2(0.0f, 0.0f));
+	std::fill(torques.begin(), torques.end(), 0.0f);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include "../common/Math.h"
+
+class Body;
+
+/// Hot simulation state of the bodies of a world, one entry per body in dense
+/// parallel arrays. Body keeps the index of its entry and reads its state from here,
+/// so the solver and the force clearing walk contiguous memory.
+/// The order is not stable, removing a body moves the last entry into its slot.
+struct BodyStates
+{
+	/// Append an entry for this body and return its index.
+	int Add(Body* body);
+
+	/// Append an entry for this body with the state of another entry, possibly
+	/// of another world, and return its index.
+	int Add(Body* body, const BodyStates& other, int otherIndex);
+
+	/// Remove an entry, the last entry takes its place.
+	void Remove(int index);
+
+	/// Reset the forces and torques of every body.
+	void ClearForces();
+
+	int GetCount() const
+	{
+		return int(bodies.size());
+	}
+
+	std::vector<Transform> transforms;		///< the body origin transforms
+	std::vector<Sweep> sweeps;				///< the swept motions for CCD
+	std::vector<Vec2> linearVelocities;
+	std::vector<float> angularVelocities;
+	std::vector<Vec2> forces;
+	std::vector<float> torques;
+	std::vector<float> invMasses;
+	std::vector<float> invInertias;			///< inverse rotational inertia about the center of mass
+	std::vector<Body*> bodies;				///< owner of each entry
+
+	/// Bodies flagged moved since the last export, in the order they moved. Not an
+	/// entry array, a body keeps its index here and a destroyed body leaves a null.
+	std::vector<Body*> moved;
+};
@@ -1,7 +1,7 @@
 #pragma once
 #include "Contact.h"
 
-class ChainAndCircleContact : public Contact
+class ChainAndCircleContact final : public Contact
 {
 public:
 	static Contact* Create(	Fixture* fixtureA, int indexA,
@@ -1,7 +1,7 @@
 #pragma once
 #include "Contact.h"
 
-class ChainAndPolygonContact : public Contact
+class ChainAndPolygonContact final : public Contact
 {
 public:
 	static Contact* Create(	Fixture* fixtureA, int indexA,
@@ -1,7 +1,7 @@
 #pragma once
 #include "Contact.h"
 
-class CircleContact : public Contact
+class CircleContact final : public Contact
 {
 public:
 	static Contact* Create(	Fixture* fixtureA, int indexA,
@@ -8,9 +8,11 @@
 #include "EdgeAndCircleContact.h"
 #include "EdgeAndPolygonContact.h"
 #include "WorldCallbacks.h"
+#include "ContactEvents.h"
 
 
 b2ContactRegister Contact::s_registers[Shape::e_typeCount][Shape::e_typeCount];
+std::once_flag Contact::s_initializeFlag;
 bool Contact::s_initialized = false;
 
 void Contact::InitializeRegisters()
@@ -44,11 +46,11 @@ void Contact::AddType(b2ContactCreateFcn* createFcn, b2ContactDestroyFcn* destor
 
 Contact* Contact::Create(Fixture* fixtureA, int indexA, Fixture* fixtureB, int indexB)
 {
-	if (s_initialized == false)
+	std::call_once(s_initializeFlag, []()
 	{
 		InitializeRegisters();
 		s_initialized = true;
-	}
+	});
 
 	Shape::Type type1 = fixtureA->GetType();
 	Shape::Type type2 = fixtureB->GetType();
@@ -103,6 +105,11 @@ Contact::Contact(Fixture* fA, int indexA, Fixture* fB, int indexB)
 {
 	m_flags = e_enabledFlag;
 
+	if (fA->m_enableContactEvents || fB->m_enableContactEvents)
+	{
+		m_flags |= e_reportEventsFlag;
+	}
+
 	m_fixtureA = fA;
 	m_fixtureB = fB;
 
@@ -132,15 +139,11 @@ Contact::Contact(Fixture* fA, int indexA, Fixture* fB, int indexB)
 
 // Update the contact manifold and touching status.
 // Note: do not assume the fixture AABBs are overlapping or are valid.
-void Contact::Update(ContactListener* listener)
+void Contact::Update(ContactListener* listener, ContactEvents* events)
 {
 	Manifold oldManifold = m_manifold;
 
-	// Re-enable this contact.
-	m_flags |= e_enabledFlag;
-
 	bool touching = false;
-	bool wasTouching = (m_flags & e_touchingFlag) == e_touchingFlag;
 
 	bool sensorA = m_fixtureA->IsSensor();
 	bool sensorB = m_fixtureB->IsSensor();
@@ -165,7 +168,21 @@ void Contact::Update(ContactListener* listener)
 	{
 		Evaluate(&m_manifold, xfA, xfB);
 		touching = m_manifold.pointCount > 0;
+	}
+
+	FinishUpdate(oldManifold, touching, sensor, listener, events);
+}
+
+void Contact::FinishUpdate(const Manifold& oldManifold, bool touching, bool sensor,
+							ContactListener* listener, ContactEvents* events)
+{
+	// Re-enable this contact.
+	m_flags |= e_enabledFlag;
+
+	bool wasTouching = (m_flags & e_touchingFlag) == e_touchingFlag;
 
+	if (sensor == false)
+	{
 		// Match old contact ids to new contact ids and copy the
 		// stored impulses to warm start the solver.
 		for (int i = 0; i < m_manifold.pointCount; ++i)
@@ -177,7 +194,7 @@ void Contact::Update(ContactListener* listener)
 
 			for (int j = 0; j < oldManifold.pointCount; ++j)
 			{
-				b2ManifoldPoint* mp1 = oldManifold.points + j;
+				const b2ManifoldPoint* mp1 = oldManifold.points + j;
 
 				if (mp1->id.key == id2.key)
 				{
@@ -190,8 +207,8 @@ void Contact::Update(ContactListener* listener)
 
 		if (touching != wasTouching)
 		{
-			bodyA->SetAwake(true);
-			bodyB->SetAwake(true);
+			m_fixtureA->GetBody()->SetAwake(true);
+			m_fixtureB->GetBody()->SetAwake(true);
 		}
 	}
 
@@ -204,14 +221,30 @@ void Contact::Update(ContactListener* listener)
 		m_flags &= ~e_touchingFlag;
 	}
 
-	if (wasTouching == false && touching == true && listener)
+	if (wasTouching == false && touching == true)
 	{
-		listener->BeginContact(this);
+		if (events && (m_flags & e_reportEventsFlag))
+		{
+			events->beginEvents.push_back({ m_fixtureA, m_fixtureB });
+		}
+
+		if (listener)
+		{
+			listener->BeginContact(this);
+		}
 	}
 
-	if (wasTouching == true && touching == false && listener)
+	if (wasTouching == true && touching == false)
 	{
-		listener->EndContact(this);
+		if (events && (m_flags & e_reportEventsFlag))
+		{
+			events->endEvents.push_back({ m_fixtureA, m_fixtureB });
+		}
+
+		if (listener)
+		{
+			listener->EndContact(this);
+		}
 	}
 
 	if (sensor == false && touching && listener)
@@ -1,4 +1,6 @@
 #pragma once
+#include <mutex>
+
 #include "Fixture.h"
 #include "../collision/CircleShape.h"
 
@@ -10,6 +12,7 @@ class World;
 
 class b2StackAllocator;
 class ContactListener;
+struct ContactEvents;
 
 /// Friction mixing law. The idea is to allow either fixture to drive the friction to zero.
 /// For example, anything slides on ice.
@@ -53,6 +56,7 @@ struct b2ContactEdge
 	Contact* contact;		///< the contact
 	b2ContactEdge* prev;	///< the previous contact edge in the body's contact list
 	b2ContactEdge* next;	///< the next contact edge in the body's contact list
+	int listIndex;			///< index of this edge in the body's contact list
 };
 
 /// The class manages contact between two shapes. A contact exists for each overlapping
@@ -135,6 +139,9 @@ public:
 	/// Get the desired tangent speed. In meters per second.
 	float GetTangentSpeed() const;
 
+	/// Does this contact report begin/end/hit events?
+	bool ReportsEvents() const;
+
 	/// Evaluate this contact with your own manifold and transforms.
 	virtual void Evaluate(Manifold* manifold, const Transform& xfA, const Transform& xfB) = 0;
 
@@ -164,7 +171,10 @@ protected:
 		e_bulletHitFlag		= 0x0010,
 
 		// This contact has a valid TOI in m_toi
-		e_toiFlag			= 0x0020
+		e_toiFlag			= 0x0020,
+
+		// One of the fixtures wants begin/end/hit events
+		e_reportEventsFlag	= 0x0040
 	};
 
 	/// Flag this contact for filtering. Filtering will occur the next time step.
@@ -181,9 +191,16 @@ protected:
 	Contact(Fixture* fixtureA, int indexA, Fixture* fixtureB, int indexB);
 	virtual ~Contact() {}
 
-	void Update(ContactListener* listener);
+	void Update(ContactListener* listener, ContactEvents* events);
+
+	// Second half of Update, once m_manifold holds the new manifold: warm starting,
+	// touching flag and events. Used by the batched narrow phase of ContactManager.
+	void FinishUpdate(const Manifold& oldManifold, bool touching, bool sensor,
+						ContactListener* listener, ContactEvents* events);
 
 	static b2ContactRegister s_registers[Shape::e_typeCount][Shape::e_typeCount];
+	// Worlds may be stepped on several threads, the registers are filled once.
+	static std::once_flag s_initializeFlag;
 	static bool s_initialized;
 
 	unsigned int m_flags;
@@ -192,6 +209,9 @@ protected:
 	b2ContactEdge m_nodeA;
 	b2ContactEdge m_nodeB;
 
+	// Index in the contact list of the world, so a contact is removed in O(1).
+	int m_listIndex;
+
 	Fixture* m_fixtureA;
 	Fixture* m_fixtureB;
 
@@ -253,6 +273,11 @@ inline bool Contact::IsTouching() const
 }
 
 
+inline bool Contact::ReportsEvents() const
+{
+	return (m_flags & e_reportEventsFlag) == e_reportEventsFlag;
+}
+
 inline Fixture* Contact::GetFixtureA()
 {
 	return m_fixtureA;
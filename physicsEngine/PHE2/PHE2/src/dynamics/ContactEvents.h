@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+#include "../common/Math.h"
+
+class Fixture;
+
+/// A begin touch event is generated when two fixtures begin touching.
+struct ContactBeginTouchEvent
+{
+	Fixture* fixtureA;
+	Fixture* fixtureB;
+};
+
+/// An end touch event is generated when two fixtures stop touching.
+/// @warning one of the fixtures may have been destroyed since, only compare the pointers.
+struct ContactEndTouchEvent
+{
+	Fixture* fixtureA;
+	Fixture* fixtureB;
+};
+
+/// A hit event is generated after the solver when two fixtures collide with
+/// an approach speed above b2_hitEventThreshold.
+struct ContactHitEvent
+{
+	Fixture* fixtureA;
+	Fixture* fixtureB;
+
+	/// Point where the fixtures hit, in world coordinates.
+	Vec2 point;
+
+	/// Normal vector pointing from fixture A to fixture B.
+	Vec2 normal;
+
+	/// The speed the fixtures are approaching. Always positive.
+	float approachSpeed;
+
+	/// The largest normal impulse applied by the solver at this contact.
+	float normalImpulse;
+};
+
+/// Contact events buffered by the world during a time step. The buffers are cleared
+/// at the beginning of World::Step and stay valid until the next call. Begin and hit
+/// events of a body are removed when the body is destroyed. The end events of the
+/// contacts destroyed between two steps, by destroying or disabling a body or a
+/// fixture, are reported with the next step.
+/// Only contacts where at least one fixture has contact events enabled are reported.
+/// @see FixtureDef::enableContactEvents
+struct ContactEvents
+{
+	void Clear()
+	{
+		beginEvents.clear();
+		endEvents.clear();
+		hitEvents.clear();
+	}
+
+	std::vector<ContactBeginTouchEvent> beginEvents;
+	std::vector<ContactEndTouchEvent> endEvents;
+	std::vector<ContactHitEvent> hitEvents;
+};
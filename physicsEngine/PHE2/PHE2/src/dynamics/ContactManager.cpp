@@ -1,17 +1,41 @@
 #include "ContactManager.h"
+
 #include "Fixture.h"
 #include "Contact.h"
+#include "CircleContact.h"
+#include "EdgeAndCircleContact.h"
+#include "PolygonAndCircleContact.h"
+#include "PolygonContact.h"
+#include "EdgeAndPolygonContact.h"
+#include "ChainAndCircleContact.h"
+#include "ChainAndPolygonContact.h"
 #include "WorldCallbacks.h"
+#include "../collision/CircleShape.h"
+#include "../collision/EdgeShape.h"
+
+namespace
+{
+	// Swap-and-pop, the order of the contact lists does not matter. The edge that
+	// fills the hole takes over the index.
+	void RemoveEdge(std::vector<b2ContactEdge*>& list, b2ContactEdge* edge)
+	{
+		b2ContactEdge* last = list.back();
+		list[edge->listIndex] = last;
+		last->listIndex = edge->listIndex;
+		list.pop_back();
+	}
+}
 
 ContactFilter b2_defaultFilter;
-ContactListener b2_defaultListener;
 
 ContactManager::ContactManager()
 {
 	m_contactList = {};
 	m_contactCount = 0;
 	m_contactFilter = &b2_defaultFilter;
-	m_contactListener = &b2_defaultListener;
+	m_stepping = false;
+	// No listener by default, game code reads the buffered events instead.
+	m_contactListener = nullptr;
 }
 
 void ContactManager::Destroy(Contact* c)
@@ -21,49 +45,131 @@ void ContactManager::Destroy(Contact* c)
 	Body* bodyA = fixtureA->GetBody();
 	Body* bodyB = fixtureB->GetBody();
 
-	if (m_contactListener && c->IsTouching())
+	if (c->IsTouching())
 	{
-		m_contactListener->EndContact(c);
+		// Outside a step the events of the last step may be read already.
+		if (c->ReportsEvents())
+		{
+			std::vector<ContactEndTouchEvent>& endEvents = m_stepping ? m_contactEvents.endEvents : m_pendingEndEvents;
+			endEvents.push_back({ fixtureA, fixtureB });
+		}
+
+		if (m_contactListener)
+		{
+			m_contactListener->EndContact(c);
+		}
 	}
-	
+
+	// Remove from the world. The last contact takes its place and its index.
+	Contact* last = m_contactList.back();
+	m_contactList[c->m_listIndex] = last;
+	last->m_listIndex = c->m_listIndex;
+	m_contactList.pop_back();
+
+	// Remove from the bodies.
+	RemoveEdge(bodyA->m_contactList, &c->m_nodeA);
+	RemoveEdge(bodyB->m_contactList, &c->m_nodeB);
+
 	// Call the factory.
 	Contact::Destroy(c);
 	--m_contactCount;
 }
 
+// Circles and edge/circle pairs are the bulk of the game contacts, these two
+// batches go through the SIMD kernels instead of one Evaluate per contact.
+template <>
+void ContactManager::CollideBatch<CircleContact>(const std::vector<Contact*>& batch)
+{
+	m_circleBatch.Clear();
+	for (Contact* c : batch)
+	{
+		m_circleBatch.Add((CircleShape*)c->m_fixtureA->GetShape(), c->m_fixtureA->GetBody()->GetTransform(),
+						  (CircleShape*)c->m_fixtureB->GetShape(), c->m_fixtureB->GetBody()->GetTransform());
+	}
+
+	m_batchManifolds.resize(batch.size());
+	b2CollideCirclesBatch(m_batchManifolds.data(), m_circleBatch);
+
+	for (size_t i = 0; i < batch.size(); ++i)
+	{
+		Contact* c = batch[i];
+		Manifold oldManifold = c->m_manifold;
+		c->m_manifold = m_batchManifolds[i];
+		c->FinishUpdate(oldManifold, c->m_manifold.pointCount > 0, false, m_contactListener, &m_contactEvents);
+	}
+}
+
+template <>
+void ContactManager::CollideBatch<EdgeAndCircleContact>(const std::vector<Contact*>& batch)
+{
+	m_edgeCircleBatch.Clear();
+	for (Contact* c : batch)
+	{
+		m_edgeCircleBatch.Add((EdgeShape*)c->m_fixtureA->GetShape(), c->m_fixtureA->GetBody()->GetTransform(),
+							  (CircleShape*)c->m_fixtureB->GetShape(), c->m_fixtureB->GetBody()->GetTransform());
+	}
+
+	m_batchManifolds.resize(batch.size());
+	b2CollideEdgeAndCircleBatch(m_batchManifolds.data(), m_edgeCircleBatch);
+
+	for (size_t i = 0; i < batch.size(); ++i)
+	{
+		Contact* c = batch[i];
+		Manifold oldManifold = c->m_manifold;
+		c->m_manifold = m_batchManifolds[i];
+		c->FinishUpdate(oldManifold, c->m_manifold.pointCount > 0, false, m_contactListener, &m_contactEvents);
+	}
+}
+
 // This is the top level collision call for the time step. Here
 // all the narrow phase collision is processed for the world
 // contact list.
 void ContactManager::Collide()
 {
-	// Update awake contacts.
-	for (auto c: m_contactList)
+	for (auto& row : m_batches)
+	{
+		for (std::vector<Contact*>& batch : row)
+		{
+			batch.clear();
+		}
+	}
+
+	// Filter the contacts and group the awake ones by shape types.
+	// Destroy moves the last contact to the current index, so only
+	// advance when the contact is kept.
+	for (int i = 0; i < int(m_contactList.size()); )
 	{
+		Contact* c = m_contactList[i];
 		Fixture* fixtureA = c->GetFixtureA();
 		Fixture* fixtureB = c->GetFixtureB();
 		int indexA = c->GetChildIndexA();
 		int indexB = c->GetChildIndexB();
 		Body* bodyA = fixtureA->GetBody();
 		Body* bodyB = fixtureB->GetBody();
-		 
+		int proxyIdA = fixtureA->m_proxies[indexA].proxyId;
+		int proxyIdB = fixtureB->m_proxies[indexB].proxyId;
+
 		// Is this contact flagged for filtering?
 		if (c->m_flags & Contact::e_filterFlag)
 		{
+			// Are the layers still colliding?
+			if (m_broadPhase.TestLayers(proxyIdA, proxyIdB) == false)
+			{
+				Destroy(c);
+				continue;
+			}
+
 			// Should these bodies collide?
 			if (bodyB->ShouldCollide(bodyA) == false)
 			{
-				Contact* cNuke = c;
-				c = cNuke->GetNext();
-				Destroy(cNuke);
+				Destroy(c);
 				continue;
 			}
 
 			// Check user filtering.
 			if (m_contactFilter && m_contactFilter->ShouldCollide(fixtureA, fixtureB) == false)
 			{
-				Contact* cNuke = c;
-				c = cNuke->GetNext();
-				Destroy(cNuke);
+				Destroy(c);
 				continue;
 			}
 
@@ -77,25 +183,58 @@ void ContactManager::Collide()
 		// At least one body must be awake and it must be dynamic or kinematic.
 		if (activeA == false && activeB == false)
 		{
-			c = c->GetNext();
+			++i;
 			continue;
 		}
 
-		int proxyIdA = fixtureA->m_proxies[indexA]->proxyId;
-		int proxyIdB = fixtureB->m_proxies[indexB]->proxyId;
 		bool overlap = m_broadPhase.TestOverlap(proxyIdA, proxyIdB);
 
 		// Here we destroy contacts that cease to overlap in the broad-phase.
 		if (overlap == false)
 		{
-			Contact* cNuke = c;
-			c = cNuke->GetNext();
-			Destroy(cNuke);
+			Destroy(c);
 			continue;
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		if (fixtureA->IsSensor() || fixtureB->IsSensor())
+		{
+			// Sensors only test overlap, keep them off the batches.
+			c->Update(m_contactListener, &m_contactEvents);
+		}
+		else
+		{
+			m_batches[fixtureA->GetType()][fixtureB->GetType()].push_back(c);
+		}
+
+		++i;
+	}
+
+	// Contact creation puts the fixtures in the order of the registered types,
+	// so these are the only batches that get filled.
+	CollideBatch<CircleContact>(m_batches[Shape::e_circle][Shape::e_circle]);
+	CollideBatch<EdgeAndCircleContact>(m_batches[Shape::e_edge][Shape::e_circle]);
+	CollideBatch<PolygonAndCircleContact>(m_batches[Shape::e_polygon][Shape::e_circle]);
+	CollideBatch<PolygonContact>(m_batches[Shape::e_polygon][Shape::e_polygon]);
+	CollideBatch<EdgeAndPolygonContact>(m_batches[Shape::e_edge][Shape::e_polygon]);
+	CollideBatch<ChainAndCircleContact>(m_batches[Shape::e_chain][Shape::e_circle]);
+	CollideBatch<ChainAndPolygonContact>(m_batches[Shape::e_chain][Shape::e_polygon]);
+}
+
+template <typename T>
+void ContactManager::CollideBatch(const std::vector<Contact*>& batch)
+{
+	for (Contact* c : batch)
+	{
+		Manifold oldManifold = c->m_manifold;
+
+		const Transform& xfA = c->m_fixtureA->GetBody()->GetTransform();
+		const Transform& xfB = c->m_fixtureB->GetBody()->GetTransform();
+
+		// Qualified call, no virtual dispatch.
+		static_cast<T*>(c)->T::Evaluate(&c->m_manifold, xfA, xfB);
+
+		c->FinishUpdate(oldManifold, c->m_manifold.pointCount > 0, false, m_contactListener, &m_contactEvents);
 	}
 }
 
@@ -175,15 +314,23 @@ void ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 	bodyA = fixtureA->GetBody();
 	bodyB = fixtureB->GetBody();
 
+	// Insert into the world.
+	c->m_listIndex = int(m_contactList.size());
+	m_contactList.push_back(c);
+
 	// Connect to island graph.
 
 	// Connect to body A
 	c->m_nodeA.contact = c;
 	c->m_nodeA.other = bodyB;
+	c->m_nodeA.listIndex = int(bodyA->m_contactList.size());
+	bodyA->m_contactList.push_back(&c->m_nodeA);
 
 	// Connect to body B
 	c->m_nodeB.contact = c;
 	c->m_nodeB.other = bodyA;
+	c->m_nodeB.listIndex = int(bodyB->m_contactList.size());
+	bodyB->m_contactList.push_back(&c->m_nodeB);
 
 	++m_contactCount;
 }
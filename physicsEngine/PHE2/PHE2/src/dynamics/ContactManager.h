@@ -1,6 +1,9 @@
 #pragma once
 #include <vector>
 #include "../collision/BroadPhase.h"
+#include "../collision/Shape.h"
+#include "../collision/ManifoldBatch.h"
+#include "ContactEvents.h"
 
 class Contact;
 class ContactFilter;
@@ -21,9 +24,28 @@ public:
 
 	void Collide();
 
+	// Run the narrow phase over a batch of contacts of the same concrete type.
+	template <typename T>
+	void CollideBatch(const std::vector<Contact*>& batch);
+
 	BroadPhase m_broadPhase;
 	std::vector<Contact*> m_contactList;
 	int m_contactCount;
 	ContactFilter* m_contactFilter;
 	ContactListener* m_contactListener;
+
+	// Begin/end/hit events of the current step.
+	ContactEvents m_contactEvents;
+
+	// End events of the contacts destroyed between two steps, reported with the next step.
+	std::vector<ContactEndTouchEvent> m_pendingEndEvents;
+	bool m_stepping;
+
+	// Contacts to update this step, grouped by fixture A and fixture B shape types.
+	std::vector<Contact*> m_batches[Shape::e_typeCount][Shape::e_typeCount];
+
+	// Scratch buffers of the SIMD manifold kernels, kept to reuse their capacity.
+	CircleCircleBatch m_circleBatch;
+	EdgeCircleBatch m_edgeCircleBatch;
+	std::vector<Manifold> m_batchManifolds;
 };
@@ -29,8 +29,8 @@ ContactSolver::ContactSolver(ContactSolverDef* def)
 {
 	m_step = def->step;
 	m_count = def->count;
-	m_positionConstraints = std::vector<ContactPositionConstraint*>(m_count);
-	m_velocityConstraints = std::vector<ContactVelocityConstraint*>(m_count);
+	m_positionConstraints = std::vector<ContactPositionConstraint>(m_count);
+	m_velocityConstraints = std::vector<ContactVelocityConstraint>(m_count);
 	m_positions = def->positions;
 	m_velocities = def->velocities;
 	m_contacts = def->contacts;
@@ -53,31 +53,31 @@ ContactSolver::ContactSolver(ContactSolverDef* def)
 		int pointCount = manifold->pointCount;
 		b2Assert(pointCount > 0);
 
-		ContactVelocityConstraint* vc = m_velocityConstraints[i];
+		ContactVelocityConstraint* vc = &m_velocityConstraints[i];
 		vc->friction = contact->m_friction;
 		vc->restitution = contact->m_restitution;
 		vc->threshold = contact->m_restitutionThreshold;
 		vc->tangentSpeed = contact->m_tangentSpeed;
 		vc->indexA = bodyA->m_islandIndex;
 		vc->indexB = bodyB->m_islandIndex;
-		vc->invMassA = bodyA->m_invMass;
-		vc->invMassB = bodyB->m_invMass;
-		vc->invIA = bodyA->m_invI;
-		vc->invIB = bodyB->m_invI;
+		vc->invMassA = bodyA->InvMassRef();
+		vc->invMassB = bodyB->InvMassRef();
+		vc->invIA = bodyA->InvIRef();
+		vc->invIB = bodyB->InvIRef();
 		vc->contactIndex = i;
 		vc->pointCount = pointCount;
 		vc->K.SetZero();
 		vc->normalMass.SetZero();
 
-		ContactPositionConstraint* pc = m_positionConstraints[i];
+		ContactPositionConstraint* pc = &m_positionConstraints[i];
 		pc->indexA = bodyA->m_islandIndex;
 		pc->indexB = bodyB->m_islandIndex;
-		pc->invMassA = bodyA->m_invMass;
-		pc->invMassB = bodyB->m_invMass;
-		pc->localCenterA = bodyA->m_sweep.localCenter;
-		pc->localCenterB = bodyB->m_sweep.localCenter;
-		pc->invIA = bodyA->m_invI;
-		pc->invIB = bodyB->m_invI;
+		pc->invMassA = bodyA->InvMassRef();
+		pc->invMassB = bodyB->InvMassRef();
+		pc->localCenterA = bodyA->SweepRef().localCenter;
+		pc->localCenterB = bodyB->SweepRef().localCenter;
+		pc->invIA = bodyA->InvIRef();
+		pc->invIB = bodyB->InvIRef();
 		pc->localNormal = manifold->localNormal;
 		pc->localPoint = manifold->localPoint;
 		pc->pointCount = pointCount;
@@ -106,6 +106,7 @@ ContactSolver::ContactSolver(ContactSolverDef* def)
 			vcp->normalMass = 0.0f;
 			vcp->tangentMass = 0.0f;
 			vcp->velocityBias = 0.0f;
+			vcp->relativeVelocity = 0.0f;
 
 			pc->localPoints[j] = cp->localPoint;
 		}
@@ -121,8 +122,8 @@ void ContactSolver::InitializeVelocityConstraints()
 {
 	for (int i = 0; i < m_count; ++i)
 	{
-		ContactVelocityConstraint* vc = m_velocityConstraints[i];
-		ContactPositionConstraint* pc = m_positionConstraints[i];
+		ContactVelocityConstraint* vc = &m_velocityConstraints[i];
+		ContactPositionConstraint* pc = &m_positionConstraints[i];
 
 		float radiusA = pc->radiusA;
 		float radiusB = pc->radiusB;
@@ -138,15 +139,15 @@ void ContactSolver::InitializeVelocityConstraints()
 		Vec2 localCenterA = pc->localCenterA;
 		Vec2 localCenterB = pc->localCenterB;
 
-		Vec2 cA = m_positions[indexA]->c;
-		float aA = m_positions[indexA]->a;
-		Vec2 vA = m_velocities[indexA]->v;
-		float wA = m_velocities[indexA]->w;
+		Vec2 cA = m_positions[indexA].c;
+		float aA = m_positions[indexA].a;
+		Vec2 vA = m_velocities[indexA].v;
+		float wA = m_velocities[indexA].w;
 
-		Vec2 cB = m_positions[indexB]->c;
-		float aB = m_positions[indexB]->a;
-		Vec2 vB = m_velocities[indexB]->v;
-		float wB = m_velocities[indexB]->w;
+		Vec2 cB = m_positions[indexB].c;
+		float aB = m_positions[indexB].a;
+		Vec2 vB = m_velocities[indexB].v;
+		float wB = m_velocities[indexB].w;
 
 		b2Assert(manifold->pointCount > 0);
 
@@ -188,6 +189,7 @@ void ContactSolver::InitializeVelocityConstraints()
 			// Setup a velocity bias for restitution.
 			vcp->velocityBias = 0.0f;
 			float vRel = Dot(vc->normal, vB + Cross(wB, vcp->rB) - vA - Cross(wA, vcp->rA));
+			vcp->relativeVelocity = vRel;
 			if (vRel < -vc->threshold)
 			{
 				vcp->velocityBias = -vc->restitution * vRel;
@@ -233,7 +235,7 @@ void ContactSolver::WarmStart()
 	// Warm start.
 	for (int i = 0; i < m_count; ++i)
 	{
-		ContactVelocityConstraint* vc = m_velocityConstraints[i];
+		ContactVelocityConstraint* vc = &m_velocityConstraints[i];
 
 		int indexA = vc->indexA;
 		int indexB = vc->indexB;
@@ -243,10 +245,10 @@ void ContactSolver::WarmStart()
 		float iB = vc->invIB;
 		int pointCount = vc->pointCount;
 
-		Vec2 vA = m_velocities[indexA]->v;
-		float wA = m_velocities[indexA]->w;
-		Vec2 vB = m_velocities[indexB]->v;
-		float wB = m_velocities[indexB]->w;
+		Vec2 vA = m_velocities[indexA].v;
+		float wA = m_velocities[indexA].w;
+		Vec2 vB = m_velocities[indexB].v;
+		float wB = m_velocities[indexB].w;
 
 		Vec2 normal = vc->normal;
 		Vec2 tangent = Cross(normal, 1.0f);
@@ -261,10 +263,10 @@ void ContactSolver::WarmStart()
 			vB += mB * P;
 		}
 
-		m_velocities[indexA]->v = vA;
-		m_velocities[indexA]->w = wA;
-		m_velocities[indexB]->v = vB;
-		m_velocities[indexB]->w = wB;
+		m_velocities[indexA].v = vA;
+		m_velocities[indexA].w = wA;
+		m_velocities[indexB].v = vB;
+		m_velocities[indexB].w = wB;
 	}
 }
 
@@ -272,7 +274,7 @@ void ContactSolver::SolveVelocityConstraints()
 {
 	for (int i = 0; i < m_count; ++i)
 	{
-		ContactVelocityConstraint* vc = m_velocityConstraints[i];
+		ContactVelocityConstraint* vc = &m_velocityConstraints[i];
 
 		int indexA = vc->indexA;
 		int indexB = vc->indexB;
@@ -282,10 +284,10 @@ void ContactSolver::SolveVelocityConstraints()
 		float iB = vc->invIB;
 		int pointCount = vc->pointCount;
 
-		Vec2 vA = m_velocities[indexA]->v;
-		float wA = m_velocities[indexA]->w;
-		Vec2 vB = m_velocities[indexB]->v;
-		float wB = m_velocities[indexB]->w;
+		Vec2 vA = m_velocities[indexA].v;
+		float wA = m_velocities[indexA].w;
+		Vec2 vB = m_velocities[indexB].v;
+		float wB = m_velocities[indexB].w;
 
 		Vec2 normal = vc->normal;
 		Vec2 tangent = Cross(normal, 1.0f);
@@ -573,10 +575,10 @@ void ContactSolver::SolveVelocityConstraints()
 			}
 		}
 
-		m_velocities[indexA]->v = vA;
-		m_velocities[indexA]->w = wA;
-		m_velocities[indexB]->v = vB;
-		m_velocities[indexB]->w = wB;
+		m_velocities[indexA].v = vA;
+		m_velocities[indexA].w = wA;
+		m_velocities[indexB].v = vB;
+		m_velocities[indexB].w = wB;
 	}
 }
 
@@ -584,7 +586,7 @@ void ContactSolver::StoreImpulses()
 {
 	for (int i = 0; i < m_count; ++i)
 	{
-		ContactVelocityConstraint* vc = m_velocityConstraints[i];
+		ContactVelocityConstraint* vc = &m_velocityConstraints[i];
 		Manifold* manifold = m_contacts[vc->contactIndex]->GetManifold();
 
 		for (int j = 0; j < vc->pointCount; ++j)
@@ -653,7 +655,7 @@ bool ContactSolver::SolvePositionConstraints()
 
 	for (int i = 0; i < m_count; ++i)
 	{
-		ContactPositionConstraint* pc = m_positionConstraints[i];
+		ContactPositionConstraint* pc = &m_positionConstraints[i];
 
 		int indexA = pc->indexA;
 		int indexB = pc->indexB;
@@ -665,11 +667,11 @@ bool ContactSolver::SolvePositionConstraints()
 		float iB = pc->invIB;
 		int pointCount = pc->pointCount;
 
-		Vec2 cA = m_positions[indexA]->c;
-		float aA = m_positions[indexA]->a;
+		Vec2 cA = m_positions[indexA].c;
+		float aA = m_positions[indexA].a;
 
-		Vec2 cB = m_positions[indexB]->c;
-		float aB = m_positions[indexB]->a;
+		Vec2 cB = m_positions[indexB].c;
+		float aB = m_positions[indexB].a;
 
 		// Solve normal constraints
 		for (int j = 0; j < pointCount; ++j)
@@ -713,11 +715,11 @@ bool ContactSolver::SolvePositionConstraints()
 			aB += iB * Cross(rB, P);
 		}
 
-		m_positions[indexA]->c = cA;
-		m_positions[indexA]->a = aA;
+		m_positions[indexA].c = cA;
+		m_positions[indexA].a = aA;
 
-		m_positions[indexB]->c = cB;
-		m_positions[indexB]->a = aB;
+		m_positions[indexB].c = cB;
+		m_positions[indexB].a = aB;
 	}
 
 	// We can't expect minSpeparation >= -b2_linearSlop because we don't
@@ -732,7 +734,7 @@ bool ContactSolver::SolveTOIPositionConstraints(int toiIndexA, int toiIndexB)
 
 	for (int i = 0; i < m_count; ++i)
 	{
-		ContactPositionConstraint* pc = m_positionConstraints[i];
+		ContactPositionConstraint* pc = &m_positionConstraints[i];
 
 		int indexA = pc->indexA;
 		int indexB = pc->indexB;
@@ -756,11 +758,11 @@ bool ContactSolver::SolveTOIPositionConstraints(int toiIndexA, int toiIndexB)
 			iB = pc->invIB;
 		}
 
-		Vec2 cA = m_positions[indexA]->c;
-		float aA = m_positions[indexA]->a;
+		Vec2 cA = m_positions[indexA].c;
+		float aA = m_positions[indexA].a;
 
-		Vec2 cB = m_positions[indexB]->c;
-		float aB = m_positions[indexB]->a;
+		Vec2 cB = m_positions[indexB].c;
+		float aB = m_positions[indexB].a;
 
 		// Solve normal constraints
 		for (int j = 0; j < pointCount; ++j)
@@ -804,11 +806,11 @@ bool ContactSolver::SolveTOIPositionConstraints(int toiIndexA, int toiIndexB)
 			aB += iB * Cross(rB, P);
 		}
 
-		m_positions[indexA]->c = cA;
-		m_positions[indexA]->a = aA;
+		m_positions[indexA].c = cA;
+		m_positions[indexA].a = aA;
 
-		m_positions[indexB]->c = cB;
-		m_positions[indexB]->a = aB;
+		m_positions[indexB].c = cB;
+		m_positions[indexB].a = aB;
 	}
 
 	// We can't expect minSpeparation >= -b2_linearSlop because we don't
@@ -17,6 +17,7 @@ struct VelocityConstraintPoint
 	float normalMass;
 	float tangentMass;
 	float velocityBias;
+	float relativeVelocity;
 };
 
 struct ContactVelocityConstraint
@@ -42,8 +43,8 @@ struct ContactSolverDef
 	TimeStep step;
 	std::vector<Contact*> contacts;
 	int count;
-	std::vector<Position*> positions;
-	std::vector<Velocity*> velocities;
+	Position* positions;
+	Velocity* velocities;
 };
 
 class ContactSolver
@@ -62,10 +63,10 @@ public:
 	bool SolveTOIPositionConstraints(int toiIndexA, int toiIndexB);
 
 	TimeStep m_step;
-	std::vector<Position*> m_positions;
-	std::vector<Velocity*> m_velocities;
-	std::vector<ContactPositionConstraint*> m_positionConstraints;
-	std::vector<ContactVelocityConstraint*> m_velocityConstraints;
+	Position* m_positions;
+	Velocity* m_velocities;
+	std::vector<ContactPositionConstraint> m_positionConstraints;
+	std::vector<ContactVelocityConstraint> m_velocityConstraints;
 	std::vector<Contact*> m_contacts;
 	int m_count;
 };
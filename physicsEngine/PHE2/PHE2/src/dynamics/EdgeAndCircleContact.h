@@ -1,7 +1,7 @@
 #pragma once
 #include "Contact.h"
 
-class EdgeAndCircleContact : public Contact
+class EdgeAndCircleContact final : public Contact
 {
 public:
 	static Contact* Create(	Fixture* fixtureA, int indexA,
@@ -2,7 +2,7 @@
 
 #include "Contact.h"
 
-class EdgeAndPolygonContact : public Contact
+class EdgeAndPolygonContact final : public Contact
 {
 public:
 	static Contact* Create(	Fixture* fixtureA, int indexA, Fixture* fixtureB, int indexB);
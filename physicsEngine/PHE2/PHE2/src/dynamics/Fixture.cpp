@@ -13,7 +13,9 @@ Fixture::Fixture()
 	m_proxies = {};
 	m_proxyCount = 0;
 	m_shape = nullptr;
+	m_sharedShape = nullptr;
 	m_density = 0.0f;
+	m_enableContactEvents = false;
 }
 
 void Fixture::Create(Body* body, const FixtureDef* def)
@@ -28,16 +30,28 @@ void Fixture::Create(Body* body, const FixtureDef* def)
 	m_filter = def->filter;
 
 	m_isSensor = def->isSensor;
+	m_enableContactEvents = def->enableContactEvents;
 
-	m_shape = def->shape->Clone();
+	m_sharedShape = nullptr;
+	if (def->shareShape)
+	{
+		m_sharedShape = body->GetWorld()->m_shapeCache.Acquire(def->shape);
+	}
+	m_shape = m_sharedShape ? m_sharedShape->shape : def->shape->Clone();
+
+	// Static shapes are shared with the clones of the world from the start.
+	if (m_sharedShape == nullptr && body->GetType() == b2_staticBody)
+	{
+		m_clonedShape.reset(m_shape);
+	}
 
 	// Reserve proxy space
 	int childCount = m_shape->GetChildCount();
-	m_proxies = std::vector<FixtureProxy*>(childCount);
+	m_proxies = std::vector<FixtureProxy>(childCount);
 	for (int i = 0; i < childCount; ++i)
 	{
-		m_proxies[i]->fixture = nullptr;
-		m_proxies[i]->proxyId = BroadPhase::e_nullProxy;
+		m_proxies[i].fixture = nullptr;
+		m_proxies[i].proxyId = BroadPhase::e_nullProxy;
 	}
 	m_proxyCount = 0;
 
@@ -52,6 +66,23 @@ void Fixture::Destroy()
 	// Free the proxy array.
 	m_proxies.clear();
 
+	// Shared shapes belong to the world.
+	if (m_sharedShape)
+	{
+		m_body->GetWorld()->m_shapeCache.Release(m_sharedShape);
+		m_sharedShape = nullptr;
+		m_shape = nullptr;
+		return;
+	}
+
+	// Shapes shared with world clones go with their last fixture.
+	if (m_clonedShape)
+	{
+		m_clonedShape.reset();
+		m_shape = nullptr;
+		return;
+	}
+
 	// Free the child shape.
 	switch (m_shape->m_type)
 	{
@@ -100,9 +131,9 @@ void Fixture::CreateProxies(BroadPhase* broadPhase, const Transform& xf)
 
 	for (int i = 0; i < m_proxyCount; ++i)
 	{
-		FixtureProxy* proxy = m_proxies[i];
+		FixtureProxy* proxy = &m_proxies[i];
 		m_shape->ComputeAABB(&proxy->aabb, xf, i);
-		proxy->proxyId = broadPhase->CreateProxy(proxy->aabb, proxy);
+		proxy->proxyId = broadPhase->CreateProxy(proxy->aabb, proxy, m_filter.layer);
 		proxy->fixture = this;
 		proxy->childIndex = i;
 	}
@@ -113,7 +144,7 @@ void Fixture::DestroyProxies(BroadPhase* broadPhase)
 	// Destroy proxies in the broad-phase.
 	for (int i = 0; i < m_proxyCount; ++i)
 	{
-		FixtureProxy* proxy = m_proxies[i];
+		FixtureProxy* proxy = &m_proxies[i];
 		broadPhase->DestroyProxy(proxy->proxyId);
 		proxy->proxyId = BroadPhase::e_nullProxy;
 	}
@@ -130,7 +161,7 @@ void Fixture::Synchronize(BroadPhase* broadPhase, const Transform& transform1, c
 
 	for (int i = 0; i < m_proxyCount; ++i)
 	{
-		FixtureProxy* proxy = m_proxies[i];
+		FixtureProxy* proxy = &m_proxies[i];
 
 		// Compute an AABB that covers the swept shape (may miss some rotation effect).
 		AABB aabb1, aabb2;
@@ -141,7 +172,8 @@ void Fixture::Synchronize(BroadPhase* broadPhase, const Transform& transform1, c
 
 		Vec2 displacement = aabb2.GetCenter() - aabb1.GetCenter();
 
-		broadPhase->MoveProxy(proxy->proxyId, proxy->aabb, displacement);
+		// Applied by the caller with BroadPhase::ApplyMoves.
+		broadPhase->QueueMove(proxy->proxyId, proxy->aabb, displacement);
 	}
 }
 
@@ -184,7 +216,8 @@ void Fixture::Refilter()
 	BroadPhase* broadPhase = &world->m_contactManager.m_broadPhase;
 	for (int i = 0; i < m_proxyCount; ++i)
 	{
-		broadPhase->TouchProxy(m_proxies[i]->proxyId);
+		broadPhase->SetProxyLayer(m_proxies[i].proxyId, m_filter.layer);
+		broadPhase->TouchProxy(m_proxies[i].proxyId);
 	}
 }
 
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <memory>
+
 #include "../common/Common.h"
 #include "../collision/Shape.h"
 #include "Body.h"
+#include "ShapeCache.h"
 #include "../collision/BroadPhase.h"
 
 
@@ -16,6 +19,7 @@ struct Filter
 		categoryBits = 0x0001;
 		maskBits = 0xFFFF;
 		groupIndex = 0;
+		layer = 0;
 	}
 
 	/// The collision category bits. Normally you would just set one bit.
@@ -29,6 +33,11 @@ struct Filter
 	/// or always collide (positive). Zero means no collision group. Non-zero group
 	/// filtering always wins against the mask bits.
 	short groupIndex;
+
+	/// The collision layer, in [0, b2_maxCollisionLayers). Layers are checked
+	/// in the broad-phase against the world layer matrix, before the bits above.
+	/// @see World::SetLayerCollision
+	unsigned char layer;
 };
 
 /// A fixture definition is used to create a fixture. This class defines an
@@ -44,6 +53,8 @@ struct FixtureDef
 		restitutionThreshold = 1.0f * b2_lengthUnitsPerMeter;
 		density = 0.0f;
 		isSensor = false;
+		enableContactEvents = false;
+		shareShape = false;
 	}
 
 	/// The shape, this must be set. The shape will be cloned, so you
@@ -67,8 +78,17 @@ struct FixtureDef
 	/// response.
 	bool isSensor;
 
+	/// Report begin, end and hit events for contacts involving this fixture.
+	/// @see World::GetContactEvents
+	bool enableContactEvents;
+
 	/// Contact filtering data.
 	Filter filter;
+
+	/// Reference a world-owned shape shared by every fixture with the same geometry
+	/// instead of cloning the shape. The shared shape must not be modified.
+	/// Chain shapes are always cloned.
+	bool shareShape;
 };
 
 /// This proxy is used internally to connect fixtures to the broad-phase.
@@ -105,6 +125,13 @@ public:
 	/// @return the true if the shape is a sensor.
 	bool IsSensor() const;
 
+	/// Enable/disable contact events for this fixture. This does not affect
+	/// existing contacts.
+	void SetContactEventsEnabled(bool flag);
+
+	/// Does this fixture report contact events?
+	bool AreContactEventsEnabled() const;
+
 	/// Set the contact filtering data. This will not update contacts until the next time
 	/// step when either parent body is active and awake.
 	/// This automatically calls Refilter.
@@ -203,17 +230,23 @@ protected:
 	Body* m_body;
 
 	Shape* m_shape;
+	SharedShape* m_sharedShape;
+
+	// Owns the shape of a static fixture, the fixtures of the clones of the world
+	// hold the same shape. See World::Clone.
+	std::shared_ptr<Shape> m_clonedShape;
 
 	float m_friction;
 	float m_restitution;
 	float m_restitutionThreshold;
 
-	std::vector<FixtureProxy*> m_proxies;
+	std::vector<FixtureProxy> m_proxies;
 	int m_proxyCount;
 
 	Filter m_filter;
 
 	bool m_isSensor;
+	bool m_enableContactEvents;
 };
 
 inline Shape::Type Fixture::GetType() const
@@ -236,6 +269,16 @@ inline bool Fixture::IsSensor() const
 	return m_isSensor;
 }
 
+inline void Fixture::SetContactEventsEnabled(bool flag)
+{
+	m_enableContactEvents = flag;
+}
+
+inline bool Fixture::AreContactEventsEnabled() const
+{
+	return m_enableContactEvents;
+}
+
 inline const Filter& Fixture::GetFilterData() const
 {
 	return m_filter;
@@ -314,11 +357,20 @@ inline bool Fixture::RayCast(b2RayCastOutput* output, const b2RayCastInput& inpu
 
 inline void Fixture::GetMassData(MassData* massData) const
 {
+	if (m_sharedShape)
+	{
+		// Mass data scales with the density.
+		massData->mass = m_density * m_sharedShape->unitMassData.mass;
+		massData->center = m_sharedShape->unitMassData.center;
+		massData->I = m_density * m_sharedShape->unitMassData.I;
+		return;
+	}
+
 	m_shape->ComputeMass(massData, m_density);
 }
 
 inline const AABB& Fixture::GetAABB(int childIndex) const
 {
 	b2Assert(0 <= childIndex && childIndex < m_proxyCount);
-	return m_proxies[childIndex]->aabb;
+	return m_proxies[childIndex].aabb;
 }
@@ -1,6 +1,8 @@
 #include "Island.h"
 #include "WorldCallbacks.h"
 #include "ContactSolver.h"
+#include "ContactEvents.h"
+#include "Contact.h"
 #include "../common/Timer.h"
 
 /*
@@ -124,7 +126,8 @@ However, we can compute sin+cos of the same angle fast.
 Island::Island(
 	int bodyCapacity,
 	int contactCapacity,
-	ContactListener* listener)
+	ContactListener* listener,
+	ContactEvents* events)
 {
 	m_bodyCapacity = bodyCapacity;
 	m_contactCapacity = contactCapacity;
@@ -132,12 +135,13 @@ Island::Island(
 	m_contactCount = 0;
 
 	m_listener = listener;
+	m_events = events;
 
 	m_bodies = std::vector<Body*>(m_bodyCapacity);
 	m_contacts = std::vector<Contact*>(m_contactCapacity);
 
-	m_velocities = std::vector<Velocity*>(m_bodyCapacity);
-	m_positions = std::vector<Position*>(m_bodyCapacity);
+	m_velocities = std::vector<Velocity>(m_bodyCapacity);
+	m_positions = std::vector<Position>(m_bodyCapacity);
 
 }
 
@@ -157,20 +161,20 @@ void Island::Solve(const TimeStep& step, const Vec2& gravity, bool allowSleep)
 	{
 		Body* b = m_bodies[i];
 
-		Vec2 c = b->m_sweep.c;
-		float a = b->m_sweep.a;
-		Vec2 v = b->m_linearVelocity;
-		float w = b->m_angularVelocity;
+		Vec2 c = b->SweepRef().c;
+		float a = b->SweepRef().a;
+		Vec2 v = b->LinearVelocityRef();
+		float w = b->AngularVelocityRef();
 
 		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		b->SweepRef().c0 = b->SweepRef().c;
+		b->SweepRef().a0 = b->SweepRef().a;
 
 		if (b->m_type == dynamicBody)
 		{
 			// Integrate velocities.
-			v += h * b->m_invMass * (b->m_gravityScale * b->m_mass * gravity + b->m_force);
-			w += h * b->m_invI * b->m_torque;
+			v += h * b->InvMassRef() * (b->m_gravityScale * b->m_mass * gravity + b->ForceRef());
+			w += h * b->InvIRef() * b->TorqueRef();
 
 			// Apply damping.
 			// ODE: dv/dt + c * v = 0
@@ -183,10 +187,10 @@ void Island::Solve(const TimeStep& step, const Vec2& gravity, bool allowSleep)
 			w *= 1.0f / (1.0f + h * b->m_angularDamping);
 		}
 
-		m_positions[i]->c = c;
-		m_positions[i]->a = a;
-		m_velocities[i]->v = v;
-		m_velocities[i]->w = w;
+		m_positions[i].c = c;
+		m_positions[i].a = a;
+		m_velocities[i].v = v;
+		m_velocities[i].w = w;
 	}
 
 	timer.Reset();
@@ -194,16 +198,16 @@ void Island::Solve(const TimeStep& step, const Vec2& gravity, bool allowSleep)
 	// Solver data
 	SolverData solverData;
 	solverData.step = step;
-	solverData.positions = m_positions;
-	solverData.velocities = m_velocities;
+	solverData.positions = m_positions.data();
+	solverData.velocities = m_velocities.data();
 
 	// Initialize velocity constraints.
 	ContactSolverDef contactSolverDef;
 	contactSolverDef.step = step;
 	contactSolverDef.contacts = m_contacts;
 	contactSolverDef.count = m_contactCount;
-	contactSolverDef.positions = m_positions;
-	contactSolverDef.velocities = m_velocities;
+	contactSolverDef.positions = m_positions.data();
+	contactSolverDef.velocities = m_velocities.data();
 
 	ContactSolver contactSolver(&contactSolverDef);
 	contactSolver.InitializeVelocityConstraints();
@@ -226,10 +230,10 @@ void Island::Solve(const TimeStep& step, const Vec2& gravity, bool allowSleep)
 	// Integrate positions
 	for (int i = 0; i < m_bodyCount; ++i)
 	{
-		Vec2 c = m_positions[i]->c;
-		float a = m_positions[i]->a;
-		Vec2 v = m_velocities[i]->v;
-		float w = m_velocities[i]->w;
+		Vec2 c = m_positions[i].c;
+		float a = m_positions[i].a;
+		Vec2 v = m_velocities[i].v;
+		float w = m_velocities[i].w;
 
 		// Check for large velocities
 		Vec2 translation = h * v;
@@ -250,10 +254,10 @@ void Island::Solve(const TimeStep& step, const Vec2& gravity, bool allowSleep)
 		c += h * v;
 		a += h * w;
 
-		m_positions[i]->c = c;
-		m_positions[i]->a = a;
-		m_velocities[i]->v = v;
-		m_velocities[i]->w = w;
+		m_positions[i].c = c;
+		m_positions[i].a = a;
+		m_velocities[i].v = v;
+		m_velocities[i].w = w;
 	}
 
 	// Solve position constraints
@@ -275,10 +279,10 @@ void Island::Solve(const TimeStep& step, const Vec2& gravity, bool allowSleep)
 	for (int i = 0; i < m_bodyCount; ++i)
 	{
 		Body* body = m_bodies[i];
-		body->m_sweep.c = m_positions[i]->c;
-		body->m_sweep.a = m_positions[i]->a;
-		body->m_linearVelocity = m_velocities[i]->v;
-		body->m_angularVelocity = m_velocities[i]->w;
+		body->SweepRef().c = m_positions[i].c;
+		body->SweepRef().a = m_positions[i].a;
+		body->LinearVelocityRef() = m_velocities[i].v;
+		body->AngularVelocityRef() = m_velocities[i].w;
 		body->SynchronizeTransform();
 	}
 
@@ -300,8 +304,8 @@ void Island::Solve(const TimeStep& step, const Vec2& gravity, bool allowSleep)
 			}
 
 			if ((b->m_flags & Body::e_autoSleepFlag) == 0 ||
-				b->m_angularVelocity * b->m_angularVelocity > angTolSqr ||
-				Dot(b->m_linearVelocity, b->m_linearVelocity) > linTolSqr)
+				b->AngularVelocityRef() * b->AngularVelocityRef() > angTolSqr ||
+				Dot(b->LinearVelocityRef(), b->LinearVelocityRef()) > linTolSqr)
 			{
 				b->m_sleepTime = 0.0f;
 				minSleepTime = 0.0f;
@@ -333,18 +337,18 @@ void Island::SolveTOI(const TimeStep& subStep, int toiIndexA, int toiIndexB)
 	for (int i = 0; i < m_bodyCount; ++i)
 	{
 		Body* b = m_bodies[i];
-		m_positions[i]->c = b->m_sweep.c;
-		m_positions[i]->a = b->m_sweep.a;
-		m_velocities[i]->v = b->m_linearVelocity;
-		m_velocities[i]->w = b->m_angularVelocity;
+		m_positions[i].c = b->SweepRef().c;
+		m_positions[i].a = b->SweepRef().a;
+		m_velocities[i].v = b->LinearVelocityRef();
+		m_velocities[i].w = b->AngularVelocityRef();
 	}
 
 	ContactSolverDef contactSolverDef;
 	contactSolverDef.contacts = m_contacts;
 	contactSolverDef.count = m_contactCount;
 	contactSolverDef.step = subStep;
-	contactSolverDef.positions = m_positions;
-	contactSolverDef.velocities = m_velocities;
+	contactSolverDef.positions = m_positions.data();
+	contactSolverDef.velocities = m_velocities.data();
 	ContactSolver contactSolver(&contactSolverDef);
 
 	// Solve position constraints.
@@ -391,10 +395,10 @@ void Island::SolveTOI(const TimeStep& subStep, int toiIndexA, int toiIndexB)
 #endif
 
 	// Leap of faith to new safe state.
-	m_bodies[toiIndexA]->m_sweep.c0 = m_positions[toiIndexA]->c;
-	m_bodies[toiIndexA]->m_sweep.a0 = m_positions[toiIndexA]->a;
-	m_bodies[toiIndexB]->m_sweep.c0 = m_positions[toiIndexB]->c;
-	m_bodies[toiIndexB]->m_sweep.a0 = m_positions[toiIndexB]->a;
+	m_bodies[toiIndexA]->SweepRef().c0 = m_positions[toiIndexA].c;
+	m_bodies[toiIndexA]->SweepRef().a0 = m_positions[toiIndexA].a;
+	m_bodies[toiIndexB]->SweepRef().c0 = m_positions[toiIndexB].c;
+	m_bodies[toiIndexB]->SweepRef().a0 = m_positions[toiIndexB].a;
 
 	// No warm starting is needed for TOI events because warm
 	// starting impulses were applied in the discrete solver.
@@ -414,10 +418,10 @@ void Island::SolveTOI(const TimeStep& subStep, int toiIndexA, int toiIndexB)
 	// Integrate positions
 	for (int i = 0; i < m_bodyCount; ++i)
 	{
-		Vec2 c = m_positions[i]->c;
-		float a = m_positions[i]->a;
-		Vec2 v = m_velocities[i]->v;
-		float w = m_velocities[i]->w;
+		Vec2 c = m_positions[i].c;
+		float a = m_positions[i].a;
+		Vec2 v = m_velocities[i].v;
+		float w = m_velocities[i].w;
 
 		// Check for large velocities
 		Vec2 translation = h * v;
@@ -438,26 +442,26 @@ void Island::SolveTOI(const TimeStep& subStep, int toiIndexA, int toiIndexB)
 		c += h * v;
 		a += h * w;
 
-		m_positions[i]->c = c;
-		m_positions[i]->a = a;
-		m_velocities[i]->v = v;
-		m_velocities[i]->w = w;
+		m_positions[i].c = c;
+		m_positions[i].a = a;
+		m_velocities[i].v = v;
+		m_velocities[i].w = w;
 
 		// Sync bodies
 		Body* body = m_bodies[i];
-		body->m_sweep.c = c;
-		body->m_sweep.a = a;
-		body->m_linearVelocity = v;
-		body->m_angularVelocity = w;
+		body->SweepRef().c = c;
+		body->SweepRef().a = a;
+		body->LinearVelocityRef() = v;
+		body->AngularVelocityRef() = w;
 		body->SynchronizeTransform();
 	}
 
 	Report(contactSolver.m_velocityConstraints);
 }
 
-void Island::Report(const std::vector<ContactVelocityConstraint*>& constraints)
+void Island::Report(const std::vector<ContactVelocityConstraint>& constraints)
 {
-	if (m_listener == nullptr)
+	if (m_listener == nullptr && m_events == nullptr)
 	{
 		return;
 	}
@@ -466,8 +470,46 @@ void Island::Report(const std::vector<ContactVelocityConstraint*>& constraints)
 	{
 		Contact* c = m_contacts[i];
 
-		const ContactVelocityConstraint* vc = constraints[i];
-		
+		const ContactVelocityConstraint* vc = &constraints[i];
+
+		if (m_events && c->ReportsEvents())
+		{
+			// Keep the strongest point of the manifold.
+			float approachSpeed = 0.0f;
+			float normalImpulse = 0.0f;
+			int pointIndex = -1;
+			for (int j = 0; j < vc->pointCount; ++j)
+			{
+				float speed = -vc->points[j].relativeVelocity;
+				if (speed > approachSpeed)
+				{
+					approachSpeed = speed;
+					pointIndex = j;
+				}
+				normalImpulse = Max(normalImpulse, vc->points[j].normalImpulse);
+			}
+
+			if (pointIndex != -1 && approachSpeed > b2_hitEventThreshold)
+			{
+				WorldManifold worldManifold;
+				c->GetWorldManifold(&worldManifold);
+
+				ContactHitEvent event;
+				event.fixtureA = c->GetFixtureA();
+				event.fixtureB = c->GetFixtureB();
+				event.point = worldManifold.points[pointIndex];
+				event.normal = worldManifold.normal;
+				event.approachSpeed = approachSpeed;
+				event.normalImpulse = normalImpulse;
+				m_events->hitEvents.push_back(event);
+			}
+		}
+
+		if (m_listener == nullptr)
+		{
+			continue;
+		}
+
 		b2ContactImpulse impulse;
 		impulse.count = vc->pointCount;
 		for (int j = 0; j < vc->pointCount; ++j)
@@ -1,21 +1,21 @@
 #pragma once
 #include "Body.h"
+#include "../common/TimeStep.h"
 
-struct Velocity;
-struct Position;
 struct Vec2;
 struct TimeStep;
 class Contact;
 class b2Joint;
 class b2StackAllocator;
 class ContactListener;
+struct ContactEvents;
 struct ContactVelocityConstraint;
 
 /// This is an internal class.
 class Island
 {
 public:
-	Island(int bodyCapacity, int contactCapacity, ContactListener* listener);
+	Island(int bodyCapacity, int contactCapacity, ContactListener* listener, ContactEvents* events);
 	~Island();
 
 	void Clear()
@@ -42,15 +42,16 @@ public:
 		m_contacts[m_contactCount++] = contact;
 	}
 
-	void Report(const std::vector<ContactVelocityConstraint*>& constraints);
+	void Report(const std::vector<ContactVelocityConstraint>& constraints);
 
 	ContactListener* m_listener;
+	ContactEvents* m_events;
 
 	std::vector<Body*> m_bodies;
 	std::vector<Contact*> m_contacts;
 
-	std::vector<Position*> m_positions;
-	std::vector<Velocity*> m_velocities;
+	std::vector<Position> m_positions;
+	std::vector<Velocity> m_velocities;
 
 	int m_bodyCount;
 	int m_contactCount;
@@ -1,7 +1,7 @@
 #pragma once
 #include "Contact.h"
 
-class PolygonAndCircleContact : public Contact
+class PolygonAndCircleContact final : public Contact
 {
 public:
 	static Contact* Create(Fixture* fixtureA, int indexA, Fixture* fixtureB, int indexB);
@@ -1,7 +1,7 @@
 #pragma once
 #include "Contact.h"
 
-class PolygonContact : public Contact
+class PolygonContact final : public Contact
 {
 public:
 	static Contact* Create(	Fixture* fixtureA, int indexA,
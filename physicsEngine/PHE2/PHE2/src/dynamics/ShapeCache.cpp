@@ -0,0 +1,183 @@
+#include "ShapeCache.h"
+
+#include <functional>
+
+#include "../collision/CircleShape.h"
+#include "../collision/EdgeShape.h"
+#include "../collision/PolygonShape.h"
+
+static void b2HashCombine(size_t& seed, float value)
+{
+	seed ^= std::hash<float>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+static void b2HashCombine(size_t& seed, const Vec2& v)
+{
+	b2HashCombine(seed, v.x);
+	b2HashCombine(seed, v.y);
+}
+
+static bool b2Equals(const Vec2& a, const Vec2& b)
+{
+	return a.x == b.x && a.y == b.y;
+}
+
+ShapeCache::~ShapeCache()
+{
+	for (auto& entry : m_shapes)
+	{
+		delete entry.second.shape;
+	}
+	m_shapes.clear();
+}
+
+size_t ShapeCache::Hash(const Shape* shape)
+{
+	size_t seed = size_t(shape->m_type);
+	b2HashCombine(seed, shape->m_radius);
+
+	switch (shape->m_type)
+	{
+	case Shape::e_circle:
+		{
+			const CircleShape* circle = (const CircleShape*)shape;
+			b2HashCombine(seed, circle->m_p);
+		}
+		break;
+
+	case Shape::e_edge:
+		{
+			const EdgeShape* edge = (const EdgeShape*)shape;
+			b2HashCombine(seed, edge->m_vertex1);
+			b2HashCombine(seed, edge->m_vertex2);
+			if (edge->m_oneSided)
+			{
+				b2HashCombine(seed, edge->m_vertex0);
+				b2HashCombine(seed, edge->m_vertex3);
+			}
+		}
+		break;
+
+	case Shape::e_polygon:
+		{
+			const PolygonShape* polygon = (const PolygonShape*)shape;
+			for (int i = 0; i < polygon->m_count; ++i)
+			{
+				b2HashCombine(seed, polygon->m_vertices[i]);
+			}
+		}
+		break;
+
+	default:
+		b2Assert(false);
+		break;
+	}
+
+	return seed;
+}
+
+bool ShapeCache::Equals(const Shape* a, const Shape* b)
+{
+	if (a->m_type != b->m_type || a->m_radius != b->m_radius)
+	{
+		return false;
+	}
+
+	switch (a->m_type)
+	{
+	case Shape::e_circle:
+		return b2Equals(((const CircleShape*)a)->m_p, ((const CircleShape*)b)->m_p);
+
+	case Shape::e_edge:
+		{
+			const EdgeShape* edgeA = (const EdgeShape*)a;
+			const EdgeShape* edgeB = (const EdgeShape*)b;
+			if (edgeA->m_oneSided != edgeB->m_oneSided)
+			{
+				return false;
+			}
+
+			if (b2Equals(edgeA->m_vertex1, edgeB->m_vertex1) == false ||
+				b2Equals(edgeA->m_vertex2, edgeB->m_vertex2) == false)
+			{
+				return false;
+			}
+
+			// Ghost vertices are only used by one-sided edges.
+			return edgeA->m_oneSided == false ||
+				(b2Equals(edgeA->m_vertex0, edgeB->m_vertex0) && b2Equals(edgeA->m_vertex3, edgeB->m_vertex3));
+		}
+
+	case Shape::e_polygon:
+		{
+			const PolygonShape* polygonA = (const PolygonShape*)a;
+			const PolygonShape* polygonB = (const PolygonShape*)b;
+			if (polygonA->m_count != polygonB->m_count)
+			{
+				return false;
+			}
+
+			// Normals and centroid are derived from the vertices.
+			for (int i = 0; i < polygonA->m_count; ++i)
+			{
+				if (b2Equals(polygonA->m_vertices[i], polygonB->m_vertices[i]) == false)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+	default:
+		return false;
+	}
+}
+
+SharedShape* ShapeCache::Acquire(const Shape* shape)
+{
+	if (shape->m_type == Shape::e_chain)
+	{
+		return nullptr;
+	}
+
+	size_t hash = Hash(shape);
+	auto range = m_shapes.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (Equals(it->second.shape, shape))
+		{
+			++it->second.refCount;
+			return &it->second;
+		}
+	}
+
+	SharedShape shared;
+	shared.shape = shape->Clone();
+	shared.shape->ComputeMass(&shared.unitMassData, 1.0f);
+	shared.refCount = 1;
+
+	auto it = m_shapes.emplace(hash, shared);
+	return &it->second;
+}
+
+void ShapeCache::Release(SharedShape* shared)
+{
+	b2Assert(shared->refCount > 0);
+	if (--shared->refCount > 0)
+	{
+		return;
+	}
+
+	auto range = m_shapes.equal_range(Hash(shared->shape));
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (&it->second == shared)
+		{
+			delete it->second.shape;
+			m_shapes.erase(it);
+			return;
+		}
+	}
+
+	b2Assert(false);
+}
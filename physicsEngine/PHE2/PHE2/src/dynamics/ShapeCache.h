@@ -0,0 +1,46 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "../collision/Shape.h"
+
+/// A shape referenced by every fixture with the same geometry. Its mass data
+/// is computed once for a unit density, the fixtures scale it by their density.
+/// @warning shared shapes are immutable, do not modify them through Fixture::GetShape.
+struct SharedShape
+{
+	Shape* shape;
+	MassData unitMassData;
+	int refCount;
+};
+
+/// Interns the shapes of the fixtures created with FixtureDef::shareShape so identical
+/// geometry is stored once per world. Chain shapes are never shared.
+/// Delegate of World.
+class ShapeCache
+{
+public:
+	ShapeCache() = default;
+	~ShapeCache();
+
+	/// Get the shared instance with the same geometry as this shape, it is cloned
+	/// on first use. The reference count is incremented.
+	/// @return nullptr if this type of shape cannot be shared.
+	SharedShape* Acquire(const Shape* shape);
+
+	/// Drop a reference, the shape is freed with its last fixture.
+	void Release(SharedShape* shared);
+
+	/// Get the number of distinct shared shapes.
+	int GetCount() const { return int(m_shapes.size()); }
+
+private:
+	ShapeCache(const ShapeCache&) = delete;
+	void operator=(const ShapeCache&) = delete;
+
+	static size_t Hash(const Shape* shape);
+	static bool Equals(const Shape* a, const Shape* b);
+
+	// Keyed on the geometry hash, nodes keep the SharedShape addresses stable.
+	std::unordered_multimap<size_t, SharedShape> m_shapes;
+};
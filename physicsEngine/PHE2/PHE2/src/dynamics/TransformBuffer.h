@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../common/Math.h"
+
+/// Poses of the bodies that moved during the last time step. Each pose is spread over
+/// parallel arrays (id, x, y, cos, sin) so render and game code can sync everything
+/// in a single linear pass instead of querying the bodies one by one.
+/// The id is the body user data.
+struct TransformBuffer
+{
+	void Clear()
+	{
+		ids.clear();
+		x.clear();
+		y.clear();
+		c.clear();
+		s.clear();
+	}
+
+	void Push(uintptr_t id, const Transform& xf)
+	{
+		ids.push_back(id);
+		x.push_back(xf.p.x);
+		y.push_back(xf.p.y);
+		c.push_back(xf.q.c);
+		s.push_back(xf.q.s);
+	}
+
+	int GetCount() const
+	{
+		return int(ids.size());
+	}
+
+	std::vector<uintptr_t> ids;
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> c;
+	std::vector<float> s;
+};
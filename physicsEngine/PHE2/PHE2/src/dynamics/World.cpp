@@ -1,10 +1,14 @@
 #include "World.h"
 
+#include <algorithm>
+#include <functional>
 #include <new>
+#include <unordered_map>
 
 #include "Body.h"
 #include "Contact.h"
 #include "ContactManager.h"
+#include "Fixture.h"
 #include "Island.h"
 #include "../collision/BroadPhase.h"
 #include "../common/Common.h"
@@ -31,6 +35,10 @@ World::World(const Vec2& gravity)
 	m_continuousPhysics = true;
 	m_subStepping = false;
 
+	m_toiBudget = b2_maxTOIEvents;
+	m_toiStats = {};
+	m_profile = {};
+
 	m_stepComplete = true;
 
 	m_allowSleep = true;
@@ -60,6 +68,152 @@ World::~World()
 	}
 }
 
+std::unique_ptr<World> World::Clone()
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return nullptr;
+	}
+
+	auto clone = std::make_unique<World>(m_gravity);
+	clone->m_allowSleep = m_allowSleep;
+	clone->m_warmStarting = m_warmStarting;
+	clone->m_continuousPhysics = m_continuousPhysics;
+	clone->m_subStepping = m_subStepping;
+	clone->m_toiBudget = m_toiBudget;
+	clone->m_inv_dt0 = m_inv_dt0;
+	clone->m_newContacts = m_newContacts;
+	clone->m_clearForces = m_clearForces;
+	clone->m_contactManager.m_contactFilter = m_contactManager.m_contactFilter;
+
+	// One block for every body and fixture.
+	size_t fixtureCount = 0;
+	for (Body* b : m_bodyList)
+	{
+		fixtureCount += b->m_fixtureList.size();
+	}
+
+	clone->m_arena = std::make_unique<WorldArena>(WorldArena::GetSize<Body>(m_bodyList.size())
+		+ WorldArena::GetSize<Fixture>(fixtureCount));
+	WorldArena* arena = clone->m_arena.get();
+
+	// The tree is copied with its proxy ids, only the user data needs to be patched.
+	BroadPhase* broadPhase = &clone->m_contactManager.m_broadPhase;
+	broadPhase->CopyFrom(m_contactManager.m_broadPhase);
+
+	std::unordered_map<const Body*, Body*> bodyMap;
+	std::unordered_map<const Fixture*, Fixture*> fixtureMap;
+	bodyMap.reserve(m_bodyList.size());
+	fixtureMap.reserve(fixtureCount);
+
+	clone->m_bodyList.reserve(m_bodyList.size());
+	for (Body* b : m_bodyList)
+	{
+		Body* cb = arena->Construct<Body>(*b);
+		cb->m_world = clone.get();
+		cb->m_states = &clone->m_bodyStates;
+		cb->m_stateIndex = cb->m_states->Add(cb, m_bodyStates, b->m_stateIndex);
+		cb->m_jointList.clear();
+		cb->m_contactList.clear();
+
+		for (size_t i = 0; i < b->m_fixtureList.size(); ++i)
+		{
+			Fixture* f = b->m_fixtureList[i];
+
+			// A static shape is shared through m_clonedShape, copied with the fixture.
+			Fixture* cf = arena->Construct<Fixture>(*f);
+			cf->m_body = cb;
+			cf->m_next = nullptr;
+
+			if (f->m_sharedShape)
+			{
+				cf->m_sharedShape = clone->m_shapeCache.Acquire(f->m_shape);
+				cf->m_shape = cf->m_sharedShape->shape;
+			}
+			else if (!f->m_clonedShape)
+			{
+				cf->m_shape = f->m_shape->Clone();
+			}
+
+			// The proxies were copied with the fixture.
+			for (size_t j = 0; j < cf->m_proxies.size(); ++j)
+			{
+				FixtureProxy* proxy = &cf->m_proxies[j];
+				proxy->fixture = cf;
+
+				if ((int)j < cf->m_proxyCount)
+				{
+					broadPhase->SetUserData(proxy->proxyId, proxy);
+				}
+			}
+
+			cb->m_fixtureList[i] = cf;
+			fixtureMap[f] = cf;
+		}
+
+		clone->m_bodyList.push_back(cb);
+		bodyMap[b] = cb;
+	}
+	clone->m_bodyCount = m_bodyCount;
+
+	// The bodies keep their list and moved indices, the moved bodies are mapped in the same order.
+	std::vector<Body*>& moved = clone->m_bodyStates.moved;
+	moved.reserve(m_bodyStates.moved.size());
+	for (Body* b : m_bodyStates.moved)
+	{
+		moved.push_back(b != nullptr ? bodyMap[b] : nullptr);
+	}
+
+	// Contacts keep their manifolds so the clone warm starts like this world.
+	std::unordered_map<const Contact*, Contact*> contactMap;
+	contactMap.reserve(m_contactManager.m_contactList.size());
+
+	std::vector<Contact*>& contactList = clone->m_contactManager.m_contactList;
+	contactList.reserve(m_contactManager.m_contactList.size());
+	for (Contact* c : m_contactManager.m_contactList)
+	{
+		Contact* cc = Contact::Create(fixtureMap[c->m_fixtureA], c->m_indexA, fixtureMap[c->m_fixtureB], c->m_indexB);
+		b2Assert(cc != nullptr && cc->m_fixtureA == fixtureMap[c->m_fixtureA]);
+
+		cc->m_flags = c->m_flags;
+		cc->m_manifold = c->m_manifold;
+		cc->m_toiCount = c->m_toiCount;
+		cc->m_toi = c->m_toi;
+		cc->m_friction = c->m_friction;
+		cc->m_restitution = c->m_restitution;
+		cc->m_restitutionThreshold = c->m_restitutionThreshold;
+		cc->m_tangentSpeed = c->m_tangentSpeed;
+
+		// The lists are rebuilt in the same order, the indices carry over.
+		cc->m_listIndex = c->m_listIndex;
+		cc->m_nodeA.contact = cc;
+		cc->m_nodeA.other = bodyMap[c->m_nodeA.other];
+		cc->m_nodeA.listIndex = c->m_nodeA.listIndex;
+		cc->m_nodeB.contact = cc;
+		cc->m_nodeB.other = bodyMap[c->m_nodeB.other];
+		cc->m_nodeB.listIndex = c->m_nodeB.listIndex;
+
+		contactList.push_back(cc);
+		contactMap[c] = cc;
+	}
+	clone->m_contactManager.m_contactCount = m_contactManager.m_contactCount;
+
+	// Same contact edge order on every body, the islands come out the same.
+	for (Body* b : m_bodyList)
+	{
+		Body* cb = bodyMap[b];
+		cb->m_contactList.reserve(b->m_contactList.size());
+		for (b2ContactEdge* edge : b->m_contactList)
+		{
+			Contact* cc = contactMap[edge->contact];
+			cb->m_contactList.push_back(edge == &edge->contact->m_nodeA ? &cc->m_nodeA : &cc->m_nodeB);
+		}
+	}
+
+	return clone;
+}
+
 void World::SetDestructionListener(DestructionListener* listener)
 {
 	m_destructionListener = listener;
@@ -85,6 +239,8 @@ Body* World::CreateBody(const BodyDef* def)
 
 	Body* b = new Body(def, this);
 
+	b->m_listIndex = int(m_bodyList.size());
+	m_bodyList.push_back(b);
 	++m_bodyCount;
 
 	return b;
@@ -107,6 +263,18 @@ void World::DestroyBody(Body* b)
 	}
 	b->m_contactList.clear();
 
+	// Drop the buffered events that would point to the destroyed fixtures.
+	// End events are kept, they are only compared by address.
+	ContactEvents& events = m_contactManager.m_contactEvents;
+	std::erase_if(events.beginEvents, [b](const ContactBeginTouchEvent& event)
+	{
+		return event.fixtureA->m_body == b || event.fixtureB->m_body == b;
+	});
+	std::erase_if(events.hitEvents, [b](const ContactHitEvent& event)
+	{
+		return event.fixtureA->m_body == b || event.fixtureB->m_body == b;
+	});
+
 	// Delete the attached fixtures. This destroys broad-phase proxies.
 	for (int i = b->m_fixtureList.size() - 1; i >= 0; --i)
 	{
@@ -126,6 +294,19 @@ void World::DestroyBody(Body* b)
 	b->m_fixtureList.clear();
 	b->m_fixtureCount = 0;
 	
+	// The last body takes its place and its index.
+	Body* last = m_bodyList.back();
+	m_bodyList[b->m_listIndex] = last;
+	last->m_listIndex = b->m_listIndex;
+	m_bodyList.pop_back();
+
+	// Left as a null so the others keep their index, the export skips it.
+	if (b->m_flags & Body::e_movedFlag)
+	{
+		m_bodyStates.moved[b->m_movedIndex] = nullptr;
+	}
+
+	m_bodyStates.Remove(b->m_stateIndex);
 	--m_bodyCount;
 	b->~Body();
 }
@@ -154,7 +335,8 @@ void World::Solve(const TimeStep& step)
 	// Size the island for the worst case.
 	Island island(m_bodyCount,
 					m_contactManager.m_contactCount,
-					m_contactManager.m_contactListener);
+					m_contactManager.m_contactListener,
+					&m_contactManager.m_contactEvents);
 
 	// Clear all the island flags.
 	for (Body* b : m_bodyList)
@@ -287,175 +469,234 @@ void World::Solve(const TimeStep& step)
 				continue;
 			}
 
-			// Update fixtures (for broad-phase).
+			// Queue the fixture moves (for broad-phase).
 			b->SynchronizeFixtures();
 		}
 
+		// Update the tree for all the moved proxies at once.
+		m_contactManager.m_broadPhase.ApplyMoves();
+
 		// Look for new contacts.
 		m_contactManager.FindNewContacts();
+		m_profile.broadphase = timer.GetMilliseconds();
 	}
 }
 
-// Find TOI contacts and solve them.
-void World::SolveTOI(const TimeStep& step)
+// Compute the TOI of a contact and queue it if it hits before the end of the step.
+// Only contacts of bullets and fast bodies are considered.
+void World::QueueTOI(Contact* c)
 {
-	Island island(2 * b2_maxTOIContacts, b2_maxTOIContacts, m_contactManager.m_contactListener);
+	// Is this contact disabled?
+	if (c->IsEnabled() == false)
+	{
+		return;
+	}
 
-	if (m_stepComplete)
+	// Prevent excessive sub-stepping.
+	if (c->m_toiCount > b2_maxSubSteps)
 	{
-		for (Body* b : m_bodyList)
+		return;
+	}
+
+	float alpha = 1.0f;
+	if (c->m_flags & Contact::e_toiFlag)
+	{
+		// This contact has a valid cached TOI.
+		alpha = c->m_toi;
+	}
+	else
+	{
+		Fixture* fA = c->GetFixtureA();
+		Fixture* fB = c->GetFixtureB();
+
+		// Is there a sensor?
+		if (fA->IsSensor() || fB->IsSensor())
 		{
-			b->m_flags &= ~Body::e_islandFlag;
-			b->m_sweep.alpha0 = 0.0f;
+			return;
 		}
 
-		for (Contact* c : m_contactManager.m_contactList)
+		Body* bA = fA->GetBody();
+		Body* bB = fB->GetBody();
+
+		b2BodyType typeA = bA->m_type;
+		b2BodyType typeB = bB->m_type;
+		b2Assert(typeA == dynamicBody || typeB == dynamicBody);
+
+		bool activeA = bA->IsAwake() && typeA != b2_staticBody;
+		bool activeB = bB->IsAwake() && typeB != b2_staticBody;
+
+		// Is at least one body active (awake and dynamic or kinematic)?
+		if (activeA == false && activeB == false)
 		{
-			// Invalidate TOI
-			c->m_flags &= ~(Contact::e_toiFlag | Contact::e_islandFlag);
-			c->m_toiCount = 0;
-			c->m_toi = 1.0f;
+			return;
 		}
-	}
 
-	// Find TOI events and solve them.
-	for (;;)
-	{
-		// Find the first TOI.
-		Contact* minContact = nullptr;
-		float minAlpha = 1.0f;
+		// Is there a bullet or a fast body?
+		if (((bA->m_flags | bB->m_flags) & Body::e_toiFlag) == 0)
+		{
+			return;
+		}
 
-		for (Contact* c : m_contactManager.m_contactList)
+		// Are these two non-bullet dynamic bodies?
+		if (typeA == dynamicBody && typeB == dynamicBody &&
+			bA->IsBullet() == false && bB->IsBullet() == false)
 		{
-			// Is this contact disabled?
-			if (c->IsEnabled() == false)
-			{
-				continue;
-			}
+			return;
+		}
 
-			// Prevent excessive sub-stepping.
-			if (c->m_toiCount > b2_maxSubSteps)
-			{
-				continue;
-			}
+		// Compute the TOI for this contact.
+		// Put the sweeps onto the same time interval.
+		float alpha0 = bA->SweepRef().alpha0;
 
-			float alpha = 1.0f;
-			if (c->m_flags & Contact::e_toiFlag)
-			{
-				// This contact has a valid cached TOI.
-				alpha = c->m_toi;
-			}
-			else
-			{
-				Fixture* fA = c->GetFixtureA();
-				Fixture* fB = c->GetFixtureB();
+		if (bA->SweepRef().alpha0 < bB->SweepRef().alpha0)
+		{
+			alpha0 = bB->SweepRef().alpha0;
+			bA->SweepRef().Advance(alpha0);
+		}
+		else if (bB->SweepRef().alpha0 < bA->SweepRef().alpha0)
+		{
+			alpha0 = bA->SweepRef().alpha0;
+			bB->SweepRef().Advance(alpha0);
+		}
 
-				// Is there a sensor?
-				if (fA->IsSensor() || fB->IsSensor())
-				{
-					continue;
-				}
+		b2Assert(alpha0 < 1.0f);
 
-				Body* bA = fA->GetBody();
-				Body* bB = fB->GetBody();
+		int indexA = c->GetChildIndexA();
+		int indexB = c->GetChildIndexB();
 
-				b2BodyType typeA = bA->m_type;
-				b2BodyType typeB = bB->m_type;
-				b2Assert(typeA == dynamicBody || typeB == dynamicBody);
+		// Compute the time of impact in interval [0, minTOI]
+		TimeOfImpactInput input;
+		input.proxyA.Set(fA->GetShape(), indexA);
+		input.proxyB.Set(fB->GetShape(), indexB);
+		input.sweepA = bA->SweepRef();
+		input.sweepB = bB->SweepRef();
+		input.tMax = 1.0f;
 
-				bool activeA = bA->IsAwake() && typeA != b2_staticBody;
-				bool activeB = bB->IsAwake() && typeB != b2_staticBody;
+		TimeOfImpactOutput output;
+		b2TimeOfImpact(&output, &input);
+		++m_toiStats.computeCount;
 
-				// Is at least one body active (awake and dynamic or kinematic)?
-				if (activeA == false && activeB == false)
-				{
-					continue;
-				}
+		// Beta is the fraction of the remaining portion of the .
+		float beta = output.t;
+		if (output.state == TimeOfImpactOutput::e_touching)
+		{
+			alpha = Min(alpha0 + (1.0f - alpha0) * beta, 1.0f);
+		}
+		else
+		{
+			alpha = 1.0f;
+		}
 
-				bool collideA = bA->IsBullet() || typeA != dynamicBody;
-				bool collideB = bB->IsBullet() || typeB != dynamicBody;
+		c->m_toi = alpha;
+		c->m_flags |= Contact::e_toiFlag;
+	}
 
-				// Are these two non-bullet dynamic bodies?
-				if (collideA == false && collideB == false)
-				{
-					continue;
-				}
+	// No hit before the end of the step.
+	if (1.0f - 10.0f * b2_epsilon < alpha)
+	{
+		return;
+	}
 
-				// Compute the TOI for this contact.
-				// Put the sweeps onto the same time interval.
-				float alpha0 = bA->m_sweep.alpha0;
+	m_toiQueue.push_back({ alpha, c });
+	std::push_heap(m_toiQueue.begin(), m_toiQueue.end(), std::greater<TOIEvent>());
+}
 
-				if (bA->m_sweep.alpha0 < bB->m_sweep.alpha0)
-				{
-					alpha0 = bB->m_sweep.alpha0;
-					bA->m_sweep.Advance(alpha0);
-				}
-				else if (bB->m_sweep.alpha0 < bA->m_sweep.alpha0)
-				{
-					alpha0 = bA->m_sweep.alpha0;
-					bB->m_sweep.Advance(alpha0);
-				}
+// Find TOI contacts and solve them.
+void World::SolveTOI(const TimeStep& step)
+{
+	Island island(2 * b2_maxTOIContacts, b2_maxTOIContacts, m_contactManager.m_contactListener, &m_contactManager.m_contactEvents);
 
-				b2Assert(alpha0 < 1.0f);
+	if (m_stepComplete)
+	{
+		m_toiStats = {};
 
-				int indexA = c->GetChildIndexA();
-				int indexB = c->GetChildIndexB();
+		for (Body* b : m_bodyList)
+		{
+			b->m_flags &= ~(Body::e_islandFlag | Body::e_toiFlag);
+			b->SweepRef().alpha0 = 0.0f;
 
-				// Compute the time of impact in interval [0, minTOI]
-				TimeOfImpactInput input;
-				input.proxyA.Set(fA->GetShape(), indexA);
-				input.proxyB.Set(fB->GetShape(), indexB);
-				input.sweepA = bA->m_sweep;
-				input.sweepB = bB->m_sweep;
-				input.tMax = 1.0f;
+			// Flag the bodies that need continuous collision. The sweep covers the whole step here.
+			bool fast = b->m_type == dynamicBody &&
+				DistanceSquared(b->SweepRef().c0, b->SweepRef().c) > b2_toiFastDistance * b2_toiFastDistance;
+			if (b->IsBullet() || fast)
+			{
+				b->m_flags |= Body::e_toiFlag;
+			}
+		}
+	}
 
-				TimeOfImpactOutput output;
-				b2TimeOfImpact(&output, &input);
+	// Gather the candidates from the contacts of bullets and fast bodies only,
+	// the rest of the world does not pay for continuous collision.
+	m_toiQueue.clear();
+	for (Body* b : m_bodyList)
+	{
+		if ((b->m_flags & Body::e_toiFlag) == 0)
+		{
+			continue;
+		}
 
-				// Beta is the fraction of the remaining portion of the .
-				float beta = output.t;
-				if (output.state == TimeOfImpactOutput::e_touching)
-				{
-					alpha = Min(alpha0 + (1.0f - alpha0) * beta, 1.0f);
-				}
-				else
-				{
-					alpha = 1.0f;
-				}
+		for (b2ContactEdge* ce : b->m_contactList)
+		{
+			Contact* c = ce->contact;
 
-				c->m_toi = alpha;
-				c->m_flags |= Contact::e_toiFlag;
+			// Contacts between two flagged bodies are gathered from body A.
+			if ((ce->other->m_flags & Body::e_toiFlag) && c->m_fixtureA->m_body != b)
+			{
+				continue;
 			}
 
-			if (alpha < minAlpha)
+			if (m_stepComplete)
 			{
-				// This is the minimum TOI found so far.
-				minContact = c;
-				minAlpha = alpha;
+				// Invalidate TOI
+				c->m_flags &= ~(Contact::e_toiFlag | Contact::e_islandFlag);
+				c->m_toiCount = 0;
+				c->m_toi = 1.0f;
 			}
+
+			++m_toiStats.candidateCount;
+			QueueTOI(c);
+		}
+	}
+
+	// Solve TOI events, earliest first.
+	while (m_toiQueue.empty() == false)
+	{
+		std::pop_heap(m_toiQueue.begin(), m_toiQueue.end(), std::greater<TOIEvent>());
+		TOIEvent event = m_toiQueue.back();
+		m_toiQueue.pop_back();
+
+		// Skip stale entries, the contact was invalidated after being queued.
+		Contact* minContact = event.contact;
+		float minAlpha = event.alpha;
+		if ((minContact->m_flags & Contact::e_toiFlag) == 0 || minContact->m_toi != minAlpha ||
+			minContact->IsEnabled() == false || minContact->m_toiCount > b2_maxSubSteps)
+		{
+			continue;
 		}
 
-		if (minContact == nullptr || 1.0f - 10.0f * b2_epsilon < minAlpha)
+		// Out of budget, the remaining bodies finish the step without continuous collision.
+		if (m_toiBudget > 0 && m_toiStats.eventCount >= m_toiBudget)
 		{
-			// No more TOI events. Done!
-			m_stepComplete = true;
+			m_toiStats.droppedCount += 1 + int(m_toiQueue.size());
 			break;
 		}
 
+		++m_toiStats.eventCount;
+
 		// Advance the bodies to the TOI.
 		Fixture* fA = minContact->GetFixtureA();
 		Fixture* fB = minContact->GetFixtureB();
 		Body* bA = fA->GetBody();
 		Body* bB = fB->GetBody();
 
-		Sweep backup1 = bA->m_sweep;
-		Sweep backup2 = bB->m_sweep;
+		Sweep backup1 = bA->SweepRef();
+		Sweep backup2 = bB->SweepRef();
 
 		bA->Advance(minAlpha);
 		bB->Advance(minAlpha);
 
 		// The TOI contact likely has some new contact points.
-		minContact->Update(m_contactManager.m_contactListener);
+		minContact->Update(m_contactManager.m_contactListener, &m_contactManager.m_contactEvents);
 		minContact->m_flags &= ~Contact::e_toiFlag;
 		++minContact->m_toiCount;
 
@@ -464,8 +705,8 @@ void World::SolveTOI(const TimeStep& step)
 		{
 			// Restore the sweeps.
 			minContact->SetEnabled(false);
-			bA->m_sweep = backup1;
-			bB->m_sweep = backup2;
+			bA->SweepRef() = backup1;
+			bB->SweepRef() = backup2;
 			bA->SynchronizeTransform();
 			bB->SynchronizeTransform();
 			continue;
@@ -474,6 +715,17 @@ void World::SolveTOI(const TimeStep& step)
 		bA->SetAwake(true);
 		bB->SetAwake(true);
 
+		// Only the contacts of bodyA and bodyB are crawled, the island flags
+		// left by Solve on the other contacts do not matter.
+		Body* bodies[2] = {bA, bB};
+		for (Body* body : bodies)
+		{
+			for (b2ContactEdge* ce : body->m_contactList)
+			{
+				ce->contact->m_flags &= ~Contact::e_islandFlag;
+			}
+		}
+
 		// Build the island
 		island.Clear();
 		island.Add(bA);
@@ -485,7 +737,6 @@ void World::SolveTOI(const TimeStep& step)
 		minContact->m_flags |= Contact::e_islandFlag;
 
 		// Get contacts on bodyA and bodyB.
-		Body* bodies[2] = {bA, bB};
 		for (int i = 0; i < 2; ++i)
 		{
 			Body* body = bodies[i];
@@ -528,19 +779,19 @@ void World::SolveTOI(const TimeStep& step)
 					}
 
 					// Tentatively advance the body to the TOI.
-					Sweep backup = other->m_sweep;
+					Sweep backup = other->SweepRef();
 					if ((other->m_flags & Body::e_islandFlag) == 0)
 					{
 						other->Advance(minAlpha);
 					}
 
 					// Update the contact points
-					contact->Update(m_contactManager.m_contactListener);
+					contact->Update(m_contactManager.m_contactListener, &m_contactManager.m_contactEvents);
 
 					// Was the contact disabled by the user?
 					if (contact->IsEnabled() == false)
 					{
-						other->m_sweep = backup;
+						other->SweepRef() = backup;
 						other->SynchronizeTransform();
 						continue;
 					}
@@ -548,7 +799,7 @@ void World::SolveTOI(const TimeStep& step)
 					// Are there contact points?
 					if (contact->IsTouching() == false)
 					{
-						other->m_sweep = backup;
+						other->SweepRef() = backup;
 						other->SynchronizeTransform();
 						continue;
 					}
@@ -605,6 +856,8 @@ void World::SolveTOI(const TimeStep& step)
 			}
 		}
 
+		m_contactManager.m_broadPhase.ApplyMoves();
+
 		// Commit fixture proxy movements to the broad-phase so that new contacts are created.
 		// Also, some contacts can be destroyed.
 		m_contactManager.FindNewContacts();
@@ -612,15 +865,51 @@ void World::SolveTOI(const TimeStep& step)
 		if (m_subStepping)
 		{
 			m_stepComplete = false;
-			break;
+			return;
+		}
+
+		// Queue the new TOIs of the displaced bodies, including their new contacts.
+		for (int i = 0; i < island.m_bodyCount; ++i)
+		{
+			Body* body = island.m_bodies[i];
+			if (body->m_type != dynamicBody)
+			{
+				continue;
+			}
+
+			for (b2ContactEdge* ce : body->m_contactList)
+			{
+				// Already queued from the other body.
+				if (ce->contact->m_flags & Contact::e_toiFlag)
+				{
+					continue;
+				}
+
+				QueueTOI(ce->contact);
+			}
 		}
 	}
+
+	// No more TOI events. Done!
+	m_stepComplete = true;
 }
 
 void World::Step(float dt, int velocityIterations, int positionIterations)
 {
 	Timer stepTimer;
 
+	// Events, proxy move counters and timings only live for one step. The contacts
+	// destroyed since the last step end first.
+	m_profile = {};
+	ContactEvents& events = m_contactManager.m_contactEvents;
+	events.Clear();
+	events.endEvents.swap(m_contactManager.m_pendingEndEvents);
+	m_contactManager.m_stepping = true;
+	m_contactManager.m_broadPhase.ResetMoveStats();
+
+	// Step boundary, swap in a finished tree rebuild or start one.
+	m_contactManager.m_broadPhase.UpdateTreeQuality();
+
 	// If new fixtures were added, we need to find the new contacts.
 	if (m_newContacts)
 	{
@@ -651,6 +940,7 @@ void World::Step(float dt, int velocityIterations, int positionIterations)
 	{
 		Timer timer;
 		m_contactManager.Collide();
+		m_profile.collide = timer.GetMilliseconds();
 	}
 
 	// Integrate velocities, solve velocity constraints, and integrate positions.
@@ -658,6 +948,7 @@ void World::Step(float dt, int velocityIterations, int positionIterations)
 	{
 		Timer timer;
 		Solve(step);
+		m_profile.solve = timer.GetMilliseconds();
 	}
 
 	// Handle TOI events.
@@ -665,6 +956,7 @@ void World::Step(float dt, int velocityIterations, int positionIterations)
 	{
 		Timer timer;
 		SolveTOI(step);
+		m_profile.solveTOI = timer.GetMilliseconds();
 	}
 
 	if (step.dt > 0.0f)
@@ -677,16 +969,43 @@ void World::Step(float dt, int velocityIterations, int positionIterations)
 		ClearForces();
 	}
 
+	ExportTransforms();
+
 	m_locked = false;
+	m_contactManager.m_stepping = false;
+
+	m_profile.step = stepTimer.GetMilliseconds();
 }
 
-void World::ClearForces()
+void World::ExportTransforms()
 {
-	for (Body* body : m_bodyList)
+	m_movedTransforms.Clear();
+
+	// Only the bodies that moved, resting and sleeping ones are not visited.
+	for (Body* b : m_bodyStates.moved)
 	{
-		body->m_force.SetZero();
-		body->m_torque = 0.0f;
+		// Destroyed after it moved.
+		if (b == nullptr)
+		{
+			continue;
+		}
+		b->m_flags &= ~Body::e_movedFlag;
+
+		// Nobody to sync with.
+		if (b->m_userData == 0)
+		{
+			continue;
+		}
+
+		m_movedTransforms.Push(b->m_userData, b->XfRef());
 	}
+	m_bodyStates.moved.clear();
+}
+
+void World::ClearForces()
+{
+	// Straight pass over the dense force arrays.
+	m_bodyStates.ClearForces();
 }
 
 struct b2WorldRayCastWrapper
@@ -794,6 +1113,49 @@ void World::RayCast(RayCastCallback* callback, const Vec2& point1, const Vec2& p
 //	}
 //}
 
+void World::SetLayerCollision(int layerA, int layerB, bool flag)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	if (ShouldLayersCollide(layerA, layerB) == flag)
+	{
+		return;
+	}
+
+	m_contactManager.m_broadPhase.SetLayerCollision(layerA, layerB, flag);
+
+	if (flag == false)
+	{
+		// Drop the contacts between layers that stopped colliding.
+		for (Contact* c : m_contactManager.m_contactList)
+		{
+			c->FlagForFiltering();
+		}
+		return;
+	}
+
+	// Pairs between these layers were never created, touch the proxies to find them.
+	for (Body* b : m_bodyList)
+	{
+		for (Fixture* f : b->m_fixtureList)
+		{
+			if (f->m_filter.layer != layerA && f->m_filter.layer != layerB)
+			{
+				continue;
+			}
+
+			for (int i = 0; i < f->m_proxyCount; ++i)
+			{
+				m_contactManager.m_broadPhase.TouchProxy(f->m_proxies[i].proxyId);
+			}
+		}
+	}
+}
+
 int World::GetProxyCount() const
 {
 	return m_contactManager.m_broadPhase.GetProxyCount();
@@ -814,6 +1176,21 @@ float World::GetTreeQuality() const
 	return m_contactManager.m_broadPhase.GetTreeQuality();
 }
 
+void World::SetTreeRebuildFactor(float factor)
+{
+	m_contactManager.m_broadPhase.SetTreeRebuildFactor(factor);
+}
+
+int World::GetTreeRebuildCount() const
+{
+	return m_contactManager.m_broadPhase.GetTreeRebuildCount();
+}
+
+const ProxyMoveStats& World::GetProxyMoveStats() const
+{
+	return m_contactManager.m_broadPhase.GetMoveStats();
+}
+
 void World::ShiftOrigin(const Vec2& newOrigin)
 {
 	b2Assert(m_locked == false);
@@ -824,9 +1201,9 @@ void World::ShiftOrigin(const Vec2& newOrigin)
 
 	for (Body* b : m_bodyList)
 	{
-		b->m_xf.p -= newOrigin;
-		b->m_sweep.c0 -= newOrigin;
-		b->m_sweep.c -= newOrigin;
+		b->XfRef().p -= newOrigin;
+		b->SweepRef().c0 -= newOrigin;
+		b->SweepRef().c -= newOrigin;
 	}
 
 	m_contactManager.m_broadPhase.ShiftOrigin(newOrigin);
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "BodyStates.h"
 #include "ContactManager.h"
+#include "ShapeCache.h"
+#include "TransformBuffer.h"
+#include "WorldArena.h"
 #include "WorldCallbacks.h"
 #include "../common/Math.h"
+#include "../common/TimeStep.h"
 
-struct TimeStep;
 class ContactManager;
 struct AABB;
 struct BodyDef;
@@ -30,6 +35,18 @@ public:
 	/// Destruct the world. All physics entities are destroyed and all heap memory is released.
 	~World();
 
+	/// Copy the world, to simulate a what-if without touching this one. The clone is
+	/// independent: stepping it or destroying its bodies does not affect this world.
+	/// Every body, fixture, proxy and contact is copied, static ones included.
+	/// Bodies and fixtures are relocated in a single allocation and the
+	/// broad-phase tree is copied as is. Only the shapes of static fixtures are
+	/// shared between the worlds, they are freed with their last fixture.
+	/// The contact filter is kept, the listeners are not. Body user data is kept,
+	/// so clone bodies can be matched with the bodies of this world.
+	/// @warning This function is locked during callbacks.
+	/// @return the clone, or nullptr if the world is locked.
+	std::unique_ptr<World> Clone();
+
 	/// Register a destruction listener. The listener is owned by you and must
 	/// remain in scope.
 	void SetDestructionListener(DestructionListener* listener);
@@ -40,7 +57,8 @@ public:
 	void SetContactFilter(ContactFilter* filter);
 
 	/// Register a contact event listener. The listener is owned by you and must
-	/// remain in scope.
+	/// remain in scope. Prefer GetContactEvents, the listener is called from
+	/// inside the solver.
 	void SetContactListener(ContactListener* listener);
 
 	/// Create a rigid body given a definition. No reference to the definition
@@ -100,6 +118,18 @@ public:
 	std::vector<Contact*> GetContactList();
 	const std::vector<Contact*> GetContactList() const;
 
+	/// Get the contact events of the last time step, including the end events of the
+	/// contacts destroyed before it. Only contacts where one of the fixtures has
+	/// contact events enabled are reported.
+	/// @warning the events are cleared by the next call to Step.
+	const ContactEvents& GetContactEvents() const;
+
+	/// Get the transforms of the bodies that moved during the last time step, or
+	/// through Body::SetTransform before it, in the order they first moved. Only
+	/// bodies with user data are exported.
+	/// @warning the buffer is refilled by the next call to Step.
+	const TransformBuffer& GetMovedTransforms() const;
+
 	/// Enable/disable sleep.
 	void SetAllowSleeping(bool flag);
 	bool GetAllowSleeping() const { return m_allowSleep; }
@@ -116,6 +146,28 @@ public:
 	void SetSubStepping(bool flag) { m_subStepping = flag; }
 	bool GetSubStepping() const { return m_subStepping; }
 
+	/// Set the maximum number of TOI events solved per time step, 0 for no limit.
+	/// Events past the budget are dropped, the bodies may tunnel.
+	/// Only bullets and fast bodies get continuous collision.
+	void SetTOIBudget(int maxEvents) { m_toiBudget = maxEvents; }
+	int GetTOIBudget() const { return m_toiBudget; }
+
+	/// Get the continuous collision counters of the last time step.
+	const TOIStats& GetTOIStats() const { return m_toiStats; }
+
+	/// Get the phase timings of the last time step.
+	const Profile& GetProfile() const { return m_profile; }
+
+	/// Enable/disable collision between two layers. The layer matrix is symmetric
+	/// and every layer collides with every layer by default. Incompatible proxies
+	/// are rejected by the broad-phase tree query so they never form pairs.
+	/// Existing contacts are filtered on the next time step.
+	/// @see Filter::layer
+	void SetLayerCollision(int layerA, int layerB, bool flag);
+
+	/// Do these two layers collide?
+	bool ShouldLayersCollide(int layerA, int layerB) const;
+
 	/// Get the number of broad-phase proxies.
 	int GetProxyCount() const;
 
@@ -125,6 +177,10 @@ public:
 	/// Get the number of contacts (each may have 0 or more contact points).
 	int GetContactCount() const;
 
+	/// Get the number of distinct shapes shared between fixtures.
+	/// @see FixtureDef::shareShape
+	int GetSharedShapeCount() const { return m_shapeCache.GetCount(); }
+
 	/// Get the height of the dynamic tree.
 	int GetTreeHeight() const;
 
@@ -135,6 +191,16 @@ public:
 	/// The minimum is 1.
 	float GetTreeQuality() const;
 
+	/// Set the tree quality degradation that triggers a background rebuild of the
+	/// dynamic tree, as a factor of the best area ratio seen. Zero disables it.
+	void SetTreeRebuildFactor(float factor);
+
+	/// Get the number of background rebuilds of the dynamic tree.
+	int GetTreeRebuildCount() const;
+
+	/// Get the broad-phase proxy move counters of the last time step.
+	const ProxyMoveStats& GetProxyMoveStats() const;
+
 	/// Change the global gravity vector.
 	void SetGravity(const Vec2& gravity);
 
@@ -170,11 +236,20 @@ private:
 
 	void Solve(const TimeStep& step);
 	void SolveTOI(const TimeStep& step);
+	void QueueTOI(Contact* c);
+	void ExportTransforms();
+
 
+	// Storage of the bodies and fixtures of a clone, released after them.
+	std::unique_ptr<WorldArena> m_arena;
 
 	ContactManager m_contactManager;
+	ShapeCache m_shapeCache;
 
 	std::vector<Body*> m_bodyList;
+	BodyStates m_bodyStates;
+
+	TransformBuffer m_movedTransforms;
 
 	int m_bodyCount;
 
@@ -197,6 +272,22 @@ private:
 	bool m_subStepping;
 
 	bool m_stepComplete;
+
+	// A TOI candidate, ordered on the time of impact.
+	struct TOIEvent
+	{
+		float alpha;
+		Contact* contact;
+
+		bool operator>(const TOIEvent& other) const { return alpha > other.alpha; }
+	};
+
+	// Min-heap of the pending TOI events. Entries go stale when their contact
+	// is invalidated, they are dropped when popped.
+	std::vector<TOIEvent> m_toiQueue;
+	int m_toiBudget;
+	TOIStats m_toiStats;
+	Profile m_profile;
 };
 
 inline std::vector<Body*> World::GetBodyList()
@@ -219,6 +310,21 @@ inline const std::vector<Contact*> World::GetContactList() const
 	return m_contactManager.m_contactList;
 }
 
+inline const ContactEvents& World::GetContactEvents() const
+{
+	return m_contactManager.m_contactEvents;
+}
+
+inline const TransformBuffer& World::GetMovedTransforms() const
+{
+	return m_movedTransforms;
+}
+
+inline bool World::ShouldLayersCollide(int layerA, int layerB) const
+{
+	return ((m_contactManager.m_broadPhase.GetLayerMask(layerA) >> layerB) & 1) != 0;
+}
+
 inline int World::GetBodyCount() const
 {
 	return m_bodyCount;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "../common/Common.h"
+
+/// A single block of memory holding the bodies and fixtures of a cloned
+/// world, so a clone costs one allocation instead of one per object. Objects are
+/// constructed in place and never freed one by one, the block is released with the world.
+class WorldArena
+{
+public:
+	/// Upper bound of the bytes taken by count objects of type T.
+	template <typename T>
+	static size_t GetSize(size_t count)
+	{
+		return count * (sizeof(T) + alignof(T));
+	}
+
+	explicit WorldArena(size_t size)
+		: m_memory(new unsigned char[size]), m_size(size), m_offset(0)
+	{
+	}
+
+	/// Construct an object in the block. The block must have been sized for it.
+	template <typename T, typename... Args>
+	T* Construct(Args&&... args)
+	{
+		size_t offset = (m_offset + alignof(T) - 1) & ~(alignof(T) - 1);
+		b2Assert(offset + sizeof(T) <= m_size);
+		m_offset = offset + sizeof(T);
+		return new (m_memory.get() + offset) T(std::forward<Args>(args)...);
+	}
+
+private:
+	WorldArena(const WorldArena&) = delete;
+	void operator=(const WorldArena&) = delete;
+
+	std::unique_ptr<unsigned char[]> m_memory;
+	size_t m_size;
+	size_t m_offset;
+};
@@ -0,0 +1,85 @@
+#include "MatchRecord.h"
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+bool LoadMatches(const std::string& path, std::vector<MatchRecord>& matches)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cerr << "Cannot open " << path << std::endl;
+		return false;
+	}
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		++lineNumber;
+		std::istringstream stream(line);
+		std::string keyword;
+		if (!(stream >> keyword) || keyword[0] == '#')
+		{
+			continue;
+		}
+
+		if (keyword == "match")
+		{
+			MatchRecord match;
+			if (!(stream >> match.seed))
+			{
+				std::cerr << path << ":" << lineNumber << ": expected a seed" << std::endl;
+				return false;
+			}
+			matches.push_back(match);
+		}
+		else if (keyword == "shot" && !matches.empty())
+		{
+			ShotRecord shot;
+			if (!(stream >> shot.player >> shot.angle >> shot.power >> shot.windAngle >> shot.windForce)
+				|| shot.player < 0 || shot.player > 1)
+			{
+				std::cerr << path << ":" << lineNumber << ": expected player angle power windAngle windForce" << std::endl;
+				return false;
+			}
+			matches.back().shots.push_back(shot);
+		}
+		else
+		{
+			std::cerr << path << ":" << lineNumber << ": unexpected " << keyword << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::vector<MatchRecord> GenerateMatches(int count, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> angle(-80.f, -10.f);
+	std::uniform_real_distribution<float> power(20.f, 100.f);
+	std::uniform_real_distribution<float> windAngle(-180.f, 0.f);
+
+	std::vector<MatchRecord> matches(count);
+	for (MatchRecord& match : matches)
+	{
+		match.seed = rng();
+		for (int i = 0; i < 6; ++i)
+		{
+			ShotRecord shot;
+			shot.player = i % 2;
+			// The second player stands on the right and shoots to the left.
+			shot.angle = shot.player == 0 ? angle(rng) : -180.f - angle(rng);
+			shot.power = power(rng);
+			shot.windAngle = windAngle(rng);
+			shot.windForce = 60.f;
+			match.shots.push_back(shot);
+		}
+	}
+
+	return matches;
+}
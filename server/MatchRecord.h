@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// One shot of a recorded match, with the wind of the turn it was fired in.
+struct ShotRecord
+{
+	int player;
+	float angle;
+	float power;
+	float windAngle;
+	float windForce;
+};
+
+// A recorded match: the terrain seed and the shots in the order they were fired.
+struct MatchRecord
+{
+	unsigned seed = 0;
+	std::vector<ShotRecord> shots;
+};
+
+// Read the matches of a text file, one "match <seed>" line per match followed by
+// its "shot <player> <angle> <power> <windAngle> <windForce>" lines. Lines starting
+// with # are comments. Returns false if the file cannot be read or is malformed.
+bool LoadMatches(const std::string& path, std::vector<MatchRecord>& matches);
+
+// Random matches for when there is no recording at hand.
+std::vector<MatchRecord> GenerateMatches(int count, unsigned seed);
@@ -0,0 +1,70 @@
+#include "MatchSimulation.h"
+
+#include "engine/utils/Math/Common.h"
+#include "physicsEngine/dynamics/World.h"
+
+constexpr float time_step = 1.f / 60.f;
+constexpr int velocity_iterations = 6;
+constexpr int position_iterations = 2;
+
+// A shot that never lands is given up after this many steps.
+constexpr int max_shot_steps = 1800;
+
+MatchSimulation::MatchSimulation(const MatchRecord& match) : m_match(match), m_windAngle(0.f), m_windForce(0.f)
+{
+	m_world = std::make_unique<World>(Vec2(0.f, level_gravity));
+	m_level = CreateLevelBodies(m_world.get(), match.seed);
+	m_bulletPool.reserve(m_world.get(), reserved_shells, reserved_fragments);
+}
+
+MatchSimulation::~MatchSimulation() = default;
+
+MatchResult MatchSimulation::Run()
+{
+	for (const ShotRecord& shot : m_match.shots)
+	{
+		Shoot(shot);
+
+		for (int i = 0; i < max_shot_steps && m_bullets.size() > 0; ++i)
+		{
+			Step();
+		}
+
+		// Leftover bullets do not carry over to the next turn.
+		ReleaseBullets(m_bullets, m_bulletPool);
+
+		if (m_result.health[0] <= 0.f || m_result.health[1] <= 0.f)
+		{
+			m_result.winner = m_result.health[0] <= 0.f ? 1 : 0;
+			break;
+		}
+	}
+
+	return m_result;
+}
+
+void MatchSimulation::Shoot(const ShotRecord& shot)
+{
+	m_windAngle = shot.windAngle;
+	m_windForce = shot.windForce;
+
+	const RectEntity& shooter = *m_level.characters[shot.player];
+	FireShell(m_bullets, m_bulletPool, m_world.get(), shooter.rb, shooter.size.x, shot.player, shot.angle, shot.power);
+}
+
+// Same bullet systems as GameScene::update, the damage goes to the recorded health.
+void MatchSimulation::Step()
+{
+	m_world->Step(time_step, velocity_iterations, position_iterations);
+	++m_result.stepCount;
+
+	BulletContext context = { m_world.get(), &m_bulletPool, { m_level.characters[0]->rb, m_level.characters[1]->rb }, m_windAngle, m_windForce };
+	float damage[2] = {};
+	UpdateBullets(m_bullets, context, damage);
+	m_bullets.flush();
+
+	for (int i = 0; i < 2; ++i)
+	{
+		m_result.health[i] = Clamp(m_result.health[i] - damage[i], 0.f, 100.f);
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "MatchRecord.h"
+#include "game/Systems/BulletSystems.h"
+#include "game/Utils/Level.h"
+
+class World;
+
+struct MatchResult
+{
+	// Index of the winning player, -1 if both are still standing after the last shot.
+	int winner = -1;
+	float health[2] = { 100.f, 100.f };
+	int stepCount = 0;
+};
+
+// Headless counterpart of GameScene: same level, same bullets and damage rules,
+// driven by a recorded match instead of the keyboard. Each simulation owns its
+// world so any number of them can run on different threads.
+class MatchSimulation
+{
+public:
+	explicit MatchSimulation(const MatchRecord& match);
+	~MatchSimulation();
+
+	MatchResult Run();
+
+private:
+	void Shoot(const ShotRecord& shot);
+	void Step();
+
+	const MatchRecord& m_match;
+	std::unique_ptr<World> m_world;
+	LevelBodies m_level;
+	BulletArchetype m_bullets;
+	BulletPool m_bulletPool;
+	float m_windAngle;
+	float m_windForce;
+	MatchResult m_result;
+};
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MatchRecord.h"
+#include "MatchSimulation.h"
+
+// Usage: ballistic-server [matches.txt] [-j threads]
+// server/matches.txt holds a few recorded matches that play to the end.
+// Without a file, simulates randomly generated matches.
+int main(int argc, char** argv)
+{
+	std::string path;
+	int threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "-j" && i + 1 < argc)
+		{
+			threadCount = std::max(1, std::atoi(argv[++i]));
+		}
+		else
+		{
+			path = arg;
+		}
+	}
+
+	std::vector<MatchRecord> matches;
+	if (path.empty())
+	{
+		matches = GenerateMatches(64, 42);
+		std::cout << "No recording given, simulating " << matches.size() << " generated matches" << std::endl;
+	}
+	else if (!LoadMatches(path, matches))
+	{
+		return 1;
+	}
+
+	// Each worker takes the next match, simulates it in its own world and moves on.
+	std::vector<MatchResult> results(matches.size());
+	std::atomic<size_t> nextMatch = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> workers;
+	for (int i = 0; i < threadCount; ++i)
+	{
+		workers.emplace_back([&]()
+		{
+			for (size_t index = nextMatch++; index < matches.size(); index = nextMatch++)
+			{
+				MatchSimulation simulation(matches[index]);
+				results[index] = simulation.Run();
+			}
+		});
+	}
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	long long stepCount = 0;
+	int wins[3] = { 0, 0, 0 };
+	for (const MatchResult& result : results)
+	{
+		stepCount += result.stepCount;
+		++wins[result.winner + 1];
+	}
+
+	std::cout << matches.size() << " matches on " << threadCount << " threads in " << elapsed.count() << " s" << std::endl;
+	std::cout << matches.size() / elapsed.count() << " matches/s, " << stepCount / elapsed.count() << " steps/s" << std::endl;
+	std::cout << "Player 1 wins " << wins[1] << ", player 2 wins " << wins[2] << ", unfinished " << wins[0] << std::endl;
+
+	return 0;
+}